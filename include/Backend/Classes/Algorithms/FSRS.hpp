@@ -0,0 +1,125 @@
+#ifndef FSRS_HPP
+#define FSRS_HPP
+
+#include <array>
+#include <cmath>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <QString>
+
+#include "Backend/Classes/Base/Algorithm.hpp"
+
+// Free Spaced Repetition Scheduler (FSRS-4.5 memory model)
+// Every card keeps a stability (days until recall drops to 90%) and a difficulty (1 to 10).
+// An answer updates both from the time since the previous one, the next interval is the time
+// until recall drops to DESIRED_RETENTION. The 17 weights are fitted per user by FSRSOptimizer.
+class FSRSAlgorithm final : public Algorithm {
+public:
+    static constexpr AlgorithmID ID = AlgorithmID::FSRS;
+    static constexpr unsigned CHANGES = StateField::Interval | StateField::Repetitions |
+                                        StateField::Stability | StateField::Difficulty;
+
+    static constexpr int WEIGHT_COUNT = 17;
+    using Weights = std::array<double, WEIGHT_COUNT>;
+    // Published FSRS-4.5 defaults, used until the user's own are fitted
+    static constexpr Weights DEFAULT_WEIGHTS = {
+        0.4872, 1.4003, 3.7145, 13.8206, 5.1618, 1.2298, 0.8975, 0.031, 1.6474,
+        0.1367, 1.0461, 2.1072, 0.0793, 0.3246, 1.587, 0.2272, 2.8755
+    };
+
+    static constexpr double DESIRED_RETENTION = 0.9;
+    static constexpr double DECAY = -0.5;
+    static constexpr double FACTOR = 19.0 / 81.0; // Retrievability is 0.9 after stability days
+    static constexpr double MIN_STABILITY = 0.01;
+
+    template <typename T>
+    struct Memory {
+        T stability;
+        T difficulty;
+    };
+
+    // Weights fitted for the user of each card, the defaults when there are none
+    FSRSAlgorithm() = default;
+    // Same weights for every card, for simulations
+    explicit FSRSAlgorithm(const Weights& weights);
+
+    void calculateInterval(CardState& state, int buttonPressed, const AnswerContext& context) override;
+    // Same results as calculateInterval() for every card, buttons[i] answers card i
+    // Time since the previous answer comes from elapsed_days, the weights given or the defaults are used
+    void calculateBatch(StateBatch& batch, std::span<const quint8> buttons) const;
+
+    // The model is written once for double (scheduling) and for the optimizer's dual numbers,
+    // which carry the gradient with respect to the weights along
+
+    // Chance to recall after elapsedDays
+    template <typename T>
+    static T retrievability(const double elapsedDays, const T& stability) {
+        using std::exp, std::log;
+        return exp(DECAY * log(1.0 + FACTOR * elapsedDays / stability));
+    }
+
+    // Memory after the first answer
+    template <typename T, typename W>
+    static Memory<T> first(const W& w, const int button) {
+        return { atLeast(T(w[button - 1]), MIN_STABILITY), clamp(T(w[4] - static_cast<double>(button - 3) * w[5]), 1.0, 10.0) };
+    }
+
+    // Memory after answering elapsedDays after the previous answer
+    template <typename T, typename W>
+    static Memory<T> next(const W& w, const Memory<T>& memory, const double elapsedDays, const int button) {
+        using std::exp, std::log;
+        const T& s = memory.stability;
+        const T& d = memory.difficulty;
+        const T r = retrievability(elapsedDays, s);
+
+        T stability;
+        if (button == 1) {
+            // Forgotten, FSRS-4.5 does not cap this at the previous stability (FSRS-5 does)
+            stability = w[11] * exp(-w[12] * log(d)) * (exp(w[13] * log(s + 1.0)) - 1.0) * exp((1.0 - r) * w[14]);
+        } else {
+            const T penalty = button == 2 ? T(w[15]) : T(1.0);
+            const T bonus = button == 4 ? T(w[16]) : T(1.0);
+            stability = s * (1.0 + exp(w[8]) * (11.0 - d) * exp(-w[9] * log(s)) * (exp((1.0 - r) * w[10]) - 1.0) * penalty * bonus);
+        }
+
+        // Difficulty moves with the answer and reverts a little towards the one of a first Good, D0(3) = w[4]
+        const T moved = d - static_cast<double>(button - 3) * w[6];
+        const T difficulty = w[7] * w[4] + (1.0 - w[7]) * moved;
+
+        return { atLeast(stability, MIN_STABILITY), clamp(difficulty, 1.0, 10.0) };
+    }
+
+    // Days until recall drops to DESIRED_RETENTION, at least one
+    static int intervalFor(double stability);
+
+    // Weights of the user, the defaults until the optimizer has run
+    static Weights weightsFor(const QString& userID);
+    static bool saveWeights(const QString& userID, const Weights& weights, int reviews, double logLoss);
+
+    static QString toText(const Weights& weights);
+    static std::optional<Weights> fromText(const QString& text);
+
+private:
+    std::optional<Weights> weights;
+
+    static std::mutex mutex;
+    static std::unordered_map<QString, Weights> fitted; // Read once per user
+
+    template <typename T>
+    static T atLeast(const T& value, const double minimum) {
+        return value < minimum ? T(minimum) : value;
+    }
+
+    template <typename T>
+    static T clamp(const T& value, const double minimum, const double maximum) {
+        return value < minimum ? T(minimum) : value > maximum ? T(maximum) : value;
+    }
+
+    // Applies one answer to the memory, the interval and the repetitions of a card
+    static void review(const Weights& w, float& stability, float& difficulty, int& interval, int& repetitions,
+                       double elapsedDays, int button);
+};
+
+#endif
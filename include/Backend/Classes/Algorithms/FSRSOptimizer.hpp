@@ -0,0 +1,72 @@
+#ifndef FSRSOPTIMIZER_HPP
+#define FSRSOPTIMIZER_HPP
+
+#include <optional>
+#include <vector>
+
+#include <QString>
+
+#include "Backend/Classes/Algorithms/FSRS.hpp"
+
+class QSqlQuery;
+class WorkerPool;
+
+// Fits the FSRS weights of a user to their review log
+// Every answer given at least a day after the previous one of its card is a prediction the
+// model can get wrong: the weights are moved to minimize the log loss of those predictions
+// with Adam over mini-batches of cards. The gradient of a mini-batch is summed over chunks of
+// cards on every core, the chunks are claimed from a shared cursor (see WorkerPool) because
+// card histories differ a lot in length. Chunk results are added up in chunk order, so the
+// fitted weights are the same whatever the number of threads.
+class FSRSOptimizer {
+public:
+    static constexpr int EPOCHS = 5;
+    static constexpr double LEARNING_RATE = 0.04;
+    static constexpr size_t MIN_BATCH_REVIEWS = 512;   // Answers per gradient step
+    static constexpr size_t MAX_BATCH_REVIEWS = 16384;
+    static constexpr size_t CARDS_PER_CHUNK = 32;
+    static constexpr int MIN_REVIEWS = 1000;           // Fewer predictions keep the current weights
+
+    // Answers of every card in answer order, one card after another
+    struct History {
+        std::vector<quint32> offsets = { 0 }; // Answers of card i are [offsets[i], offsets[i + 1])
+        std::vector<float> elapsed_days;      // Since the previous answer of the card, 0 for the first
+        std::vector<quint8> buttons;
+
+        size_t cards() const { return offsets.size() - 1; }
+        size_t reviews() const { return buttons.size(); }
+
+        // Answers must come grouped by card, in answer order
+        void add(qint64 cardID, qint64 reviewedAtMs, int button);
+
+    private:
+        qint64 lastCard = -1;
+        qint64 lastTime = 0;
+    };
+
+    struct Result {
+        FSRSAlgorithm::Weights weights{};
+        double log_loss_before = 0; // Of the default weights
+        double log_loss_after = 0;
+        int reviews = 0;            // Predictions the loss is measured on
+        qint64 elapsed_ms = 0;
+        bool saved = false;         // Set by optimize() when the weights replaced the current ones
+    };
+
+    // One pass over the rows of SELECT_REVIEW_HISTORY
+    static History read(QSqlQuery& rows);
+    // 0 threads uses one per core
+    static Result fit(const History& history, int threads = 0);
+    // Mean log loss of the weights over the history, 0 when it has no prediction
+    static double logLoss(const History& history, const FSRSAlgorithm::Weights& weights, int threads = 0);
+
+    // Reads the user's log, fits and saves the weights when they predict it better than the
+    // current ones. Blocks for seconds on large collections, call it off the GUI thread.
+    // Nothing when the log could not be read or is too short.
+    static std::optional<Result> optimize(const QString& userID);
+
+private:
+    static double logLoss(const History& history, const FSRSAlgorithm::Weights& weights, WorkerPool& pool, int& predictions);
+};
+
+#endif
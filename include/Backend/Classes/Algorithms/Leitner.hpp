@@ -6,11 +6,15 @@
 #define LEITNER_HPP
 
 #include "Backend/Classes/Base/Algorithm.hpp"
-#include "Backend/Classes/Stats/CardStats.hpp"
 
 class LeitnerAlgorithm final : public Algorithm {
 public:
-    void calculateInterval(CardStats& stats, int buttonPressed) override;
+    static constexpr AlgorithmID ID = AlgorithmID::Leitner;
+    static constexpr unsigned CHANGES = StateField::Interval;
+
+    void calculateInterval(CardState& state, int buttonPressed, const AnswerContext& context) override;
+    // Same results as calculateInterval() for every card, buttons[i] answers card i
+    static void calculateBatch(StateBatch& batch, std::span<const quint8> buttons);
 
 };
 
@@ -0,0 +1,35 @@
+#ifndef REGISTRY_HPP
+#define REGISTRY_HPP
+
+#include <optional>
+#include <variant>
+
+#include <QString>
+
+#include "Backend/Classes/Base/Algorithm.hpp"
+#include "Backend/Classes/Algorithms/SM2.hpp"
+#include "Backend/Classes/Algorithms/Leitner.hpp"
+#include "Backend/Classes/Algorithms/FSRS.hpp"
+
+// Every scheduling algorithm, in AlgorithmID order
+// Names are parsed once when the deck settings are loaded, an answer dispatches on the ID
+// through the variant, so the final calculateInterval() is called directly.
+namespace Algorithms {
+    using Any = std::variant<SM2Algorithm, LeitnerAlgorithm, FSRSAlgorithm>;
+    inline constexpr size_t COUNT = std::variant_size_v<Any>;
+
+    // Case-insensitive, nothing for unknown names
+    std::optional<AlgorithmID> fromName(const QString& name);
+    // Name stored in DeckSettings
+    QString name(AlgorithmID id);
+
+    const Any& get(AlgorithmID id);
+    // State fields the algorithm may change (StateField mask)
+    unsigned changes(AlgorithmID id);
+
+    void calculateInterval(AlgorithmID id, CardState& state, int buttonPressed, const AnswerContext& context = {});
+    // Same results as calculateInterval() card by card, buttons[i] answers card i
+    void calculateBatch(AlgorithmID id, StateBatch& batch, std::span<const quint8> buttons);
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef ANSWERTIMES_HPP
+#define ANSWERTIMES_HPP
+
+#include <array>
+#include <bit>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <QByteArray>
+#include <QString>
+
+// How long answers take (ms), per deck and for the whole user, for the answer time percentiles
+// Kept in HDR-style histograms: exact below 128 ms, then 64 buckets per power of two, so any
+// percentile is within 1/64 of the measured time at a few kilobytes per deck.
+// Read from AnswerTimes the first time it is asked for, answers are added in memory as they
+// are submitted and the decks they touched are written back by save().
+class AnswerTimes {
+public:
+    class Histogram {
+    public:
+        static constexpr int SUB_BUCKETS = 64;
+        static constexpr qint64 MAX_MS = 60 * 60 * 1000; // Longer answers count as an hour
+        static constexpr int BUCKETS = 2 * SUB_BUCKETS + (std::bit_width(static_cast<quint64>(MAX_MS)) - 7) * SUB_BUCKETS;
+
+        void record(qint64 milliseconds, quint64 count = 1);
+        void add(const Histogram& other);
+
+        quint64 total() const { return answers; }
+        bool isEmpty() const { return answers == 0; }
+        // Time at or below which the given share of answers (0 to 1) fall, 0 when empty
+        qint64 percentile(double share) const;
+
+        // Non-empty buckets as varint gap and count pairs
+        QByteArray encode() const;
+        // Empty when the data is not a histogram
+        static std::optional<Histogram> decode(const QByteArray& data);
+
+        static int indexOf(qint64 milliseconds);
+        // Lowest time counted in the bucket and how many milliseconds it spans
+        static qint64 lowestOf(int index);
+        static qint64 widthOf(int index);
+
+    private:
+        static constexpr char FORMAT = 1;
+
+        std::array<quint64, BUCKETS> counts{};
+        quint64 answers = 0;
+    };
+
+    // Empty before the first answer
+    static Histogram forUser(const QString& userID);
+    static Histogram forDeck(const QString& userID, const QString& deckID);
+
+    // Call once the answer is submitted
+    static void cardAnswered(const QString& userID, const QString& deckID, qint64 milliseconds);
+    // Writes the decks answered since the last call
+    static bool save();
+    static void deckDeleted(const QString& deckID);
+    // Read again on the next use, unsaved answers are kept
+    static void invalidate();
+    // Unsaved answers too, for a database that was wiped
+    static void clear();
+
+private:
+    static std::mutex mutex;
+    static QString userID; // Owner of the histograms, empty until loaded
+    static std::unordered_map<QString, Histogram> decks;
+
+    // Answered since the last save, kept apart so a reload does not lose them
+    static QString pendingUserID;
+    static std::unordered_map<QString, Histogram> pending;
+
+    // Mutex held
+    static bool ensureLoaded(const QString& userID);
+    static bool savePending();
+};
+
+#endif
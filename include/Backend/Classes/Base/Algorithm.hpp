@@ -5,12 +5,80 @@
 #ifndef ALGORITHM_HPP
 #define ALGORITHM_HPP
 
-#include "Backend/Classes/Stats/CardStats.hpp"
+#include <algorithm>
+#include <span>
+#include <vector>
+
+#include <QString>
+
+#include "Backend/Classes/Stats/CardState.hpp"
+
+// Batch kernels get an AVX2 clone next to the generic one where the toolchain supports it,
+// the loader picks the one the CPU can run. Elsewhere the generic loop is auto-vectorized.
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+#define MINDLEAP_BATCH_KERNEL __attribute__((target_clones("avx2", "default")))
+#else
+#define MINDLEAP_BATCH_KERNEL
+#endif
+
+// Longest interval any algorithm schedules, in days
+inline constexpr int MAX_INTERVAL = 36500;
+
+// Days to a whole interval, capped while still a double since a product past INT_MAX
+// has no defined int value. Fractions are cut off, nothing below 0 or NaN gives 0.
+constexpr int toInterval(const double days) {
+    return days > 0 ? static_cast<int>(std::min(days, static_cast<double>(MAX_INTERVAL))) : 0;
+}
+
+// Stored in DeckSettings, the database keeps the name (see Algorithms::fromName)
+enum class AlgorithmID : quint8 {
+    SM2,
+    Leitner,
+    FSRS
+};
+
+// Scheduling state an algorithm may change, CHANGES of every algorithm is a mask of these
+struct StateField {
+    enum : unsigned {
+        Interval = 1 << 0,
+        EaseFactor = 1 << 1,
+        Repetitions = 1 << 2,
+        Stability = 1 << 3,
+        Difficulty = 1 << 4
+    };
+};
+
+// Scheduling state of many cards, one contiguous array per field
+// Used for whole-collection work, answers go through CardState one card at a time.
+struct StateBatch {
+    std::vector<int> interval;
+    std::vector<float> ease_factor;
+    std::vector<int> repetitions;
+    std::vector<float> stability;    // FSRS memory state, 0 until its first answer
+    std::vector<float> difficulty;
+    std::vector<float> elapsed_days; // Since the previous answer, read by FSRS only
+
+    size_t size() const { return interval.size(); }
+    void resize(const size_t count) {
+        interval.resize(count, 0);
+        ease_factor.resize(count, 2.5f);
+        repetitions.resize(count, 0);
+        stability.resize(count, 0.0f);
+        difficulty.resize(count, 0.0f);
+        elapsed_days.resize(count, 0.0f);
+    }
+};
+
+// When and for whom an answer is scheduled
+struct AnswerContext {
+    qint64 reviewed_at = 0; // Seconds since epoch, now when 0
+    QString user_id;        // Whose fitted parameters apply, the defaults when empty
+};
 
 class Algorithm {
 public:
-    virtual void calculateInterval(CardStats& card, int buttonPressed) = 0;
+    virtual void calculateInterval(CardState& state, int buttonPressed, const AnswerContext& context) = 0;
     virtual ~Algorithm() = default;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -10,11 +10,12 @@
 #include "Backend/Classes/Card.hpp"
 #include "Backend/Classes/Stats/DeckStats.hpp"
 
+struct ReviewEvent;
+
 class Deck final : public Entity {
 private:
     QString name;
     QString id;
-    std::queue<Card> studyQueue;
 
     DeckStats stats;
 
@@ -28,7 +29,6 @@ public:
     // Getters
     QString getName() const;
     QString getID() const;
-    int getStudyQueueSize() const;
 
     // Database Operations
     // Deck
@@ -49,15 +49,12 @@ public:
 
     std::vector<Card> listCards() const;
     int getCardCount() const; // getCardCount and getCardInformation can be merged with a variable
+    // New, Learning and due Review counts from the deck counters
     std::vector<int> getCardInformation() const;
     QString fetchAlgorithm() const;
 
-    // Studying
-    bool study();
-    bool processCardResponse(Card& card, int buttonPressed);
-    bool endStudy() const;
-
-    Card getNextCard();
+    // Studying (see StudySession)
+    static bool applyCardResponse(const ReviewEvent& event);
 
     // Stats
     void getStats() const override;
@@ -0,0 +1,82 @@
+#ifndef DUEINDEX_HPP
+#define DUEINDEX_HPP
+
+#include <functional>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <QDate>
+#include <QString>
+
+#include "Backend/Classes/Card.hpp"
+
+// Due cards of one deck for the length of a study session
+// Built once when the session starts and updated by every answer, so the New/Learning/Review
+// counters and the daily limits are answered without going back to the database.
+// Review cards that are not due yet wait in a min-heap on their due time and move to the
+// due counter once the clock passes it.
+class DueIndex {
+public:
+    struct Counts {
+        int available_new = 0; // Capped by the remaining daily new card limit
+        int learning = 0;
+        int due_reviews = 0;   // Capped by the remaining daily review limit
+    };
+
+private:
+    struct Entry {
+        CardType type = CardType::New;
+        bool scheduled = false; // Has a CardState row
+        bool waiting = false;   // In the heap, not due yet
+    };
+
+    struct Pending {
+        qint64 due;
+        QString card_id;
+
+        bool operator>(const Pending& other) const { return due > other.due; }
+    };
+
+    std::unordered_map<QString, Entry> cards;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<>> pending;
+
+    int newCount = 0;
+    int learningCount = 0;
+    int dueReviewCount = 0;
+
+    int newLimit = 0;
+    int reviewLimit = 0;
+    int newStudiedToday = 0;
+    int reviewsStudiedToday = 0;
+    QDate day; // See statsToday()
+
+    bool built = false;
+
+    // Move reviews whose due time has passed to the due counter
+    void advance(qint64 now);
+    // The daily counters start over with the day the studied-today counts are read by (UTC)
+    void rollOver();
+
+public:
+    void clear();
+    bool isBuilt() const;
+
+    // Limits from DeckSettings and what was already answered today
+    void setLimits(int newLimit, int reviewLimit, int newStudiedToday, int reviewsStudiedToday);
+    // Due in seconds since epoch, nothing when the card has no CardState row
+    void add(const QString& cardID, CardType type, std::optional<qint64> due, qint64 now);
+    // Mark the index ready once every card of the deck was added
+    void finish();
+
+    // Move an answered card to its new bucket
+    void answered(const QString& cardID, CardType before, CardType after);
+
+    Counts counts(qint64 now);
+    // False once the daily limit of the card's type is reached
+    bool canStudy(CardType type);
+    bool isScheduled(const QString& cardID) const;
+};
+
+#endif
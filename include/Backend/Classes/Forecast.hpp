@@ -0,0 +1,50 @@
+#ifndef FORECAST_HPP
+#define FORECAST_HPP
+
+#include <array>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <QString>
+
+class QSqlQuery;
+
+// Reviews coming due on each of the next DAYS days, per deck and for the whole user
+// Built from CardState in one pass the first time it is read, then kept current by the answer
+// path: every answer moves its card from its old due day to the new one. Overdue cards count for today.
+class Forecast {
+public:
+    static constexpr int DAYS = 365;
+    using Histogram = std::array<int, DAYS>; // Index 0 is today
+
+    struct Snapshot {
+        qint64 day_start = 0; // Local midnight of day 0, seconds since epoch
+        Histogram total{};
+        std::unordered_map<QString, Histogram> decks;
+    };
+
+    // All zero when nothing is scheduled
+    static Histogram forUser(const QString& userID);
+    static Histogram forDeck(const QString& userID, const QString& deckID);
+
+    // Call once the answer is stored, due values in seconds since epoch
+    static void cardAnswered(const QString& userID, const QString& cardID, std::optional<qint64> previousDue, qint64 due);
+    // Rebuilt on the next read
+    static void invalidate();
+
+    // One pass over the rows of SELECT_FORECAST_STATE
+    static Snapshot build(QSqlQuery& rows, qint64 dayStart);
+    // -1 past the last day
+    static int dayIndex(qint64 due, qint64 dayStart);
+
+private:
+    static std::mutex mutex;
+    static QString userID; // Owner of the snapshot, empty until built
+    static Snapshot snapshot;
+
+    // Mutex held
+    static bool ensureBuilt(const QString& userID);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef HEATMAP_HPP
+#define HEATMAP_HPP
+
+#include <mutex>
+#include <vector>
+
+#include <QDate>
+#include <QString>
+
+class QSqlQuery;
+
+// Reviews and time spent on each day the user has studied, for the review calendar
+// One cell per day from the first review to today, indexed by days since 1970-01-01. Days are
+// the UTC days the daily UserStats rows are dated with (see statsToday()), for both sources.
+// Built the first time it is read from UserStats for the days before the review log and one
+// ordered pass over ReviewLog, then kept current by the answer path.
+class Heatmap {
+public:
+    struct Day {
+        quint32 reviews = 0;
+        quint32 duration_ms = 0;
+    };
+
+    struct Snapshot {
+        qint32 first_day = 0; // Epoch day of days[0]
+        std::vector<Day> days;
+
+        // Empty outside the range
+        Day at(qint32 epochDay) const;
+        bool isEmpty() const { return days.empty(); }
+    };
+
+    static qint32 epochDay(const QDate& date);
+    static QDate dateOf(qint32 epochDay);
+    // Day of a time in milliseconds since epoch, same as statsDayOf()
+    static qint32 epochDayOf(qint64 msecs);
+
+    // Empty before the first review
+    static Snapshot forUser(const QString& userID);
+
+    // Call once the answer is submitted, times in milliseconds
+    static void cardAnswered(const QString& userID, qint64 answeredAt, qint64 durationMs);
+    // Rebuilt on the next read
+    static void invalidate();
+
+    // One pass over the rows of SELECT_HEATMAP_EARLIER_DAYS, then one over SELECT_HEATMAP_REVIEWS
+    static Snapshot build(QSqlQuery& earlierDays, QSqlQuery& reviews);
+    // Grows the snapshot up to the day when needed
+    static void add(Snapshot& snapshot, qint32 epochDay, quint32 reviews, qint64 durationMs);
+
+private:
+    static std::mutex mutex;
+    static QString userID; // Owner of the snapshot, empty until built
+    static Snapshot snapshot;
+
+    // Mutex held
+    static bool ensureBuilt(const QString& userID);
+};
+
+#endif
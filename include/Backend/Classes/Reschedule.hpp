@@ -0,0 +1,36 @@
+#ifndef RESCHEDULE_HPP
+#define RESCHEDULE_HPP
+
+#include <functional>
+#include <vector>
+
+#include <QString>
+
+// Bulk rescheduling of the selected user's cards
+// Each operation is a fixed number of set-based statements in one transaction, however many
+// cards it touches. Answers still queued in the committer are saved first, deck counters and
+// the forecast of the affected decks are dropped and rebuilt on their next read.
+// All of them return the number of cards changed, -1 on failure.
+class Reschedule {
+public:
+    // Overdue cards of the deck are due days later than they were
+    static int postponeOverdue(const QString& deckID, int days);
+    // Overdue cards of the deck are spread evenly over the next days, most overdue first
+    static int spreadOverdue(const QString& deckID, int days);
+    // Every card of the deck is New again, its review history is kept
+    static int resetDeck(const QString& deckID);
+    // Same as resetDeck() for the given cards
+    static int forget(const std::vector<QString>& cardIDs);
+
+private:
+    enum class Operation {
+        Postpone,
+        Spread,
+        Forget
+    };
+
+    // select fills the selection inside the transaction
+    static int apply(Operation operation, int days, const std::function<bool()>& select);
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef SIMULATOR_HPP
+#define SIMULATOR_HPP
+
+#include <array>
+#include <optional>
+#include <vector>
+
+#include <QString>
+
+#include "Backend/Classes/Algorithms/Registry.hpp"
+
+// Monte Carlo forecast of the study workload of a deck under a scheduling algorithm
+// Whether a card is recalled is drawn from the FSRS memory model with recall_weights, whatever
+// algorithm schedules it. Every day the due cards (up to the review limit) and the new ones are
+// answered, the algorithm schedules them through its batch API. Runs are independent and spread
+// over every core. Run i always draws from the same random stream, so a report only depends on
+// its inputs and settings, never on the thread count.
+class Simulator {
+public:
+    struct Settings {
+        int days = 365;
+        int runs = 8;                  // Averaged together
+        int new_cards_per_day = 20;
+        int max_reviews_per_day = 0;   // 0 for no limit, the rest waits for the next day
+        double new_seconds = 20;       // Time of an answer
+        double review_seconds = 8;
+        double again_seconds = 15;
+        std::array<double, 4> first_buttons = { 0.25, 0.10, 0.55, 0.10 }; // Again to Easy on a new card
+        std::array<double, 3> recall_buttons = { 0.15, 0.75, 0.10 };      // Hard to Easy when recalled
+        FSRSAlgorithm::Weights recall_weights = FSRSAlgorithm::DEFAULT_WEIGHTS;
+        quint64 seed = 1;
+    };
+
+    // Averages over the runs
+    struct Day {
+        double reviews = 0;   // Answers to cards seen before
+        double new_cards = 0;
+        double minutes = 0;
+        double retention = 0; // Share of reviews recalled, 0 without reviews
+    };
+
+    struct Report {
+        std::vector<Day> days;
+        double total_minutes = 0;
+        double retention = 0;
+        qint64 elapsed_ms = 0;
+    };
+
+    // Cards of a deck as of today
+    struct Collection {
+        StateBatch state;
+        std::vector<int> due_day;  // Days from today, 0 when due or overdue
+        std::vector<int> last_day; // Days from today of the last answer, negative
+        std::vector<quint8> fresh; // Never answered
+
+        size_t size() const { return state.size(); }
+        // A card never answered
+        void addNew();
+        void addScheduled(int interval, float easeFactor, int repetitions, float stability, float difficulty, int lastDay, int dueDay);
+    };
+
+    // State of the deck's cards for the user, nothing on a database error
+    static std::optional<Collection> load(const QString& userID, const QString& deckID);
+    // 0 threads uses one per core
+    static Report run(const Collection& collection, const Algorithms::Any& algorithm, const Settings& settings, int threads = 0);
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef CARDSTATE_HPP
+#define CARDSTATE_HPP
+
+#include <type_traits>
+
+#include <QString>
+
+class QSqlQuery;
+struct ReviewEvent;
+
+// Scheduling state of one card for one user, a row of CardState
+// Plain 32 bytes the algorithms work on and the answer path copies around, nothing on it
+// allocates. Times are unsigned seconds since epoch (good until 2106), a due time past
+// that is kept at the last second.
+struct CardState {
+    quint32 card_id = 0;     // Cards.id
+    quint32 due = 0;
+    quint32 last_seen = 0;   // Time of the last answer, 0 until the first one
+    qint32 interval = 0;     // Days
+    float ease_factor = 2.5f;
+    quint16 repetitions = 0;
+    quint16 lapses = 0;      // Again on a card that had an interval
+    float stability = 0.0f;  // FSRS memory state, 0 until FSRS answered the card
+    float difficulty = 0.0f;
+
+    static quint32 toSeconds(qint64 seconds);
+
+    // State of the card for the user, false on a database error or an unknown card
+    // scheduled is false for a card never answered, its state keeps the defaults
+    static bool load(const QString& userID, const QString& cardID, CardState& state, bool& scheduled);
+    // Appends the answer to the review log and stores the state
+    bool save(const QString& userID, const ReviewEvent& event, int previousInterval) const;
+};
+
+static_assert(std::is_trivially_copyable_v<CardState> && std::is_standard_layout_v<CardState>,
+              "CardState must stay a plain struct");
+static_assert(sizeof(CardState) == 32, "CardState must stay 32 bytes");
+
+#endif
@@ -60,6 +60,8 @@ public:
     void setRepetitions(int repetitions);
 
     // Database Operations
+    // Latest stats row of the card into this object, false when there is none
+    bool loadLatest();
     // Load stats from database
     Stats* load() override;
     Stats* loadTotal() override;
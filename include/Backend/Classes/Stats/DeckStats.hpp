@@ -11,6 +11,7 @@
 
 #include "Backend/Utilities/statsUpdateContext.hpp"
 #include "Backend/Classes/Base/Stats.hpp"
+#include "Backend/Database/rollups.hpp"
 
 class DeckStats final : public Stats {
 private:
@@ -44,6 +45,10 @@ public:
     // Load stats from database
     Stats* load() override;
     Stats* loadTotal() override;
+    // Totals of this week, this month or all time into this object
+    bool loadPeriod(StatsPeriod period);
+    // Totals of every deck of the user
+    static DeckStats totalOfUser(const QString& userID, StatsPeriod period = StatsPeriod::AllTime);
     // Initialize stats to database
     bool initialize() const override;
 
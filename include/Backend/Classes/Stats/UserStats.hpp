@@ -10,6 +10,7 @@
 
 #include "Backend/Utilities/statsUpdateContext.hpp"
 #include "Backend/Classes/Base/Stats.hpp"
+#include "Backend/Database/rollups.hpp"
 
 class UserStats final : public Stats {
 private:
@@ -30,6 +31,7 @@ public:
     UserStats();
 
     // Getters
+    QDate getDate() const;
     int getCardsSeen() const;
     int getPressedAgain() const;
     int getPressedHard() const;
@@ -45,6 +47,8 @@ public:
     // Load stats from database
     Stats* load() override;
     Stats* loadTotal() override;
+    // Totals of this week, this month or all time into this object
+    bool loadPeriod(StatsPeriod period);
     // Initialize stats to database
     bool initialize() const override;
 
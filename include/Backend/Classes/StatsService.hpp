@@ -0,0 +1,107 @@
+#ifndef STATSSERVICE_HPP
+#define STATSSERVICE_HPP
+
+#include <mutex>
+#include <unordered_map>
+
+#include <QDate>
+#include <QString>
+
+#include "Backend/Classes/Stats/DeckStats.hpp"
+#include "Backend/Classes/Stats/UserStats.hpp"
+#include "Backend/Database/counters.hpp"
+
+enum class StatsChange {
+    User,  // User totals or today's numbers
+    Deck,  // Totals of one deck
+    Counts // Card counts of one deck, every deck when the ID is empty
+};
+
+// Told about every change, on the thread that reported it (the GUI thread for every event below)
+class StatsListener {
+public:
+    virtual ~StatsListener() = default;
+    virtual void statsChanged(StatsChange change, const QString& deckID) = 0;
+};
+
+// User totals, deck totals and deck card counts of the selected user, kept in memory
+// Loaded in a few reads the first time they are asked for, then kept current by the events below,
+// so the main window, the stats dialog and the Discord presence share the same numbers.
+// Answers count once submitted, the committer stores them later. Card counts of a changed deck
+// are read again on their next use, once every submitted answer is in the database, and all of
+// them after COUNTS_MAX_AGE since reviews come due with time.
+// A new day (the UTC day the stats rows are kept by) or another user starts over from the database.
+class StatsService {
+public:
+    static constexpr qint64 COUNTS_MAX_AGE = 60; // Seconds
+
+    // All time
+    static UserStats userTotal(const QString& userID);
+    static UserStats userToday(const QString& userID);
+    // All time, every deck of the user when the deck ID is empty
+    static DeckStats deckTotal(const QString& userID, const QString& deckID = QString());
+
+    // Keyed by deck ID
+    static std::unordered_map<QString, DeckCounts> counts(const QString& userID);
+    static DeckCounts counts(const QString& userID, const QString& deckID);
+
+    // Call once the change is saved, answers once submitted
+    static void cardAnswered(const QString& userID, const QString& deckID, int buttonPressed);
+    static void cardAdded(const QString& userID, const QString& deckID);
+    // Cards deleted or rescheduled, the counts of every deck are read again
+    static void cardsChanged();
+    static void deckDeleted(const QString& deckID);
+    static void timeSpent(const QString& userID, const QString& deckID, qint64 seconds);
+    static void appLaunched(const QString& userID);
+    // Loaded again on the next read
+    static void invalidate();
+
+    // At most one, nullptr to remove it
+    static void setListener(StatsListener* listener);
+
+private:
+    struct UserTotals {
+        int cards_seen = 0;
+        int pressed_again = 0;
+        int pressed_hard = 0;
+        int pressed_good = 0;
+        int pressed_easy = 0;
+        int time_spent_seconds = 0;
+        int times_used = 0;
+    };
+
+    struct DeckTotals {
+        int cards_added = 0;
+        int cards_seen = 0;
+        qint64 time_spent_seconds = 0;
+    };
+
+    struct Snapshot {
+        QDate date; // Day of the stats rows (see statsToday()), invalid until loaded
+        UserTotals total;
+        UserTotals today;
+        DeckTotals decks_total; // Every deck of the user
+        std::unordered_map<QString, DeckTotals> decks;
+        std::unordered_map<QString, DeckCounts> counts;
+        bool all_counts = false; // Every deck in counts, not only the ones read one by one
+        qint64 counts_read_at = 0;
+    };
+
+    static std::mutex mutex;
+    static QString userID; // Owner of the snapshot, empty until loaded
+    static Snapshot snapshot;
+    static StatsListener* listener;
+
+    // Mutex held
+    static bool ensureLoaded(const QString& userID);
+    // Mutex held, false when the event belongs to nothing in memory
+    static bool isCurrent(const QString& userID);
+    // Mutex held, drops counts read too long ago
+    static void expireCounts();
+    static UserStats toUserStats(const UserTotals& totals);
+
+    // Mutex not held, so the listener can read again
+    static void notify(StatsChange change, const QString& deckID = QString());
+};
+
+#endif
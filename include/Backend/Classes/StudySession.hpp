@@ -0,0 +1,91 @@
+#ifndef STUDYSESSION_HPP
+#define STUDYSESSION_HPP
+
+#include <memory>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include "Backend/Classes/Card.hpp"
+#include "Backend/Classes/DueIndex.hpp"
+#include "Backend/Database/prefetcher.hpp"
+
+// Study session over one deck, a chosen set of decks or every deck of the selected user
+// The cards of all decks are read with one query and served from a single queue ordered by
+// due time. Every deck keeps its own DueIndex, so its daily limits still apply.
+// The queue holds no card text, a CardPrefetcher reads it a few batches ahead of the card shown.
+// Cards answered Again or Hard wait in a second heap for their learning step and are shown
+// before the rest as soon as the step is over.
+class StudySession {
+private:
+    static constexpr size_t PREFETCH_WINDOW = 2 * CardPrefetcher::BATCH_SIZE;
+
+    // Learning steps within the session (seconds)
+    static constexpr qint64 AGAIN_STEP = 60;
+    static constexpr qint64 HARD_STEP = 10 * 60;
+
+    struct QueuedCard {
+        qint64 due;    // Seconds since epoch, 0 for cards that were never answered
+        quint64 order; // Breaks ties, requeued cards go behind the ones already waiting
+        QString card_id;
+        CardType type;
+        QString deck_id;
+        std::optional<Card> card; // Set for learning steps, the rest is read by the prefetcher
+    };
+
+    struct Later {
+        bool operator()(const QueuedCard& a, const QueuedCard& b) const {
+            return a.due != b.due ? a.due > b.due : a.order > b.order;
+        }
+    };
+
+    std::vector<QString> deckIDs; // Empty for every deck of the user
+    QString userID;
+
+    std::unordered_map<QString, DueIndex> indexes;
+    std::priority_queue<QueuedCard, std::vector<QueuedCard>, Later> queue;    // Cards loaded at start()
+    std::priority_queue<QueuedCard, std::vector<QueuedCard>, Later> learning; // Waiting for their step
+    quint64 nextOrder = 0;
+
+    // Card IDs in the order they leave the queue, cards before the cursor were requested
+    std::vector<QString> upcoming;
+    size_t cursor = 0;
+    std::unique_ptr<CardPrefetcher> prefetcher;
+
+    QString currentDeckID;   // Deck of the card handed out last
+    QElapsedTimer cardShown; // Started when getNextCard() hands it out, monotonic
+    std::unordered_map<QString, qint64> timeSpent; // Per deck, ms
+
+    bool active = false;
+
+    void push(QueuedCard entry);
+    void pushLearning(QueuedCard entry);
+    // Request the next batches until the window is full again
+    void prefetch();
+
+public:
+    StudySession() = default;
+    explicit StudySession(const std::vector<QString>& deckIDs);
+
+    bool isActive() const;
+    int getQueueSize() const;
+    QString getCurrentDeckID() const;
+    // When the next learning step is over (seconds since epoch), empty when no card waits
+    std::optional<qint64> getNextLearningDue() const;
+
+    // Load the queue and the due indexes, false when nothing can be studied
+    bool start();
+    // Empty card when nothing can be shown now, the session is over unless a learning card waits
+    Card getNextCard();
+    bool processCardResponse(Card& card, int buttonPressed);
+    bool end();
+
+    // New, Learning and due Review counts summed over the session's decks
+    std::vector<int> getCardInformation();
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef CACHE_HPP
+#define CACHE_HPP
+
+#include <atomic>
+#include <memory>
+#include <unordered_map>
+
+#include <QString>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+// Borrowed cached statement
+// Resets the statement when it goes out of scope so it does not keep a read lock open.
+// Read the values you need before requesting the same statement again.
+class Statement {
+private:
+    QSqlQuery* query;
+
+public:
+    explicit Statement(QSqlQuery& query) : query(&query) {}
+    ~Statement() { query->finish(); }
+
+    Statement(const Statement&) = delete;
+    Statement& operator=(const Statement&) = delete;
+
+    QSqlQuery* operator->() const { return query; }
+    QSqlQuery& operator*() const { return *query; }
+};
+
+// Prepared statements for one connection
+// Static statements (see statements.hpp) are keyed by the address of their SQL text,
+// statements built at runtime are keyed by the text itself.
+class StatementCache {
+public:
+    struct Counters {
+        quint64 hits = 0;
+        quint64 misses = 0;
+    };
+
+private:
+    QSqlDatabase db;
+    std::unordered_map<const char*, std::unique_ptr<QSqlQuery>> statements;
+    std::unordered_map<QString, std::unique_ptr<QSqlQuery>> dynamicStatements;
+    Counters counters;
+
+    static std::atomic<quint64> totalHits;
+    static std::atomic<quint64> totalMisses;
+
+    std::unique_ptr<QSqlQuery> prepare(const QString& sql);
+
+public:
+    explicit StatementCache(const QSqlDatabase& db);
+
+    Statement get(const char* sql);
+    Statement get(const QString& sql);
+
+    // Drop every prepared statement (e.g. before the schema is rebuilt)
+    void clear();
+
+    int size() const;
+    Counters getCounters() const;
+    // Hits and misses across all connections
+    static Counters getTotalCounters();
+};
+
+#endif
@@ -0,0 +1,90 @@
+#ifndef COMMITTER_HPP
+#define COMMITTER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <QFile>
+#include <QString>
+
+class QThread;
+
+// One answered card, everything needed to apply it later
+struct ReviewEvent {
+    quint64 sequence = 0;
+    QString user_id;        // Who answered, not whoever is selected when it is applied
+    QString deck_id;
+    QString card_id;
+    int card_type = 0;      // CardType before the answer
+    int button = 0;
+    qint64 answered_at = 0; // Milliseconds since epoch
+    qint64 duration_ms = 0; // Time the card was on screen
+};
+
+// Write-behind committer for answers
+// The GUI thread submits answers and moves on, a worker thread applies them to SQLite
+// in batches (one transaction per batch, one savepoint per answer).
+// Every answer is appended to a journal file before submit() returns. The sequence of the
+// last applied answer is written in the batch transaction, so start() replays exactly the
+// answers that did not make it into the database.
+class ReviewCommitter {
+private:
+    static std::unique_ptr<ReviewCommitter> instance;
+    static std::once_flag initInstanceFlag;
+
+    static constexpr size_t CAPACITY = 256;
+    static constexpr size_t BATCH_SIZE = 32;
+    static constexpr int BATCH_WINDOW_MS = 50;
+    static constexpr int RETRY_DELAY_MS = 1000;
+    static constexpr int MAX_ATTEMPTS = 5; // An answer that keeps failing is dropped after that
+    static constexpr int FLUSH_TIMEOUT_MS = 5000; // flush() gives up after that, a locked database keeps answers queued
+
+    QFile journal;
+    QThread* worker = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable wake;    // Worker waits for answers or stop()
+    std::condition_variable drained; // submit() waits for space, flush() for an empty queue
+    std::deque<ReviewEvent> pending; // Submitted and not committed yet, front is in flight
+    quint64 nextSequence = 1;
+    int flushing = 0;
+    int attempts = 0; // Failed tries of the answer at the front, worker thread only
+    bool running = false;
+    bool stopping = false;
+
+    void run();
+    // Answers of the batch in the database after the call, counted from the front,
+    // empty when the batch could not be written at all
+    std::optional<size_t> applyBatch(const std::vector<ReviewEvent>& batch, bool dropFirst) const;
+    bool appendToJournal(const ReviewEvent& event);
+    std::vector<ReviewEvent> readJournal() const;
+
+public:
+    explicit ReviewCommitter(const QString& journalPath);
+    ~ReviewCommitter();
+
+    ReviewCommitter(const ReviewCommitter&) = delete;
+    ReviewCommitter& operator=(const ReviewCommitter&) = delete;
+
+    // Journal next to the database file
+    static ReviewCommitter* getInstance();
+
+    // Queue the answers left in the journal and start the worker, call after Database::initialize()
+    bool start();
+    // False when the committer is not running, the caller applies the answer itself then
+    // Blocks while the queue is full
+    bool submit(ReviewEvent event);
+    // Wait until every submitted answer is in the database, at most FLUSH_TIMEOUT_MS
+    // False when some are still queued, they stay in the journal and are retried
+    bool flush();
+    // Flush and stop the worker, unsaved answers stay in the journal
+    void stop();
+
+    bool isRunning();
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef COUNTERS_HPP
+#define COUNTERS_HPP
+
+#include <optional>
+#include <unordered_map>
+
+#include <QString>
+
+#include "Backend/Classes/Card.hpp"
+
+// Counts shown for one deck
+struct DeckCounts {
+    int total = 0;
+    int new_cards = 0;   // Capped by the remaining daily new card limit
+    int learning = 0;
+    int due_reviews = 0; // Capped by the remaining daily review limit
+};
+
+// Materialized card counts of every (user, deck), stored in DeckCounters
+// A read first recomputes the rows that are missing, from an earlier day or past their
+// next due review in one statement, then reads every deck of the user in one more.
+// The write paths below keep today's rows current in between.
+class DeckCounters {
+private:
+    static bool refresh(const QString& userID);
+
+public:
+    // Keyed by deck ID
+    static std::unordered_map<QString, DeckCounts> load(const QString& userID);
+    static std::optional<DeckCounts> load(const QString& userID, const QString& deckID);
+
+    // A card was linked to the deck, newly created cards are counted in place
+    static bool cardAdded(const QString& deckID, bool newCard);
+    // Call inside the answer's transaction, due in seconds since epoch
+    static bool cardAnswered(const QString& userID, const QString& cardID, CardType before, CardType after,
+                             bool hadState, qint64 due);
+    // Before the card is deleted, its decks are recomputed on the next read
+    static bool invalidateCard(const QString& cardID);
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef MIGRATIONS_HPP
+#define MIGRATIONS_HPP
+
+#include <vector>
+
+#include <QString>
+#include <QSqlDatabase>
+
+// One schema version step
+// The statements run in a single transaction together with the PRAGMA user_version bump.
+struct Migration {
+    int version;
+    QString description;
+    std::vector<const char*> statements;
+};
+
+class Migrator {
+private:
+    QSqlDatabase db;
+
+    bool apply(const Migration& migration);
+
+public:
+    explicit Migrator(const QSqlDatabase& db);
+
+    // Ordered list of every schema version
+    static const std::vector<Migration>& migrations();
+    static int latestVersion();
+
+    int currentVersion() const;
+    // Brings the database up to latestVersion(), does nothing when it is already there
+    bool migrate();
+    // Drops every table and index of the schema and starts over from version 0
+    bool dropAll();
+};
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef POOL_HPP
+#define POOL_HPP
+
+#include <atomic>
+#include <memory>
+
+#include <QString>
+#include <QSqlDatabase>
+#include <QThreadStorage>
+
+#include "Backend/Database/cache.hpp"
+#include "Backend/Database/profile.hpp"
+
+// Per-thread SQLite connections
+// QtSql connections can only be used from the thread that created them, so every
+// thread that talks to the database checks out its own named connection to the same file.
+// The connection is closed and removed automatically when the owning thread finishes.
+class ConnectionPool {
+private:
+    // Owned by QThreadStorage, deleted on thread exit
+    struct Lease {
+        QString name;
+        QSqlDatabase db;
+        std::unique_ptr<StatementCache> statements;
+        std::shared_ptr<std::atomic<int>> live;
+
+        ~Lease();
+    };
+
+    QString path;
+    PerformanceProfile profile;
+    QThreadStorage<Lease*> leases;
+    std::shared_ptr<std::atomic<int>> live;
+
+public:
+    ConnectionPool(const QString& path);
+
+    // Applied to connections opened after the call
+    void setProfile(const PerformanceProfile& profile);
+
+    // Connection for the calling thread, opened on first use
+    QSqlDatabase checkout();
+    // Prepared statements of the calling thread's connection
+    StatementCache& statements();
+    // Close the calling thread's connection early (it is reopened on the next checkout)
+    void release();
+
+    bool hasConnection() const;
+    int size() const;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef PREFETCHER_HPP
+#define PREFETCHER_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <QString>
+
+class QThread;
+
+// Reads question and answer of upcoming study cards on a worker thread
+// A study session only keeps IDs, types and due times in its queue. It requests the text of
+// the next cards in batches while the ones before them are studied, take() hands them out.
+class CardPrefetcher {
+public:
+    static constexpr size_t BATCH_SIZE = 16; // Placeholders in SELECT_CARD_BATCH
+
+    using Text = std::pair<QString, QString>; // Question, answer
+
+private:
+    QThread* worker = nullptr;
+
+    std::mutex mutex;
+    std::condition_variable wake;   // Worker waits for requests or stop()
+    std::condition_variable loaded; // take() waits for the batch of its card
+    std::deque<QString> requested;             // Not read yet, in request order
+    std::unordered_set<QString> inFlight;      // Requested and not in the window yet
+    std::unordered_map<QString, Text> window;  // Read and not taken yet
+    bool stopping = false;
+
+    void run();
+    // Reads one batch on the calling thread's connection, false on a database error
+    static bool readBatch(const std::vector<QString>& ids, std::unordered_map<QString, Text>& texts);
+
+public:
+    CardPrefetcher() = default;
+    ~CardPrefetcher();
+
+    CardPrefetcher(const CardPrefetcher&) = delete;
+    CardPrefetcher& operator=(const CardPrefetcher&) = delete;
+
+    void start();
+    // Pending requests are dropped, take() reads on the calling thread afterwards
+    void stop();
+
+    void request(const std::vector<QString>& cardIDs);
+    // Waits for the card's batch, requests it first when nobody did
+    // Empty when the card no longer exists or could not be read
+    std::optional<Text> take(const QString& cardID);
+    // The card will not be shown, forget its text
+    void discard(const QString& cardID);
+
+    // Requested or read, and not taken yet
+    size_t pending();
+};
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef PROFILE_HPP
+#define PROFILE_HPP
+
+#include <QString>
+#include <QSqlDatabase>
+
+// SQLite settings applied to every connection when it is opened
+struct PerformanceProfile {
+    QString name;
+    QString journal_mode;    // DELETE, TRUNCATE, WAL...
+    QString synchronous;     // OFF, NORMAL, FULL
+    qint64 mmap_size;        // Bytes of the file mapped into memory, 0 disables mmap
+    int cache_size;          // Pages when positive, KiB when negative
+    QString temp_store;      // DEFAULT, FILE, MEMORY
+    int busy_timeout;        // Milliseconds to wait on a locked database
+
+    // SQLite defaults, what the app used before profiles existed
+    static PerformanceProfile legacy();
+    // WAL with a full fsync on every commit
+    static PerformanceProfile durable();
+    // WAL with fsync only at checkpoints, a large page cache and mmap (default)
+    static PerformanceProfile balanced();
+
+    // Unknown names fall back to balanced()
+    static PerformanceProfile byName(const QString& name);
+
+    bool apply(const QSqlDatabase& db) const;
+};
+
+#endif
@@ -1,6 +1,11 @@
 #ifndef QUERIES_HPP
 #define QUERIES_HPP
 
+// Schema DDL, applied through the migrations in migrations.cpp.
+// Released statements must not change, add a new migration instead.
+
+// Version 1
+
 inline auto CREATE_USERS_TABLE = R"(
     CREATE TABLE IF NOT EXISTS Users (
         id TEXT PRIMARY KEY,
@@ -153,4 +158,391 @@ inline auto CARD_STATS_LAST_SEEN_INDEX = R"(
     CREATE INDEX IF NOT EXISTS idx_card_stats_last_seen ON CardStats(last_seen);
 )";
 
+// Version 2
+// Users, Decks and Cards get an INTEGER PRIMARY KEY (rowid alias), the 8-hex public ID moves to uid.
+// Every reference becomes an integer, junction and stats tables are stored WITHOUT ROWID.
+// AUTOINCREMENT keeps keys of deleted rows from being handed out again.
+// Rows that referenced missing users, decks or cards are dropped while copying.
+
+inline auto CREATE_USERS_TABLE_V2 = R"(
+    CREATE TABLE Users_v2 (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        uid TEXT NOT NULL UNIQUE,
+        username TEXT NOT NULL UNIQUE
+    );
+)";
+inline auto COPY_USERS_V2 = R"(
+    INSERT INTO Users_v2 (uid, username) SELECT id, username FROM Users ORDER BY rowid;
+)";
+
+inline auto CREATE_DECKS_TABLE_V2 = R"(
+    CREATE TABLE Decks_v2 (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        uid TEXT NOT NULL UNIQUE,
+        name TEXT NOT NULL,
+        description TEXT
+    );
+)";
+inline auto COPY_DECKS_V2 = R"(
+    INSERT INTO Decks_v2 (uid, name, description) SELECT id, name, description FROM Decks ORDER BY rowid;
+)";
+
+inline auto CREATE_CARDS_TABLE_V2 = R"(
+    CREATE TABLE Cards_v2 (
+        id INTEGER PRIMARY KEY AUTOINCREMENT,
+        uid TEXT NOT NULL UNIQUE,
+        question TEXT NOT NULL,
+        answer TEXT NOT NULL,
+        type TEXT NOT NULL DEFAULT 'New'
+    );
+)";
+inline auto COPY_CARDS_V2 = R"(
+    INSERT INTO Cards_v2 (uid, question, answer, type) SELECT id, question, answer, type FROM Cards ORDER BY rowid;
+)";
+
+inline auto CREATE_DECKS_CARDS_TABLE_V2 = R"(
+    CREATE TABLE DecksCards_v2 (
+        deck_id INTEGER NOT NULL,
+        card_id INTEGER NOT NULL,
+        PRIMARY KEY(deck_id, card_id),
+        FOREIGN KEY(deck_id) REFERENCES Decks(id) ON DELETE CASCADE,
+        FOREIGN KEY(card_id) REFERENCES Cards(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+inline auto COPY_DECKS_CARDS_V2 = R"(
+    INSERT OR IGNORE INTO DecksCards_v2 (deck_id, card_id)
+    SELECT d.id, c.id FROM DecksCards dc
+    INNER JOIN Decks_v2 d ON d.uid = dc.deck_id
+    INNER JOIN Cards_v2 c ON c.uid = dc.card_id;
+)";
+
+inline auto CREATE_USERS_DECKS_TABLE_V2 = R"(
+    CREATE TABLE UsersDecks_v2 (
+        user_id INTEGER NOT NULL,
+        deck_id INTEGER NOT NULL,
+        PRIMARY KEY(user_id, deck_id),
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE,
+        FOREIGN KEY(deck_id) REFERENCES Decks(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+inline auto COPY_USERS_DECKS_V2 = R"(
+    INSERT OR IGNORE INTO UsersDecks_v2 (user_id, deck_id)
+    SELECT u.id, d.id FROM UsersDecks ud
+    INNER JOIN Users_v2 u ON u.uid = ud.user_id
+    INNER JOIN Decks_v2 d ON d.uid = ud.deck_id;
+)";
+
+inline auto CREATE_DECK_SETTINGS_TABLE_V2 = R"(
+    CREATE TABLE DeckSettings_v2 (
+        id INTEGER PRIMARY KEY,
+        daily_new_card_limit INTEGER DEFAULT 20,
+        max_review_cards INTEGER DEFAULT 100,
+        algorithm TEXT DEFAULT 'SM2',
+        FOREIGN KEY(id) REFERENCES Decks(id) ON DELETE CASCADE
+    );
+)";
+inline auto COPY_DECK_SETTINGS_V2 = R"(
+    INSERT OR IGNORE INTO DeckSettings_v2 (id, daily_new_card_limit, max_review_cards, algorithm)
+    SELECT d.id, s.daily_new_card_limit, s.max_review_cards, s.algorithm FROM DeckSettings s
+    INNER JOIN Decks_v2 d ON d.uid = s.id;
+)";
+
+inline auto CREATE_SAVED_USER_TABLE_V2 = R"(
+    CREATE TABLE SavedUser_v2 (
+        id INTEGER NOT NULL UNIQUE,
+        FOREIGN KEY(id) REFERENCES Users(id)
+    );
+)";
+inline auto COPY_SAVED_USER_V2 = R"(
+    INSERT OR IGNORE INTO SavedUser_v2 (id)
+    SELECT u.id FROM SavedUser s INNER JOIN Users_v2 u ON u.uid = s.id;
+)";
+
+inline auto CREATE_USER_STATS_TABLE_V2 = R"(
+    CREATE TABLE UserStats_v2 (
+        id INTEGER NOT NULL,
+        date DATE NOT NULL,
+        cards_seen INTEGER DEFAULT 0,
+        pressed_again INTEGER DEFAULT 0,
+        pressed_hard INTEGER DEFAULT 0,
+        pressed_good INTEGER DEFAULT 0,
+        pressed_easy INTEGER DEFAULT 0,
+        time_spent_seconds INTEGER DEFAULT 0,
+        times_used INTEGER DEFAULT 0,
+        PRIMARY KEY(id, date),
+        FOREIGN KEY(id) REFERENCES Users(id)
+    ) WITHOUT ROWID;
+)";
+inline auto COPY_USER_STATS_V2 = R"(
+    INSERT OR IGNORE INTO UserStats_v2
+    SELECT u.id, s.date, s.cards_seen, s.pressed_again, s.pressed_hard, s.pressed_good,
+           s.pressed_easy, s.time_spent_seconds, s.times_used
+    FROM UserStats s INNER JOIN Users_v2 u ON u.uid = s.id;
+)";
+
+inline auto CREATE_DECK_STATS_TABLE_V2 = R"(
+    CREATE TABLE DeckStats_v2 (
+        id INTEGER NOT NULL,
+        user_id INTEGER NOT NULL,
+        date DATE NOT NULL,
+        cards_added INTEGER DEFAULT 0,
+        cards_seen INTEGER DEFAULT 0,
+        time_spent_seconds INTEGER DEFAULT 0,
+        session_start_time TIMESTAMP,
+        PRIMARY KEY(user_id, id, date),
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE,
+        FOREIGN KEY(id) REFERENCES Decks(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+inline auto COPY_DECK_STATS_V2 = R"(
+    INSERT OR IGNORE INTO DeckStats_v2
+    SELECT d.id, u.id, s.date, s.cards_added, s.cards_seen, s.time_spent_seconds, s.session_start_time
+    FROM DeckStats s
+    INNER JOIN Decks_v2 d ON d.uid = s.id
+    INNER JOIN Users_v2 u ON u.uid = s.user_id;
+)";
+
+inline auto CREATE_CARD_STATS_TABLE_V2 = R"(
+    CREATE TABLE CardStats_v2 (
+        id INTEGER NOT NULL,
+        user_id INTEGER NOT NULL,
+        date DATE NOT NULL,
+        times_seen INTEGER DEFAULT 0,
+        time_spent_seconds INTEGER DEFAULT 0,
+        interval INTEGER DEFAULT 0,
+        ease_factor FLOAT DEFAULT 2.5,
+        repetitions INTEGER DEFAULT 0,
+        last_seen TIMESTAMP DEFAULT 0,
+        card_start_time TIMESTAMP,
+        PRIMARY KEY(id, user_id, date),
+        FOREIGN KEY(id) REFERENCES Cards(id) ON DELETE CASCADE,
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+inline auto COPY_CARD_STATS_V2 = R"(
+    INSERT OR IGNORE INTO CardStats_v2
+    SELECT c.id, u.id, s.date, s.times_seen, s.time_spent_seconds, s.interval, s.ease_factor,
+           s.repetitions, s.last_seen, s.card_start_time
+    FROM CardStats s
+    INNER JOIN Cards_v2 c ON c.uid = s.id
+    INNER JOIN Users_v2 u ON u.uid = s.user_id;
+)";
+
+// Old tables go away together with their indexes
+inline auto DROP_CARD_STATS_V1 = R"(DROP TABLE CardStats;)";
+inline auto DROP_DECK_STATS_V1 = R"(DROP TABLE DeckStats;)";
+inline auto DROP_USER_STATS_V1 = R"(DROP TABLE UserStats;)";
+inline auto DROP_SAVED_USER_V1 = R"(DROP TABLE SavedUser;)";
+inline auto DROP_DECK_SETTINGS_V1 = R"(DROP TABLE DeckSettings;)";
+inline auto DROP_USERS_DECKS_V1 = R"(DROP TABLE UsersDecks;)";
+inline auto DROP_DECKS_CARDS_V1 = R"(DROP TABLE DecksCards;)";
+inline auto DROP_CARDS_V1 = R"(DROP TABLE Cards;)";
+inline auto DROP_DECKS_V1 = R"(DROP TABLE Decks;)";
+inline auto DROP_USERS_V1 = R"(DROP TABLE Users;)";
+
+inline auto RENAME_USERS_V2 = R"(ALTER TABLE Users_v2 RENAME TO Users;)";
+inline auto RENAME_DECKS_V2 = R"(ALTER TABLE Decks_v2 RENAME TO Decks;)";
+inline auto RENAME_CARDS_V2 = R"(ALTER TABLE Cards_v2 RENAME TO Cards;)";
+inline auto RENAME_DECKS_CARDS_V2 = R"(ALTER TABLE DecksCards_v2 RENAME TO DecksCards;)";
+inline auto RENAME_USERS_DECKS_V2 = R"(ALTER TABLE UsersDecks_v2 RENAME TO UsersDecks;)";
+inline auto RENAME_DECK_SETTINGS_V2 = R"(ALTER TABLE DeckSettings_v2 RENAME TO DeckSettings;)";
+inline auto RENAME_SAVED_USER_V2 = R"(ALTER TABLE SavedUser_v2 RENAME TO SavedUser;)";
+inline auto RENAME_USER_STATS_V2 = R"(ALTER TABLE UserStats_v2 RENAME TO UserStats;)";
+inline auto RENAME_DECK_STATS_V2 = R"(ALTER TABLE DeckStats_v2 RENAME TO DeckStats;)";
+inline auto RENAME_CARD_STATS_V2 = R"(ALTER TABLE CardStats_v2 RENAME TO CardStats;)";
+
+// The (id, user_id, date) primary key already covers lookups by card
+inline auto DECKS_CARDS_CARD_INDEX_V2 = R"(
+    CREATE INDEX idx_decks_cards_card_id ON DecksCards(card_id);
+)";
+inline auto CARD_STATS_USER_INDEX_V2 = R"(
+    CREATE INDEX idx_card_stats_user_id ON CardStats(user_id);
+)";
+inline auto CARD_STATS_DATE_INDEX_V2 = R"(
+    CREATE INDEX idx_card_stats_date ON CardStats(date);
+)";
+inline auto CARD_STATS_LAST_SEEN_INDEX_V2 = R"(
+    CREATE INDEX idx_card_stats_last_seen ON CardStats(last_seen);
+)";
+
+// Version 3
+// Sequence of the last answer written by the ReviewCommitter, stored in the same
+// transaction as the answers so the journal replay after a crash skips them
+inline auto CREATE_REVIEW_JOURNAL_TABLE = R"(
+    CREATE TABLE ReviewJournal (
+        id INTEGER PRIMARY KEY CHECK (id = 1),
+        sequence INTEGER NOT NULL DEFAULT 0
+    );
+)";
+inline auto INSERT_REVIEW_JOURNAL_ROW = R"(
+    INSERT INTO ReviewJournal (id) VALUES (1);
+)";
+
+// Version 4
+// Append-only review log and one scheduling state row per (user, card).
+// ReviewLog starts empty, CardStats only kept per day totals.
+// CardState is seeded from the latest CardStats row, due uses the 86400 s day of Deck.cpp.
+inline auto CREATE_REVIEW_LOG_TABLE = R"(
+    CREATE TABLE ReviewLog (
+        id INTEGER PRIMARY KEY,
+        card_id INTEGER NOT NULL,
+        user_id INTEGER NOT NULL,
+        reviewed_at INTEGER NOT NULL,
+        card_type INTEGER NOT NULL,
+        button INTEGER NOT NULL,
+        interval_before INTEGER NOT NULL,
+        interval_after INTEGER NOT NULL,
+        ease INTEGER NOT NULL,
+        duration_ms INTEGER NOT NULL,
+        FOREIGN KEY(card_id) REFERENCES Cards(id) ON DELETE CASCADE,
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE
+    );
+)";
+inline auto REVIEW_LOG_USER_TIME_INDEX = R"(
+    CREATE INDEX idx_review_log_user_time ON ReviewLog(user_id, reviewed_at);
+)";
+inline auto REVIEW_LOG_USER_CARD_INDEX = R"(
+    CREATE INDEX idx_review_log_user_card ON ReviewLog(user_id, card_id, reviewed_at);
+)";
+
+inline auto CREATE_CARD_STATE_TABLE = R"(
+    CREATE TABLE CardState (
+        user_id INTEGER NOT NULL,
+        card_id INTEGER NOT NULL,
+        interval INTEGER NOT NULL DEFAULT 0,
+        ease_factor REAL NOT NULL DEFAULT 2.5,
+        repetitions INTEGER NOT NULL DEFAULT 0,
+        last_seen INTEGER NOT NULL DEFAULT 0,
+        due INTEGER NOT NULL DEFAULT 0,
+        PRIMARY KEY(user_id, card_id),
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE,
+        FOREIGN KEY(card_id) REFERENCES Cards(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+inline auto COPY_CARD_STATE = R"(
+    INSERT INTO CardState (user_id, card_id, interval, ease_factor, repetitions, last_seen, due)
+    SELECT user_id, id, interval, ease_factor, repetitions, last_seen, last_seen + interval * 86400
+    FROM (
+        SELECT *, ROW_NUMBER() OVER (PARTITION BY user_id, id ORDER BY date DESC) AS rn
+        FROM CardStats
+    )
+    WHERE rn = 1;
+)";
+inline auto CARD_STATE_DUE_INDEX = R"(
+    CREATE INDEX idx_card_state_due ON CardState(user_id, due);
+)";
+
+// Version 5
+// Card counts of every (user, deck) for the deck table, see counters.hpp.
+// Rows are filled on first read, a row is stale once its day is over or next_due has passed.
+inline auto CREATE_DECK_COUNTERS_TABLE = R"(
+    CREATE TABLE DeckCounters (
+        user_id INTEGER NOT NULL,
+        deck_id INTEGER NOT NULL,
+        day TEXT NOT NULL,
+        total INTEGER NOT NULL DEFAULT 0,
+        new_cards INTEGER NOT NULL DEFAULT 0,
+        learning INTEGER NOT NULL DEFAULT 0,
+        due_reviews INTEGER NOT NULL DEFAULT 0,
+        next_due INTEGER,
+        new_studied INTEGER NOT NULL DEFAULT 0,
+        reviews_studied INTEGER NOT NULL DEFAULT 0,
+        PRIMARY KEY(user_id, deck_id),
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE,
+        FOREIGN KEY(deck_id) REFERENCES Decks(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+
+// Version 6
+// FSRS memory state next to the SM2 fields, 0 until FSRS answered the card
+inline auto ADD_CARD_STATE_STABILITY = R"(
+    ALTER TABLE CardState ADD COLUMN stability REAL NOT NULL DEFAULT 0;
+)";
+inline auto ADD_CARD_STATE_DIFFICULTY = R"(
+    ALTER TABLE CardState ADD COLUMN difficulty REAL NOT NULL DEFAULT 0;
+)";
+// Weights fitted to the review log of each user, see FSRSOptimizer
+inline auto CREATE_FSRS_WEIGHTS_TABLE = R"(
+    CREATE TABLE FSRSWeights (
+        user_id INTEGER PRIMARY KEY,
+        weights TEXT NOT NULL,
+        reviews INTEGER NOT NULL,
+        log_loss REAL NOT NULL,
+        fitted_at INTEGER NOT NULL,
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE
+    );
+)";
+
+// Version 7
+// Lapses of the answers logged so far, Again on a card that had an interval
+inline auto ADD_CARD_STATE_LAPSES = R"(
+    ALTER TABLE CardState ADD COLUMN lapses INTEGER NOT NULL DEFAULT 0;
+)";
+inline auto COUNT_CARD_STATE_LAPSES = R"(
+    UPDATE CardState SET lapses = (
+        SELECT COUNT(*) FROM ReviewLog rl
+        WHERE rl.user_id = CardState.user_id AND rl.card_id = CardState.card_id
+          AND rl.button = 1 AND rl.interval_before > 0
+    );
+)";
+
+// Version 8
+// Stats of finished days summed per week (starting Monday), month and all time, see rollups.hpp.
+// Period is 0 for weeks, 1 for months and 2 for all time, start is '' for all time.
+inline auto CREATE_USER_STATS_ROLLUP_TABLE = R"(
+    CREATE TABLE UserStatsRollup (
+        user_id INTEGER NOT NULL,
+        period INTEGER NOT NULL,
+        start DATE NOT NULL,
+        cards_seen INTEGER NOT NULL DEFAULT 0,
+        pressed_again INTEGER NOT NULL DEFAULT 0,
+        pressed_hard INTEGER NOT NULL DEFAULT 0,
+        pressed_good INTEGER NOT NULL DEFAULT 0,
+        pressed_easy INTEGER NOT NULL DEFAULT 0,
+        time_spent_seconds INTEGER NOT NULL DEFAULT 0,
+        times_used INTEGER NOT NULL DEFAULT 0,
+        PRIMARY KEY(user_id, period, start),
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+inline auto CREATE_DECK_STATS_ROLLUP_TABLE = R"(
+    CREATE TABLE DeckStatsRollup (
+        user_id INTEGER NOT NULL,
+        deck_id INTEGER NOT NULL,
+        period INTEGER NOT NULL,
+        start DATE NOT NULL,
+        cards_added INTEGER NOT NULL DEFAULT 0,
+        cards_seen INTEGER NOT NULL DEFAULT 0,
+        time_spent_seconds INTEGER NOT NULL DEFAULT 0,
+        PRIMARY KEY(user_id, period, start, deck_id),
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE,
+        FOREIGN KEY(deck_id) REFERENCES Decks(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+// Last day of each user summed into the rollups, the first roll-over sums the whole history
+inline auto CREATE_STATS_ROLLUP_STATE_TABLE = R"(
+    CREATE TABLE StatsRollupState (
+        user_id INTEGER PRIMARY KEY,
+        rolled_through DATE NOT NULL,
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE
+    );
+)";
+// The roll-over reads the days of one user after a date
+inline auto DECK_STATS_USER_DATE_INDEX = R"(
+    CREATE INDEX idx_deck_stats_user_date ON DeckStats(user_id, date);
+)";
+
+// Version 9
+// Answer time histogram of each user and deck, see AnswerTimes
+inline auto CREATE_ANSWER_TIMES_TABLE = R"(
+    CREATE TABLE AnswerTimes (
+        user_id INTEGER NOT NULL,
+        deck_id INTEGER NOT NULL,
+        histogram BLOB NOT NULL,
+        PRIMARY KEY(user_id, deck_id),
+        FOREIGN KEY(user_id) REFERENCES Users(id) ON DELETE CASCADE,
+        FOREIGN KEY(deck_id) REFERENCES Decks(id) ON DELETE CASCADE
+    ) WITHOUT ROWID;
+)";
+
 #endif
@@ -0,0 +1,23 @@
+#ifndef ROLLUPS_HPP
+#define ROLLUPS_HPP
+
+#include <QString>
+
+// Periods a stats total covers, stored as the period column of the rollup tables
+enum class StatsPeriod : int {
+    Week = 0,  // Since Monday
+    Month = 1, // Since the first of the month
+    AllTime = 2
+};
+
+// UserStats and DeckStats summed per week, month and all time, in UserStatsRollup and DeckStatsRollup
+// Only today's daily rows still change. Every finished day is added to the rollups once, the first
+// time the user's stats are read or written on a later day, so a total is one rollup row plus
+// today's row however long the history is. StatsRollupState keeps the last day added per user.
+class StatsRollups {
+public:
+    // Adds the days finished since the last call, a single read when there are none
+    static bool rollOver(const QString& userID);
+};
+
+#endif
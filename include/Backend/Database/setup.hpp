@@ -6,21 +6,49 @@
 #include <mutex>
 #include <QSqlDatabase>
 
+#include "Backend/Database/pool.hpp"
+#include "Backend/Database/cache.hpp"
+#include "Backend/Database/profile.hpp"
+
+class QThread;
+
 class Database {
 private:
     static std::unique_ptr<Database> instance;
     static std::once_flag initInstanceFlag;
     QSqlDatabase db;
     std::string path;
+    PerformanceProfile profile;
+
+    // The thread that created the instance uses the default connection,
+    // every other thread gets its own connection from the pool
+    QThread* owner;
+    mutable ConnectionPool pool;
+    std::unique_ptr<StatementCache> statements;
+
+    StatementCache& statementsForThread() const;
 
 public:
     Database(const std::string &path);
     ~Database();
 
     static Database* getInstance(const std::string &path = "app_data.db");
+    // Connection for the calling thread
     QSqlDatabase getDB() const;
+    QString getPath() const;
+    ConnectionPool& connections() const;
+
+    // Prepared, reusable statement on the calling thread's connection
+    Statement statement(const char* sql) const;
+    Statement statement(const QString& sql) const;
+    StatementCache::Counters statementCounters() const;
+
+    // Takes effect on the next initialize(), defaults to MINDLEAP_DB_PROFILE or "balanced"
+    void setProfile(const PerformanceProfile& profile);
+    PerformanceProfile getProfile() const;
+
     void initialize();
     void reset();
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,578 @@
+#ifndef STATEMENTS_HPP
+#define STATEMENTS_HPP
+
+// Statements used on the study/answer path.
+// These are prepared once per connection through Database::statement(),
+// the cache uses the address of the text as the key so always pass the constant itself.
+// Parameters and results use the public 8-hex IDs (uid), joins use the integer keys.
+
+// Users
+// Cached by SessionContext
+inline auto SELECT_SAVED_USER = R"(
+    SELECT u.uid FROM SavedUser s INNER JOIN Users u ON u.id = s.id LIMIT 1
+)";
+
+// Decks
+// Cached by SessionContext
+inline auto SELECT_DECK_SETTINGS = R"(
+    SELECT daily_new_card_limit, max_review_cards, algorithm FROM DeckSettings
+    WHERE id = (SELECT id FROM Decks WHERE uid = ?)
+)";
+
+inline auto UPDATE_DECK_ALGORITHM = R"(
+    UPDATE DeckSettings SET algorithm = ? WHERE id = (SELECT id FROM Decks WHERE uid = ?)
+)";
+
+inline auto COUNT_DECK_CARDS = R"(
+    SELECT COUNT(*) FROM DecksCards WHERE deck_id = (SELECT id FROM Decks WHERE uid = ?)
+)";
+
+// Study sessions
+// Every card of the user's decks without its text, ready is set for the cards that can be shown now
+// (never answered, due or Learning). Due is NULL when the card has no state yet.
+// Binds: now, user
+inline auto SELECT_SESSION_CARDS = R"(
+    SELECT d.uid AS deck_id, c.uid AS id, c.type, cs.due,
+           (cs.card_id IS NULL OR cs.due <= ? OR c.type = 'Learning') AS ready
+    FROM UsersDecks ud
+    INNER JOIN Decks d ON d.id = ud.deck_id
+    INNER JOIN DecksCards dc ON dc.deck_id = ud.deck_id
+    INNER JOIN Cards c ON c.id = dc.card_id
+    LEFT JOIN CardState cs ON cs.card_id = c.id AND cs.user_id = ud.user_id
+    WHERE ud.user_id = (SELECT id FROM Users WHERE uid = ?)
+    ORDER BY COALESCE(cs.due, 0)
+)";
+
+// Question and answer of the next cards of a session (see CardPrefetcher)
+// Binds: 16 card IDs, unused ones are bound as empty strings
+inline auto SELECT_CARD_BATCH = R"(
+    SELECT uid AS id, question, answer FROM Cards
+    WHERE uid IN (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+)";
+
+inline auto SELECT_STUDIED_TODAY_BY_DECK = R"(
+    SELECT d.uid AS deck_id,
+           COUNT(DISTINCT CASE WHEN r.card_type = 0 THEN r.card_id END) AS new_studied,
+           COUNT(DISTINCT CASE WHEN r.card_type = 2 THEN r.card_id END) AS reviews_studied
+    FROM ReviewLog r
+    INNER JOIN DecksCards dc ON dc.card_id = r.card_id
+    INNER JOIN UsersDecks ud ON ud.deck_id = dc.deck_id AND ud.user_id = r.user_id
+    INNER JOIN Decks d ON d.id = dc.deck_id
+    WHERE r.user_id = (SELECT id FROM Users WHERE uid = ?)
+      AND r.reviewed_at >= strftime('%s', DATE('now')) * 1000
+    GROUP BY dc.deck_id
+)";
+
+// Bulk rescheduling (see Reschedule)
+// Every operation first collects its cards in a temporary table of the connection,
+// then changes all of them with one statement.
+inline auto CREATE_RESCHEDULE_SELECTION = R"(
+    CREATE TEMP TABLE IF NOT EXISTS RescheduleSelection (card_id INTEGER PRIMARY KEY)
+)";
+
+inline auto CLEAR_RESCHEDULE_SELECTION = R"(
+    DELETE FROM temp.RescheduleSelection
+)";
+
+inline auto SELECT_DECK_INTO_SELECTION = R"(
+    INSERT OR IGNORE INTO temp.RescheduleSelection (card_id)
+    SELECT card_id FROM DecksCards WHERE deck_id = (SELECT id FROM Decks WHERE uid = ?)
+)";
+
+inline auto SELECT_CARD_INTO_SELECTION = R"(
+    INSERT OR IGNORE INTO temp.RescheduleSelection (card_id) SELECT id FROM Cards WHERE uid = ?
+)";
+
+// Binds: seconds, user, now
+inline auto POSTPONE_SELECTION = R"(
+    UPDATE CardState SET due = due + ?
+    WHERE user_id = (SELECT id FROM Users WHERE uid = ?) AND due <= ?
+      AND card_id IN (SELECT card_id FROM temp.RescheduleSelection)
+)";
+
+// Overdue cards in due order, the first share on today, the next on tomorrow and so on
+// Binds: now, days, user, now, user
+inline auto SPREAD_SELECTION = R"(
+    UPDATE CardState SET due = spread.new_due
+    FROM (
+        SELECT card_id,
+               ? + ((ROW_NUMBER() OVER (ORDER BY due, card_id) - 1) * ? / COUNT(*) OVER ()) * 86400 AS new_due
+        FROM CardState
+        WHERE user_id = (SELECT id FROM Users WHERE uid = ?) AND due <= ?
+          AND card_id IN (SELECT card_id FROM temp.RescheduleSelection)
+    ) AS spread
+    WHERE CardState.user_id = (SELECT id FROM Users WHERE uid = ?) AND CardState.card_id = spread.card_id
+)";
+
+// Binds: user
+inline auto FORGET_SELECTION_STATE = R"(
+    DELETE FROM CardState
+    WHERE user_id = (SELECT id FROM Users WHERE uid = ?)
+      AND card_id IN (SELECT card_id FROM temp.RescheduleSelection)
+)";
+
+inline auto FORGET_SELECTION_TYPE = R"(
+    UPDATE Cards SET type = 'New'
+    WHERE type <> 'New' AND id IN (SELECT card_id FROM temp.RescheduleSelection)
+)";
+
+// Recomputed on the next read
+inline auto DELETE_DECK_COUNTERS_SELECTION = R"(
+    DELETE FROM DeckCounters
+    WHERE deck_id IN (SELECT deck_id FROM DecksCards WHERE card_id IN (SELECT card_id FROM temp.RescheduleSelection))
+)";
+
+// Review forecast (see Forecast)
+// Scheduled cards of the user due before the end of the forecast, one row per (card, deck)
+// Binds: user, end of the last day
+inline auto SELECT_FORECAST_STATE = R"(
+    SELECT cs.card_id, dc.deck_id, d.uid AS deck_uid, cs.due
+    FROM CardState cs
+    INNER JOIN DecksCards dc ON dc.card_id = cs.card_id
+    INNER JOIN UsersDecks ud ON ud.deck_id = dc.deck_id AND ud.user_id = cs.user_id
+    INNER JOIN Decks d ON d.id = dc.deck_id
+    WHERE cs.user_id = (SELECT id FROM Users WHERE uid = ?) AND cs.due < ?
+    ORDER BY cs.card_id
+)";
+
+// Binds: user, card
+inline auto SELECT_CARD_DECKS_FOR_USER = R"(
+    SELECT d.uid FROM DecksCards dc
+    INNER JOIN UsersDecks ud ON ud.deck_id = dc.deck_id
+    INNER JOIN Decks d ON d.id = dc.deck_id
+    WHERE ud.user_id = (SELECT id FROM Users WHERE uid = ?)
+      AND dc.card_id = (SELECT id FROM Cards WHERE uid = ?)
+)";
+
+// Review calendar (see Heatmap)
+// Days of the user before the first logged answer, kept as daily totals only
+// Binds: user, user
+inline auto SELECT_HEATMAP_EARLIER_DAYS = R"(
+    SELECT date, cards_seen, time_spent_seconds FROM UserStats
+    WHERE id = (SELECT id FROM Users WHERE uid = ?) AND cards_seen > 0
+      AND date < COALESCE((SELECT DATE(MIN(reviewed_at) / 1000, 'unixepoch') FROM ReviewLog
+                           WHERE user_id = (SELECT id FROM Users WHERE uid = ?)), '9999-12-31')
+    ORDER BY date
+)";
+
+// Every answer of the user in answer order
+// Binds: user
+inline auto SELECT_HEATMAP_REVIEWS = R"(
+    SELECT reviewed_at, duration_ms FROM ReviewLog
+    WHERE user_id = (SELECT id FROM Users WHERE uid = ?) AND button BETWEEN 1 AND 4
+    ORDER BY reviewed_at
+)";
+
+// Answer time histograms of every deck of the user (see AnswerTimes)
+// Binds: user
+inline auto SELECT_ANSWER_TIMES = R"(
+    SELECT d.uid, a.histogram FROM AnswerTimes a
+    JOIN Decks d ON d.id = a.deck_id
+    WHERE a.user_id = (SELECT id FROM Users WHERE uid = ?)
+)";
+
+// Binds: user, deck, histogram
+inline auto UPSERT_ANSWER_TIMES = R"(
+    INSERT INTO AnswerTimes (user_id, deck_id, histogram)
+    VALUES ((SELECT id FROM Users WHERE uid = ?), (SELECT id FROM Decks WHERE uid = ?), ?)
+    ON CONFLICT(user_id, deck_id) DO UPDATE SET histogram = excluded.histogram
+)";
+
+// FSRS weights (see FSRSAlgorithm and FSRSOptimizer)
+// Binds: user
+inline auto SELECT_FSRS_WEIGHTS = R"(
+    SELECT weights FROM FSRSWeights WHERE user_id = (SELECT id FROM Users WHERE uid = ?)
+)";
+
+// Binds: user, weights, reviews, log loss, fitted at
+inline auto UPSERT_FSRS_WEIGHTS = R"(
+    INSERT INTO FSRSWeights (user_id, weights, reviews, log_loss, fitted_at)
+    VALUES ((SELECT id FROM Users WHERE uid = ?), ?, ?, ?, ?)
+    ON CONFLICT(user_id) DO UPDATE SET
+        weights = excluded.weights,
+        reviews = excluded.reviews,
+        log_loss = excluded.log_loss,
+        fitted_at = excluded.fitted_at
+)";
+
+// Every answer of the user, grouped by card in answer order
+// Binds: user
+inline auto SELECT_REVIEW_HISTORY = R"(
+    SELECT card_id, reviewed_at, button FROM ReviewLog
+    WHERE user_id = (SELECT id FROM Users WHERE uid = ?) AND button BETWEEN 1 AND 4
+    ORDER BY card_id, reviewed_at
+)";
+
+// Scheduling state of every card of a deck for the simulator, NULL state for new cards
+// Binds: user, deck
+inline auto SELECT_SIMULATION_STATE = R"(
+    SELECT cs.interval, cs.ease_factor, cs.repetitions, cs.stability, cs.difficulty, cs.last_seen, cs.due
+    FROM DecksCards dc
+    LEFT JOIN CardState cs ON cs.card_id = dc.card_id AND cs.user_id = (SELECT id FROM Users WHERE uid = ?)
+    WHERE dc.deck_id = (SELECT id FROM Decks WHERE uid = ?)
+    ORDER BY dc.card_id
+)";
+
+// Deck counters
+// Recomputes the rows of the user's decks that are missing, from an earlier day or past next_due
+// Binds: now, now, user, now
+inline auto REFRESH_DECK_COUNTERS = R"(
+    INSERT OR REPLACE INTO DeckCounters (user_id, deck_id, day, total, new_cards, learning,
+                                         due_reviews, next_due, new_studied, reviews_studied)
+    SELECT ud.user_id, ud.deck_id, DATE('now'),
+        (SELECT COUNT(*) FROM DecksCards dc WHERE dc.deck_id = ud.deck_id),
+        (SELECT COUNT(*) FROM DecksCards dc INNER JOIN Cards c ON c.id = dc.card_id
+         WHERE dc.deck_id = ud.deck_id AND c.type = 'New'
+           AND NOT EXISTS (SELECT 1 FROM CardState cs WHERE cs.user_id = ud.user_id AND cs.card_id = c.id)),
+        (SELECT COUNT(*) FROM DecksCards dc INNER JOIN Cards c ON c.id = dc.card_id
+         WHERE dc.deck_id = ud.deck_id AND c.type = 'Learning'),
+        (SELECT COUNT(*) FROM DecksCards dc INNER JOIN Cards c ON c.id = dc.card_id
+         INNER JOIN CardState cs ON cs.card_id = c.id AND cs.user_id = ud.user_id
+         WHERE dc.deck_id = ud.deck_id AND c.type = 'Review' AND cs.due <= ?),
+        (SELECT MIN(cs.due) FROM DecksCards dc INNER JOIN Cards c ON c.id = dc.card_id
+         INNER JOIN CardState cs ON cs.card_id = c.id AND cs.user_id = ud.user_id
+         WHERE dc.deck_id = ud.deck_id AND c.type = 'Review' AND cs.due > ?),
+        (SELECT COUNT(DISTINCT r.card_id) FROM ReviewLog r INNER JOIN DecksCards dc ON dc.card_id = r.card_id
+         WHERE dc.deck_id = ud.deck_id AND r.user_id = ud.user_id
+           AND r.reviewed_at >= strftime('%s', DATE('now')) * 1000 AND r.card_type = 0),
+        (SELECT COUNT(DISTINCT r.card_id) FROM ReviewLog r INNER JOIN DecksCards dc ON dc.card_id = r.card_id
+         WHERE dc.deck_id = ud.deck_id AND r.user_id = ud.user_id
+           AND r.reviewed_at >= strftime('%s', DATE('now')) * 1000 AND r.card_type = 2)
+    FROM UsersDecks ud
+    WHERE ud.user_id = (SELECT id FROM Users WHERE uid = ?)
+      AND NOT EXISTS (
+          SELECT 1 FROM DeckCounters k
+          WHERE k.user_id = ud.user_id AND k.deck_id = ud.deck_id AND k.day = DATE('now')
+            AND (k.next_due IS NULL OR k.next_due > ?)
+      )
+)";
+
+// New and due review counts are capped by what is left of the daily limits
+inline auto SELECT_DECK_COUNTERS = R"(
+    SELECT d.uid AS id, k.total,
+           MIN(MAX(0, COALESCE(s.daily_new_card_limit, 20) - k.new_studied), k.new_cards) AS new_cards,
+           k.learning,
+           MIN(MAX(0, COALESCE(s.max_review_cards, 100) - k.reviews_studied), k.due_reviews) AS due_reviews
+    FROM DeckCounters k
+    INNER JOIN Decks d ON d.id = k.deck_id
+    LEFT JOIN DeckSettings s ON s.id = k.deck_id
+    WHERE k.user_id = (SELECT id FROM Users WHERE uid = ?)
+)";
+
+inline auto SELECT_DECK_COUNTERS_FOR_DECK = R"(
+    SELECT d.uid AS id, k.total,
+           MIN(MAX(0, COALESCE(s.daily_new_card_limit, 20) - k.new_studied), k.new_cards) AS new_cards,
+           k.learning,
+           MIN(MAX(0, COALESCE(s.max_review_cards, 100) - k.reviews_studied), k.due_reviews) AS due_reviews
+    FROM DeckCounters k
+    INNER JOIN Decks d ON d.id = k.deck_id
+    LEFT JOIN DeckSettings s ON s.id = k.deck_id
+    WHERE k.user_id = (SELECT id FROM Users WHERE uid = ?) AND d.uid = ?
+)";
+
+// Binds: new card removed, learning delta, due delta, next due, next due, new studied, reviews studied, user, card
+// next_due keeps the earliest of both, a NULL bind leaves it as is
+inline auto UPDATE_DECK_COUNTERS_ANSWER = R"(
+    UPDATE DeckCounters SET
+        new_cards = MAX(0, new_cards - ?),
+        learning = MAX(0, learning + ?),
+        due_reviews = MAX(0, due_reviews + ?),
+        next_due = COALESCE(MIN(next_due, ?), next_due, ?),
+        new_studied = new_studied + ?,
+        reviews_studied = reviews_studied + ?
+    WHERE user_id = (SELECT id FROM Users WHERE uid = ?) AND day = DATE('now')
+      AND deck_id IN (SELECT deck_id FROM DecksCards WHERE card_id = (SELECT id FROM Cards WHERE uid = ?))
+)";
+
+inline auto UPDATE_DECK_COUNTERS_CARD_ADDED = R"(
+    UPDATE DeckCounters SET total = total + 1, new_cards = new_cards + 1
+    WHERE deck_id = (SELECT id FROM Decks WHERE uid = ?)
+)";
+
+inline auto DELETE_DECK_COUNTERS_DECK = R"(
+    DELETE FROM DeckCounters WHERE deck_id = (SELECT id FROM Decks WHERE uid = ?)
+)";
+
+inline auto DELETE_DECK_COUNTERS_CARD = R"(
+    DELETE FROM DeckCounters
+    WHERE deck_id IN (SELECT deck_id FROM DecksCards WHERE card_id = (SELECT id FROM Cards WHERE uid = ?))
+)";
+
+// Card types are shared, other users' rows of the card's decks are recomputed
+inline auto DELETE_DECK_COUNTERS_OTHER_USERS = R"(
+    DELETE FROM DeckCounters
+    WHERE user_id != (SELECT id FROM Users WHERE uid = ?)
+      AND deck_id IN (SELECT deck_id FROM DecksCards WHERE card_id = (SELECT id FROM Cards WHERE uid = ?))
+)";
+
+// Review committer
+inline auto SELECT_COMMITTED_SEQUENCE = R"(
+    SELECT sequence FROM ReviewJournal WHERE id = 1
+)";
+
+inline auto UPDATE_COMMITTED_SEQUENCE = R"(
+    UPDATE ReviewJournal SET sequence = ? WHERE id = 1
+)";
+
+// Cards
+inline auto UPDATE_CARD_TYPE = R"(
+    UPDATE Cards SET type = ? WHERE uid = ?
+)";
+
+// Card Stats
+// Review log and scheduling state
+inline auto COUNT_CARD_STATE = R"(
+    SELECT COUNT(*) FROM CardState
+    WHERE user_id = (SELECT id FROM Users WHERE uid = ?) AND card_id = (SELECT id FROM Cards WHERE uid = ?)
+)";
+
+inline auto SELECT_CARD_STATE = R"(
+    SELECT c.id, cs.due, cs.last_seen, cs.interval, cs.ease_factor, cs.repetitions, cs.lapses,
+           cs.stability, cs.difficulty
+    FROM Cards c
+    LEFT JOIN CardState cs ON cs.card_id = c.id AND cs.user_id = (SELECT id FROM Users WHERE uid = ?)
+    WHERE c.uid = ?
+)";
+
+inline auto UPSERT_CARD_STATE = R"(
+    INSERT INTO CardState (user_id, card_id, due, last_seen, interval, ease_factor, repetitions, lapses,
+                           stability, difficulty)
+    VALUES ((SELECT id FROM Users WHERE uid = ?), ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    ON CONFLICT(user_id, card_id) DO UPDATE SET
+        due = excluded.due,
+        last_seen = excluded.last_seen,
+        interval = excluded.interval,
+        ease_factor = excluded.ease_factor,
+        repetitions = excluded.repetitions,
+        lapses = excluded.lapses,
+        stability = excluded.stability,
+        difficulty = excluded.difficulty
+)";
+
+inline auto INSERT_REVIEW_LOG = R"(
+    INSERT INTO ReviewLog (card_id, user_id, reviewed_at, card_type, button,
+                           interval_before, interval_after, ease, duration_ms)
+    VALUES (?, (SELECT id FROM Users WHERE uid = ?), ?, ?, ?, ?, ?, ?, ?)
+)";
+
+inline auto SELECT_LATEST_CARD_STATS = R"(
+    SELECT u.uid AS user_id, cs.date, cs.times_seen, cs.time_spent_seconds, cs.interval,
+           cs.ease_factor, cs.repetitions, cs.last_seen, cs.card_start_time
+    FROM CardStats cs INNER JOIN Users u ON u.id = cs.user_id
+    WHERE cs.id = (SELECT id FROM Cards WHERE uid = ?)
+    ORDER BY cs.date DESC LIMIT 1
+)";
+
+inline auto COUNT_CARD_STATS_TODAY = R"(
+    SELECT COUNT(*) FROM CardStats WHERE id = (SELECT id FROM Cards WHERE uid = ?) AND date = DATE('now')
+)";
+
+inline auto SELECT_CARD_STATS_CARRY_OVER = R"(
+    SELECT ease_factor, interval, repetitions FROM CardStats
+    WHERE id = (SELECT id FROM Cards WHERE uid = ?) ORDER BY date DESC LIMIT 1
+)";
+
+inline auto INSERT_CARD_STATS_TODAY = R"(
+    INSERT OR IGNORE INTO CardStats (id, user_id, date, ease_factor, interval, repetitions)
+    VALUES ((SELECT id FROM Cards WHERE uid = ?), (SELECT id FROM Users WHERE uid = ?), DATE('now'), ?, ?, ?)
+)";
+
+// Deck Stats
+inline auto SELECT_LATEST_DECK_STATS = R"(
+    SELECT date, cards_added, cards_seen, time_spent_seconds, session_start_time FROM DeckStats
+    WHERE id = (SELECT id FROM Decks WHERE uid = ?) AND user_id = (SELECT id FROM Users WHERE uid = ?)
+    ORDER BY date DESC LIMIT 1
+)";
+
+inline auto COUNT_DECK_STATS_TODAY = R"(
+    SELECT COUNT(*) FROM DeckStats
+    WHERE id = (SELECT id FROM Decks WHERE uid = ?) AND user_id = (SELECT id FROM Users WHERE uid = ?)
+      AND date = DATE('now')
+)";
+
+inline auto INSERT_DECK_STATS_TODAY = R"(
+    INSERT OR IGNORE INTO DeckStats (id, user_id, date)
+    VALUES ((SELECT id FROM Decks WHERE uid = ?), (SELECT id FROM Users WHERE uid = ?), DATE('now'))
+)";
+
+// One answer (see Deck::applyCardResponse)
+// Binds: deck, user
+inline auto UPDATE_DECK_STATS_ANSWER = R"(
+    UPDATE DeckStats SET cards_seen = cards_seen + 1
+    WHERE id = (SELECT id FROM Decks WHERE uid = ?) AND user_id = (SELECT id FROM Users WHERE uid = ?)
+      AND date = DATE('now')
+)";
+
+// User Stats
+inline auto SELECT_LATEST_USER_STATS = R"(
+    SELECT date, cards_seen, pressed_again, pressed_hard, pressed_good, pressed_easy,
+           time_spent_seconds, times_used
+    FROM UserStats WHERE id = (SELECT id FROM Users WHERE uid = ?) ORDER BY date DESC LIMIT 1
+)";
+
+inline auto COUNT_USER_STATS_TODAY = R"(
+    SELECT COUNT(*) FROM UserStats WHERE id = (SELECT id FROM Users WHERE uid = ?) AND date = DATE('now')
+)";
+
+inline auto INSERT_USER_STATS_TODAY = R"(
+    INSERT OR IGNORE INTO UserStats (id, date) VALUES ((SELECT id FROM Users WHERE uid = ?), DATE('now'))
+)";
+
+// One answer (see Deck::applyCardResponse), 1 for the button pressed and 0 for the others
+// Binds: again, hard, good, easy, user
+inline auto UPDATE_USER_STATS_ANSWER = R"(
+    UPDATE UserStats SET cards_seen = cards_seen + 1, pressed_again = pressed_again + ?, pressed_hard = pressed_hard + ?,
+                         pressed_good = pressed_good + ?, pressed_easy = pressed_easy + ?
+    WHERE id = (SELECT id FROM Users WHERE uid = ?) AND date = DATE('now')
+)";
+
+// Stats rollups
+// Finished days are summed into the rollups once (see rollups.hpp), a total is its rollup row
+// plus today's row. Binds the period: 0 this week, 1 this month, 2 all time.
+inline auto SELECT_STATS_ROLLUP_STATE = R"(
+    SELECT COALESCE((SELECT rolled_through FROM StatsRollupState
+                     WHERE user_id = (SELECT id FROM Users WHERE uid = ?)), ''),
+           DATE('now', '-1 day')
+)";
+
+inline auto ROLL_UP_USER_STATS = R"(
+    WITH days AS (
+        SELECT * FROM UserStats
+        WHERE id = (SELECT id FROM Users WHERE uid = ?) AND date > ? AND date < DATE('now')
+    ), periods(period) AS (VALUES (0), (1), (2))
+    INSERT INTO UserStatsRollup (user_id, period, start, cards_seen, pressed_again, pressed_hard,
+                                 pressed_good, pressed_easy, time_spent_seconds, times_used)
+    SELECT d.id, p.period,
+           CASE p.period WHEN 0 THEN DATE(d.date, 'weekday 0', '-6 days')
+                             WHEN 1 THEN DATE(d.date, 'start of month') ELSE '' END AS start,
+           COALESCE(SUM(d.cards_seen), 0), COALESCE(SUM(d.pressed_again), 0), COALESCE(SUM(d.pressed_hard), 0),
+           COALESCE(SUM(d.pressed_good), 0), COALESCE(SUM(d.pressed_easy), 0),
+           COALESCE(SUM(d.time_spent_seconds), 0), COALESCE(SUM(d.times_used), 0)
+    FROM days d CROSS JOIN periods p
+    WHERE true
+    GROUP BY d.id, p.period, start
+    ON CONFLICT(user_id, period, start) DO UPDATE SET
+        cards_seen = cards_seen + excluded.cards_seen,
+        pressed_again = pressed_again + excluded.pressed_again,
+        pressed_hard = pressed_hard + excluded.pressed_hard,
+        pressed_good = pressed_good + excluded.pressed_good,
+        pressed_easy = pressed_easy + excluded.pressed_easy,
+        time_spent_seconds = time_spent_seconds + excluded.time_spent_seconds,
+        times_used = times_used + excluded.times_used
+)";
+
+inline auto ROLL_UP_DECK_STATS = R"(
+    WITH days AS (
+        SELECT * FROM DeckStats
+        WHERE user_id = (SELECT id FROM Users WHERE uid = ?) AND date > ? AND date < DATE('now')
+    ), periods(period) AS (VALUES (0), (1), (2))
+    INSERT INTO DeckStatsRollup (user_id, deck_id, period, start, cards_added, cards_seen, time_spent_seconds)
+    SELECT d.user_id, d.id, p.period,
+           CASE p.period WHEN 0 THEN DATE(d.date, 'weekday 0', '-6 days')
+                             WHEN 1 THEN DATE(d.date, 'start of month') ELSE '' END AS start,
+           COALESCE(SUM(d.cards_added), 0), COALESCE(SUM(d.cards_seen), 0), COALESCE(SUM(d.time_spent_seconds), 0)
+    FROM days d CROSS JOIN periods p
+    WHERE true
+    GROUP BY d.user_id, d.id, p.period, start
+    ON CONFLICT(user_id, period, start, deck_id) DO UPDATE SET
+        cards_added = cards_added + excluded.cards_added,
+        cards_seen = cards_seen + excluded.cards_seen,
+        time_spent_seconds = time_spent_seconds + excluded.time_spent_seconds
+)";
+
+inline auto UPSERT_STATS_ROLLUP_STATE = R"(
+    INSERT INTO StatsRollupState (user_id, rolled_through)
+    VALUES ((SELECT id FROM Users WHERE uid = ?), DATE('now', '-1 day'))
+    ON CONFLICT(user_id) DO UPDATE SET rolled_through = excluded.rolled_through
+)";
+
+inline auto SELECT_USER_STATS_ROLLUP = R"(
+    WITH bounds AS (
+        SELECT (SELECT id FROM Users WHERE uid = ?) AS user_id, period,
+               CASE period WHEN 0 THEN DATE('now', 'weekday 0', '-6 days')
+                                   WHEN 1 THEN DATE('now', 'start of month') ELSE '' END AS start
+        FROM (SELECT ? AS period)
+    )
+    SELECT COALESCE(SUM(cards_seen), 0), COALESCE(SUM(pressed_again), 0), COALESCE(SUM(pressed_hard), 0),
+           COALESCE(SUM(pressed_good), 0), COALESCE(SUM(pressed_easy), 0),
+           COALESCE(SUM(time_spent_seconds), 0), COALESCE(SUM(times_used), 0)
+    FROM (
+        SELECT r.cards_seen, r.pressed_again, r.pressed_hard, r.pressed_good, r.pressed_easy,
+               r.time_spent_seconds, r.times_used
+        FROM bounds b
+        INNER JOIN UserStatsRollup r ON r.user_id = b.user_id AND r.period = b.period AND r.start = b.start
+        UNION ALL
+        SELECT s.cards_seen, s.pressed_again, s.pressed_hard, s.pressed_good, s.pressed_easy,
+               s.time_spent_seconds, s.times_used
+        FROM bounds b
+        INNER JOIN UserStats s ON s.id = b.user_id AND s.date = DATE('now')
+    )
+)";
+
+inline auto SELECT_DECK_STATS_ROLLUP = R"(
+    WITH bounds AS (
+        SELECT (SELECT id FROM Users WHERE uid = ?) AS user_id, (SELECT id FROM Decks WHERE uid = ?) AS deck_id,
+               period, CASE period WHEN 0 THEN DATE('now', 'weekday 0', '-6 days')
+                                   WHEN 1 THEN DATE('now', 'start of month') ELSE '' END AS start
+        FROM (SELECT ? AS period)
+    )
+    SELECT COALESCE(SUM(cards_added), 0), COALESCE(SUM(cards_seen), 0), COALESCE(SUM(time_spent_seconds), 0)
+    FROM (
+        SELECT r.cards_added, r.cards_seen, r.time_spent_seconds
+        FROM bounds b
+        INNER JOIN DeckStatsRollup r ON r.user_id = b.user_id AND r.period = b.period AND r.start = b.start
+                                    AND r.deck_id = b.deck_id
+        UNION ALL
+        SELECT s.cards_added, s.cards_seen, s.time_spent_seconds
+        FROM bounds b
+        INNER JOIN DeckStats s ON s.user_id = b.user_id AND s.id = b.deck_id AND s.date = DATE('now')
+    )
+)";
+
+// Every deck of the user together
+inline auto SELECT_USER_DECK_STATS_ROLLUP = R"(
+    WITH bounds AS (
+        SELECT (SELECT id FROM Users WHERE uid = ?) AS user_id, period,
+               CASE period WHEN 0 THEN DATE('now', 'weekday 0', '-6 days')
+                                   WHEN 1 THEN DATE('now', 'start of month') ELSE '' END AS start
+        FROM (SELECT ? AS period)
+    )
+    SELECT COALESCE(SUM(cards_added), 0), COALESCE(SUM(cards_seen), 0), COALESCE(SUM(time_spent_seconds), 0)
+    FROM (
+        SELECT r.cards_added, r.cards_seen, r.time_spent_seconds
+        FROM bounds b
+        INNER JOIN DeckStatsRollup r ON r.user_id = b.user_id AND r.period = b.period AND r.start = b.start
+        INNER JOIN UsersDecks ud ON ud.user_id = r.user_id AND ud.deck_id = r.deck_id
+        UNION ALL
+        SELECT s.cards_added, s.cards_seen, s.time_spent_seconds
+        FROM bounds b
+        CROSS JOIN UsersDecks ud ON ud.user_id = b.user_id
+        CROSS JOIN DeckStats s ON s.user_id = ud.user_id AND s.id = ud.deck_id AND s.date = DATE('now')
+    )
+)";
+
+// Same sums for each deck of the user, keyed by deck ID
+inline auto SELECT_DECK_STATS_ROLLUP_BY_DECK = R"(
+    WITH bounds AS (
+        SELECT (SELECT id FROM Users WHERE uid = ?) AS user_id, period,
+               CASE period WHEN 0 THEN DATE('now', 'weekday 0', '-6 days')
+                                   WHEN 1 THEN DATE('now', 'start of month') ELSE '' END AS start
+        FROM (SELECT ? AS period)
+    )
+    SELECT d.uid, COALESCE(SUM(t.cards_added), 0), COALESCE(SUM(t.cards_seen), 0), COALESCE(SUM(t.time_spent_seconds), 0)
+    FROM (
+        SELECT r.deck_id, r.cards_added, r.cards_seen, r.time_spent_seconds
+        FROM bounds b
+        INNER JOIN DeckStatsRollup r ON r.user_id = b.user_id AND r.period = b.period AND r.start = b.start
+        INNER JOIN UsersDecks ud ON ud.user_id = r.user_id AND ud.deck_id = r.deck_id
+        UNION ALL
+        SELECT s.id, s.cards_added, s.cards_seen, s.time_spent_seconds
+        FROM bounds b
+        CROSS JOIN UsersDecks ud ON ud.user_id = b.user_id
+        CROSS JOIN DeckStats s ON s.user_id = ud.user_id AND s.id = ud.deck_id AND s.date = DATE('now')
+    ) t
+    INNER JOIN Decks d ON d.id = t.deck_id
+    GROUP BY t.deck_id
+)";
+
+#endif
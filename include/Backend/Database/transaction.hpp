@@ -0,0 +1,32 @@
+#ifndef TRANSACTION_HPP
+#define TRANSACTION_HPP
+
+#include <QString>
+#include <QSqlDatabase>
+
+// Unit of work on one connection
+// Begins on construction and rolls back on destruction unless commit() succeeded,
+// so every early return undoes the partial writes.
+// Scopes opened inside another one on the same thread become savepoints.
+class Transaction {
+private:
+    QSqlDatabase db;
+    QString savepoint; // Empty for the outermost scope
+    bool active = false;
+
+    bool exec(const QString& sql) const;
+
+public:
+    explicit Transaction(const QSqlDatabase& db);
+    ~Transaction();
+
+    Transaction(const Transaction&) = delete;
+    Transaction& operator=(const Transaction&) = delete;
+
+    // False when BEGIN failed, nothing should be written then
+    bool isActive() const;
+    bool commit();
+    void rollback();
+};
+
+#endif
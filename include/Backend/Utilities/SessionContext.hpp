@@ -0,0 +1,39 @@
+#ifndef SESSIONCONTEXT_HPP
+#define SESSIONCONTEXT_HPP
+
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <QString>
+
+#include "Backend/Classes/Base/Algorithm.hpp"
+
+// Settings row of one deck
+struct DeckSettings {
+    int daily_new_card_limit = 20;
+    int max_review_cards = 100;
+    AlgorithmID algorithm = AlgorithmID::SM2;
+};
+
+// In-memory state of the running session
+// The selected user and the settings of every deck used so far are read from the database
+// once and shared by all threads. Code that writes them calls the matching invalidate function.
+class SessionContext {
+public:
+    // Public ID of the selected user, empty when no user is selected
+    static QString getUserID();
+    // Nothing when the deck has no settings row
+    static std::optional<DeckSettings> getDeckSettings(const QString& deckID);
+
+    static void invalidateUser();
+    static void invalidateDeck(const QString& deckID);
+    static void clear();
+
+private:
+    static std::mutex mutex;
+    static QString userID; // Empty until loaded
+    static std::unordered_map<QString, DeckSettings> decks;
+};
+
+#endif
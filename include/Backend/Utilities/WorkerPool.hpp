@@ -0,0 +1,59 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include <QtGlobal>
+
+class QThread;
+
+// Fixed set of threads for CPU-bound work split in chunks
+// run() cuts [0, count) into chunks of grain items, every thread claims the next free chunk
+// from a shared cursor until none is left, so long chunks never hold up the others.
+// The calling thread works along as worker 0 and run() returns once every chunk is done.
+// Chunk i always covers the same items, results stored per chunk sum up the same way
+// whatever thread ran them.
+class WorkerPool {
+public:
+    // begin and end index the items, worker is in [0, size())
+    using Task = std::function<void(int worker, size_t begin, size_t end)>;
+
+private:
+    std::vector<QThread*> threads;
+
+    std::mutex mutex;
+    std::condition_variable wake; // Workers wait for the next run() or the destructor
+    std::condition_variable done; // run() waits for the workers to leave the current task
+    quint64 generation = 0;       // Bumped by every run()
+    int busy = 0;                 // Workers inside the current task
+    bool stopping = false;
+
+    const Task* task = nullptr;
+    size_t count = 0;
+    size_t grain = 1;
+    std::atomic<size_t> cursor = 0;
+
+    void loop(int worker);
+    void work(int worker);
+
+public:
+    // 0 threads uses one per core
+    explicit WorkerPool(int threads = 0);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Threads including the caller
+    int size() const;
+
+    static size_t chunks(size_t count, size_t grain);
+    // Not reentrant, one run() at a time
+    void run(size_t count, size_t grain, const Task& task);
+};
+
+#endif
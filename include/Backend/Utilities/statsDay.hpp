@@ -0,0 +1,20 @@
+#ifndef STATSDAY_HPP
+#define STATSDAY_HPP
+
+#include <QDate>
+#include <QDateTime>
+#include <QTimeZone>
+
+// Day of SQLite's DATE('now'), which is a UTC day
+// Daily stats rows, deck counters and answers studied today are all kept by it in SQL,
+// so code that compares or buckets days in C++ uses the same one.
+inline QDate statsToday() {
+    return QDateTime::currentDateTimeUtc().date();
+}
+
+// Day of a time in milliseconds since epoch
+inline QDate statsDayOf(const qint64 milliseconds) {
+    return QDateTime::fromMSecsSinceEpoch(milliseconds, QTimeZone::utc()).date();
+}
+
+#endif
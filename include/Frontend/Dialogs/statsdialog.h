@@ -4,6 +4,11 @@
 #include <QDialog>
 
 #include "Backend/Classes/Stats/UserStats.hpp"
+#include "Backend/Classes/AnswerTimes.hpp"
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Classes/Heatmap.hpp"
+
+class User;
 
 namespace Ui {
 class StatsDialog;
@@ -21,9 +26,16 @@ private:
     Ui::StatsDialog *ui;
 
     void populateUserData(const UserStats& stats);
-    void populateDeckData();
+    void populateDeckData(const QString& userID);
+    void populateForecast(const User& user);
+    void showForecast(const Forecast::Histogram& days);
+    void populateHeatmap(const QString& userID);
+    void showHeatmap(const Heatmap::Snapshot& snapshot, int year);
+    void populateAnswerTimes(const User& user);
+    void showAnswerTimes(const AnswerTimes::Histogram& histogram);
 
     QString formatDuration(qint64 seconds);
+    QString formatAnswerTime(qint64 milliseconds);
     QString formatNumber(int number);
 };
 
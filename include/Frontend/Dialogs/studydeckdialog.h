@@ -2,6 +2,7 @@
 #define STUDYDECKDIALOG_H
 
 #include <QDialog>
+#include <QStringList>
 
 #include "Frontend/mainwindow.h"
 
@@ -18,7 +19,8 @@ public:
     ~StudyDeckDialog();
 
 signals:
-    void studySessionRequested(const QString& deckID);
+    // Empty list for every deck
+    void studySessionRequested(const QStringList& deckIDs);
 
 private slots:
     void on_buttonBox_accepted();
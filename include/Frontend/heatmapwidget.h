@@ -0,0 +1,36 @@
+#ifndef HEATMAPWIDGET_H
+#define HEATMAPWIDGET_H
+
+#include <QWidget>
+
+#include "Backend/Classes/Heatmap.hpp"
+
+// Review calendar of one year, a column per week and a cell per day shaded by reviews
+class HeatmapWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit HeatmapWidget(QWidget *parent = nullptr);
+
+    void setHeatmap(const Heatmap::Snapshot& snapshot, int year);
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    bool event(QEvent *event) override; // Tooltips
+
+private:
+    Heatmap::Snapshot snapshot;
+    int year;
+    quint32 maxReviews = 0; // Busiest day of the year, for the shades
+
+    int cellSize() const;
+    // Week column and weekday row of the day, Monday first
+    QPoint cellOf(const QDate& date) const;
+    QRect cellRect(const QDate& date) const;
+    QDate dateAt(const QPoint& pos) const; // Invalid between cells
+};
+
+#endif // HEATMAPWIDGET_H
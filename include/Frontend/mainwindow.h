@@ -2,13 +2,18 @@
 #define MAINWINDOW_H
 
 #include <qpushbutton.h>
+#include <optional>
 #include <vector>
 
 #include <QMainWindow>
+#include <QPointer>
+#include <QThread>
 #include <QWidget>
 #include <QResizeEvent>
 
 #include "Backend/Classes/Deck.hpp"
+#include "Backend/Classes/StudySession.hpp"
+#include "Backend/Database/counters.hpp"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -28,6 +33,9 @@ public:
     QString getCurrentDeck() const;
     void setCurrentDeck(const QString &deckID);
 
+    // Blocks until a running FSRS fit is done, call before the database goes away
+    void waitForOptimizer();
+
 private slots:
     void on_DecksButton_clicked();
     void on_CreateDeckButton_clicked();
@@ -39,10 +47,12 @@ private slots:
     void onRowHovered(int row);
     void onRowLeft(int row);
 
-    void startStudySession(const QString& deckID);
+    void startStudySession(const QStringList& deckIDs);
 
     void on_actionStudy_Deck_triggered();
 
+    void on_actionOptimize_FSRS_triggered();
+
     void on_actionPreferences_triggered();
 
     void on_actionGuide_triggered();
@@ -75,8 +85,15 @@ private:
 
     // Helper Methods
     void showDeckInfo(const Deck& deck);
-    void insertTableRow(const Deck& deck, const int& row, const bool& insert_default_values);
+    void insertTableRow(const Deck& deck, const int& row, const bool& insert_default_values, const DeckCounts& counts = {});
     bool updateTableRow(const QString& id);
+    void refreshTableCounts(int row, const QString& deckID);
+    void refreshDeckCounts(const QString& deckID); // Every row when the ID is empty
+    void showBrowsingPresence();
+
+    // Bulk rescheduling
+    std::optional<int> askForDays(const QString& title, const QString& message);
+    void reportReschedule(int changed, int row, const QString& deckID);
 
     void proceedToNextCard();
 
@@ -85,9 +102,11 @@ private:
     class AboutDialog* aboutDialog = nullptr;
 
     QString currentDeckID;
-    Deck currentDeckObj;
+    StudySession currentSession;
     Card currentCard;
     class QSoundEffect *popSound = nullptr;
+    class QTimer *learningTimer = nullptr;
+    QPointer<QThread> optimizer; // FSRS fit in progress
 
 public:
     Card getCurrentCard() const { return currentCard; }
@@ -0,0 +1,28 @@
+#ifndef STATSNOTIFIER_H
+#define STATSNOTIFIER_H
+
+#include <QObject>
+
+#include "Backend/Classes/StatsService.hpp"
+
+// Qt signals for the changes StatsService reports, open views connect to these to stay current
+class StatsNotifier : public QObject, public StatsListener {
+    Q_OBJECT
+
+public:
+    // Registered with StatsService for as long as the application runs
+    static StatsNotifier* instance();
+
+    void statsChanged(StatsChange change, const QString& deckID) override;
+
+signals:
+    void userStatsChanged();
+    void deckStatsChanged(const QString& deckID);
+    void deckCountsChanged(const QString& deckID); // Empty for every deck
+
+private:
+    explicit StatsNotifier(QObject *parent = nullptr);
+    ~StatsNotifier() override;
+};
+
+#endif // STATSNOTIFIER_H
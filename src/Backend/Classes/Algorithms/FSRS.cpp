@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include <QDateTime>
+#include <QSqlError>
+#include <QStringList>
+
+#include "Backend/Classes/Algorithms/FSRS.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+namespace {
+    constexpr double SECONDS_PER_DAY = 86400.0;
+}
+
+// Define static members
+std::mutex FSRSAlgorithm::mutex;
+std::unordered_map<QString, FSRSAlgorithm::Weights> FSRSAlgorithm::fitted;
+
+FSRSAlgorithm::FSRSAlgorithm(const Weights& weights) : weights(weights) {}
+
+int FSRSAlgorithm::intervalFor(const double stability) {
+    const double days = stability / FACTOR * (std::pow(DESIRED_RETENTION, 1.0 / DECAY) - 1.0);
+    return static_cast<int>(std::lround(std::clamp(days, 1.0, static_cast<double>(MAX_INTERVAL))));
+}
+
+void FSRSAlgorithm::review(const Weights& w, float& stability, float& difficulty, int& interval, int& repetitions,
+                           const double elapsedDays, const int button) {
+    Memory<double> memory;
+    if (stability > 0) {
+        memory = next(w, Memory<double>{ stability, difficulty }, elapsedDays, button);
+    } else if (interval > 0) {
+        // Scheduled by another algorithm so far, its interval is the best guess of the stability
+        const Memory<double> seeded = { static_cast<double>(interval), first<double>(w, 3).difficulty };
+        memory = next(w, seeded, elapsedDays, button);
+    } else {
+        memory = first<double>(w, button);
+    }
+
+    stability = static_cast<float>(memory.stability);
+    difficulty = static_cast<float>(memory.difficulty);
+
+    // Again goes back to the learning steps like with the other algorithms
+    interval = button == 1 ? 0 : intervalFor(memory.stability);
+    repetitions = button == 1 ? 0 : repetitions + 1;
+}
+
+void FSRSAlgorithm::calculateInterval(CardState& state, const int buttonPressed, const AnswerContext& context) {
+    if (buttonPressed < 1 || buttonPressed > 4) {
+        Logger::warn("Invalid button pressed", "FSRS");
+        return;
+    }
+
+    const qint64 reviewedAt = context.reviewed_at > 0 ? context.reviewed_at : QDateTime::currentSecsSinceEpoch();
+    const double elapsedDays = state.last_seen > 0 ? std::max(0.0, (reviewedAt - state.last_seen) / SECONDS_PER_DAY) : 0.0;
+
+    int repetitions = state.repetitions;
+    review(weights ? *weights : weightsFor(context.user_id), state.stability, state.difficulty, state.interval, repetitions,
+           elapsedDays, buttonPressed);
+    state.repetitions = static_cast<quint16>(repetitions);
+}
+
+// exp and log per card, the loop does not vectorize and needs no kernel clones
+void FSRSAlgorithm::calculateBatch(StateBatch& batch, const std::span<const quint8> buttons) const {
+    const Weights& w = weights ? *weights : DEFAULT_WEIGHTS;
+    const size_t count = std::min(batch.size(), buttons.size());
+
+    for (size_t i = 0; i < count; ++i) {
+        if (buttons[i] < 1 || buttons[i] > 4) continue;
+        review(w, batch.stability[i], batch.difficulty[i], batch.interval[i], batch.repetitions[i],
+               batch.elapsed_days[i], buttons[i]);
+    }
+}
+
+FSRSAlgorithm::Weights FSRSAlgorithm::weightsFor(const QString& userID) {
+    if (userID.isEmpty()) return DEFAULT_WEIGHTS;
+
+    std::lock_guard lock(mutex);
+    const auto it = fitted.find(userID);
+    if (it != fitted.end()) return it->second;
+
+    const auto query = Database::getInstance()->statement(SELECT_FSRS_WEIGHTS);
+    query->bindValue(0, userID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to load FSRS weights: " + query->lastError().text(), "FSRS");
+        return DEFAULT_WEIGHTS;
+    }
+
+    Weights weights = DEFAULT_WEIGHTS;
+    if (query->next()) {
+        if (const std::optional<Weights> stored = fromText(query->value(0).toString())) {
+            weights = *stored;
+        } else {
+            Logger::warn("Stored FSRS weights of user " + userID + " are invalid, using the defaults", "FSRS");
+        }
+    }
+
+    fitted.emplace(userID, weights);
+    return weights;
+}
+
+bool FSRSAlgorithm::saveWeights(const QString& userID, const Weights& weights, const int reviews, const double logLoss) {
+    const auto query = Database::getInstance()->statement(UPSERT_FSRS_WEIGHTS);
+    query->bindValue(0, userID);
+    query->bindValue(1, toText(weights));
+    query->bindValue(2, reviews);
+    query->bindValue(3, logLoss);
+    query->bindValue(4, QDateTime::currentSecsSinceEpoch());
+
+    if (!query->exec()) {
+        Logger::error("Failed to save FSRS weights: " + query->lastError().text(), "FSRS");
+        return false;
+    }
+
+    std::lock_guard lock(mutex);
+    fitted[userID] = weights;
+    return true;
+}
+
+QString FSRSAlgorithm::toText(const Weights& weights) {
+    QStringList values;
+    for (const double weight : weights) values.append(QString::number(weight, 'g', 17));
+    return values.join(' ');
+}
+
+std::optional<FSRSAlgorithm::Weights> FSRSAlgorithm::fromText(const QString& text) {
+    const QStringList values = text.split(' ', Qt::SkipEmptyParts);
+    if (values.size() != WEIGHT_COUNT) return std::nullopt;
+
+    Weights weights{};
+    for (int i = 0; i < WEIGHT_COUNT; ++i) {
+        bool valid = false;
+        weights[i] = values[i].toDouble(&valid);
+        if (!valid) return std::nullopt;
+    }
+    return weights;
+}
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "Backend/Classes/Algorithms/FSRSOptimizer.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+#include "Backend/Utilities/WorkerPool.hpp"
+
+namespace {
+    constexpr int N = FSRSAlgorithm::WEIGHT_COUNT;
+    constexpr double MS_PER_DAY = 86400000.0;
+    constexpr double MIN_ELAPSED_DAYS = 1.0; // Same-day answers are learning steps, the model predicts days
+    constexpr double EPSILON = 1e-4;         // Keeps the log loss finite
+
+    // Range every weight is kept in while fitting
+    constexpr FSRSAlgorithm::Weights LOWER = { 0.1, 0.1, 0.1, 0.1, 1.0, 0.1, 0.1, 0.0, 0.0, 0.1, 0.01, 0.5, 0.01, 0.01, 0.01, 0.0, 1.0 };
+    constexpr FSRSAlgorithm::Weights UPPER = { 100, 100, 100, 100, 10.0, 5.0, 5.0, 0.5, 3.0, 0.8, 2.5, 5.0, 0.2, 0.9, 2.0, 1.0, 4.0 };
+
+    // Value and its derivative with respect to every weight (forward-mode automatic differentiation)
+    struct Dual {
+        double value = 0;
+        std::array<double, N> grad{};
+
+        Dual() = default;
+        Dual(const double value) : value(value) {}
+
+        static Dual weight(const double value, const int index) {
+            Dual result(value);
+            result.grad[index] = 1.0;
+            return result;
+        }
+
+        friend Dual operator+(const Dual& a, const Dual& b) {
+            Dual result(a.value + b.value);
+            for (int i = 0; i < N; ++i) result.grad[i] = a.grad[i] + b.grad[i];
+            return result;
+        }
+        friend Dual operator+(const Dual& a, const double b) {
+            Dual result = a;
+            result.value += b;
+            return result;
+        }
+        friend Dual operator+(const double a, const Dual& b) { return b + a; }
+
+        friend Dual operator-(const Dual& a) {
+            Dual result(-a.value);
+            for (int i = 0; i < N; ++i) result.grad[i] = -a.grad[i];
+            return result;
+        }
+        friend Dual operator-(const Dual& a, const Dual& b) {
+            Dual result(a.value - b.value);
+            for (int i = 0; i < N; ++i) result.grad[i] = a.grad[i] - b.grad[i];
+            return result;
+        }
+        friend Dual operator-(const Dual& a, const double b) { return a + -b; }
+        friend Dual operator-(const double a, const Dual& b) { return -b + a; }
+
+        friend Dual operator*(const Dual& a, const Dual& b) {
+            Dual result(a.value * b.value);
+            for (int i = 0; i < N; ++i) result.grad[i] = a.grad[i] * b.value + b.grad[i] * a.value;
+            return result;
+        }
+        friend Dual operator*(const Dual& a, const double b) {
+            Dual result(a.value * b);
+            for (int i = 0; i < N; ++i) result.grad[i] = a.grad[i] * b;
+            return result;
+        }
+        friend Dual operator*(const double a, const Dual& b) { return b * a; }
+
+        friend Dual operator/(const Dual& a, const Dual& b) {
+            Dual result(a.value / b.value);
+            for (int i = 0; i < N; ++i) result.grad[i] = (a.grad[i] - result.value * b.grad[i]) / b.value;
+            return result;
+        }
+        friend Dual operator/(const double a, const Dual& b) {
+            Dual result(a / b.value);
+            for (int i = 0; i < N; ++i) result.grad[i] = -result.value * b.grad[i] / b.value;
+            return result;
+        }
+
+        friend Dual exp(const Dual& a) {
+            Dual result(std::exp(a.value));
+            for (int i = 0; i < N; ++i) result.grad[i] = a.grad[i] * result.value;
+            return result;
+        }
+        friend Dual log(const Dual& a) {
+            Dual result(std::log(a.value));
+            for (int i = 0; i < N; ++i) result.grad[i] = a.grad[i] / a.value;
+            return result;
+        }
+
+        friend bool operator<(const Dual& a, const Dual& b) { return a.value < b.value; }
+        friend bool operator<(const Dual& a, const double b) { return a.value < b; }
+        friend bool operator>(const Dual& a, const double b) { return a.value > b; }
+    };
+
+    // Loss summed over one chunk of cards
+    template <typename T>
+    struct Partial {
+        T loss{};
+        int predictions = 0;
+    };
+
+    template <typename T>
+    T probability(const T& r) {
+        return r < EPSILON ? T(EPSILON) : r > 1.0 - EPSILON ? T(1.0 - EPSILON) : r;
+    }
+
+    // Replays the answers of one card, adding the loss of every prediction
+    template <typename T, typename W>
+    void replay(const FSRSOptimizer::History& history, const size_t card, const W& w, Partial<T>& partial) {
+        using std::log;
+        const quint32 begin = history.offsets[card];
+        const quint32 end = history.offsets[card + 1];
+
+        FSRSAlgorithm::Memory<T> memory = FSRSAlgorithm::first<T>(w, history.buttons[begin]);
+        for (quint32 i = begin + 1; i < end; ++i) {
+            const double elapsed = history.elapsed_days[i];
+            const int button = history.buttons[i];
+
+            if (elapsed >= MIN_ELAPSED_DAYS) {
+                const T r = probability(FSRSAlgorithm::retrievability(elapsed, memory.stability));
+                partial.loss = partial.loss - (button > 1 ? log(r) : log(1.0 - r));
+                ++partial.predictions;
+            }
+            memory = FSRSAlgorithm::next(w, memory, elapsed, button);
+        }
+    }
+
+    // Cards of a mini-batch, consecutive in a shuffled order, with about batchReviews answers
+    std::vector<std::pair<size_t, size_t>> cutBatches(const FSRSOptimizer::History& history,
+                                                      const std::vector<quint32>& order, const size_t batchReviews) {
+        std::vector<std::pair<size_t, size_t>> batches;
+        size_t begin = 0, reviews = 0;
+        for (size_t i = 0; i < order.size(); ++i) {
+            reviews += history.offsets[order[i] + 1] - history.offsets[order[i]];
+            if (reviews >= batchReviews || i + 1 == order.size()) {
+                batches.emplace_back(begin, i + 1);
+                begin = i + 1;
+                reviews = 0;
+            }
+        }
+        return batches;
+    }
+}
+
+void FSRSOptimizer::History::add(const qint64 cardID, const qint64 reviewedAtMs, const int button) {
+    if (cardID != lastCard) {
+        offsets.push_back(offsets.back());
+        elapsed_days.push_back(0.0f);
+        lastCard = cardID;
+    } else {
+        elapsed_days.push_back(static_cast<float>(std::max<qint64>(0, reviewedAtMs - lastTime) / MS_PER_DAY));
+    }
+
+    buttons.push_back(static_cast<quint8>(button));
+    ++offsets.back();
+    lastTime = reviewedAtMs;
+}
+
+FSRSOptimizer::History FSRSOptimizer::read(QSqlQuery& rows) {
+    History history;
+    while (rows.next()) {
+        history.add(rows.value(0).toLongLong(), rows.value(1).toLongLong(), rows.value(2).toInt());
+    }
+    return history;
+}
+
+double FSRSOptimizer::logLoss(const History& history, const FSRSAlgorithm::Weights& weights, WorkerPool& pool, int& predictions) {
+    std::vector<Partial<double>> partials(WorkerPool::chunks(history.cards(), CARDS_PER_CHUNK));
+
+    pool.run(history.cards(), CARDS_PER_CHUNK, [&](int, const size_t begin, const size_t end) {
+        Partial<double>& partial = partials[begin / CARDS_PER_CHUNK];
+        for (size_t card = begin; card < end; ++card) replay(history, card, weights, partial);
+    });
+
+    double loss = 0;
+    predictions = 0;
+    for (const Partial<double>& partial : partials) {
+        loss += partial.loss;
+        predictions += partial.predictions;
+    }
+    return predictions > 0 ? loss / predictions : 0.0;
+}
+
+double FSRSOptimizer::logLoss(const History& history, const FSRSAlgorithm::Weights& weights, const int threads) {
+    WorkerPool pool(threads);
+    int predictions = 0;
+    return logLoss(history, weights, pool, predictions);
+}
+
+FSRSOptimizer::Result FSRSOptimizer::fit(const History& history, const int threads) {
+    QElapsedTimer timer;
+    timer.start();
+
+    WorkerPool pool(threads);
+
+    Result result;
+    result.weights = FSRSAlgorithm::DEFAULT_WEIGHTS;
+    result.log_loss_before = logLoss(history, result.weights, pool, result.reviews);
+
+    // Adam state
+    std::array<double, N> m{}, v{};
+    constexpr double BETA1 = 0.9, BETA2 = 0.999, ADAM_EPSILON = 1e-8;
+    int step = 0;
+
+    // Small collections still get a few dozen steps per epoch
+    const size_t batchReviews = std::clamp(history.reviews() / 64, MIN_BATCH_REVIEWS, MAX_BATCH_REVIEWS);
+
+    std::vector<quint32> order(history.cards());
+    std::iota(order.begin(), order.end(), 0);
+    std::mt19937 random(5489); // Fixed seed, the same history always gives the same weights
+
+    for (int epoch = 0; epoch < EPOCHS; ++epoch) {
+        std::shuffle(order.begin(), order.end(), random);
+
+        for (const auto& [first, last] : cutBatches(history, order, batchReviews)) {
+            std::array<Dual, N> w;
+            for (int i = 0; i < N; ++i) w[i] = Dual::weight(result.weights[i], i);
+
+            std::vector<Partial<Dual>> partials(WorkerPool::chunks(last - first, CARDS_PER_CHUNK));
+            pool.run(last - first, CARDS_PER_CHUNK, [&](int, const size_t begin, const size_t end) {
+                Partial<Dual>& partial = partials[begin / CARDS_PER_CHUNK];
+                for (size_t i = begin; i < end; ++i) replay(history, order[first + i], w, partial);
+            });
+
+            Partial<Dual> batch;
+            for (const Partial<Dual>& partial : partials) {
+                batch.loss = batch.loss + partial.loss;
+                batch.predictions += partial.predictions;
+            }
+            if (batch.predictions == 0) continue;
+
+            ++step;
+            const double correction1 = 1.0 - std::pow(BETA1, step);
+            const double correction2 = 1.0 - std::pow(BETA2, step);
+            for (int i = 0; i < N; ++i) {
+                const double gradient = batch.loss.grad[i] / batch.predictions;
+                m[i] = BETA1 * m[i] + (1.0 - BETA1) * gradient;
+                v[i] = BETA2 * v[i] + (1.0 - BETA2) * gradient * gradient;
+
+                const double update = LEARNING_RATE * (m[i] / correction1) / (std::sqrt(v[i] / correction2) + ADAM_EPSILON);
+                result.weights[i] = std::clamp(result.weights[i] - update, LOWER[i], UPPER[i]);
+            }
+        }
+    }
+
+    result.log_loss_after = logLoss(history, result.weights, pool, result.reviews);
+    result.elapsed_ms = timer.elapsed();
+    return result;
+}
+
+std::optional<FSRSOptimizer::Result> FSRSOptimizer::optimize(const QString& userID) {
+    if (userID.isEmpty()) return std::nullopt;
+
+    // Answers still queued belong to the history
+    if (!ReviewCommitter::getInstance()->flush()) {
+        Logger::warn("Queued answers could not be saved, fitting without them", "FSRS");
+    }
+
+    History history;
+    {
+        const auto query = Database::getInstance()->statement(SELECT_REVIEW_HISTORY);
+        query->setForwardOnly(true);
+        query->bindValue(0, userID);
+
+        if (!query->exec()) {
+            Logger::error("Failed to read the review history: " + query->lastError().text(), "FSRS");
+            return std::nullopt;
+        }
+        history = read(*query);
+    }
+
+    const FSRSAlgorithm::Weights current = FSRSAlgorithm::weightsFor(userID);
+    WorkerPool pool;
+    int predictions = 0;
+    const double currentLoss = logLoss(history, current, pool, predictions);
+
+    if (predictions < MIN_REVIEWS) {
+        Logger::info(QString("Only %1 answers to learn from, FSRS weights kept").arg(predictions), "FSRS");
+        return std::nullopt;
+    }
+
+    Result result = fit(history);
+    Logger::info(QString("FSRS weights fitted on %1 answers in %2 ms, log loss %3 -> %4")
+                 .arg(QString::number(result.reviews), QString::number(result.elapsed_ms),
+                      QString::number(currentLoss, 'f', 4), QString::number(result.log_loss_after, 'f', 4)), "FSRS");
+
+    if (result.log_loss_after < currentLoss) {
+        if (!FSRSAlgorithm::saveWeights(userID, result.weights, result.reviews, result.log_loss_after)) return std::nullopt;
+        result.saved = true;
+    }
+    return result;
+}
@@ -2,22 +2,25 @@
 // Created by TehPig on 1/13/2025.
 //
 
-#include "Backend/Classes/Stats/CardStats.hpp"
+#include <algorithm>
+
+#include <QDebug>
+
 #include "Backend/Classes/Algorithms/Leitner.hpp"
 
-void LeitnerAlgorithm::calculateInterval(CardStats& stats, int buttonPressed) {
+void LeitnerAlgorithm::calculateInterval(CardState& state, int buttonPressed, const AnswerContext&) {
     switch (buttonPressed) {
         case 1: // Again
-            stats.setInterval(stats.getInterval() * 0.3);
+            state.interval = toInterval(state.interval * 0.3);
             break;
         case 2: // Hard
-            stats.setInterval(stats.getInterval() * 0.6);
+            state.interval = toInterval(state.interval * 0.6);
             break;
         case 3: // Good
-            stats.setInterval(stats.getInterval() * 1.7);
+            state.interval = toInterval(state.interval * 1.7);
             break;
         case 4: // Easy
-            stats.setInterval(stats.getInterval() * 2.0);
+            state.interval = toInterval(state.interval * 2.0);
             break;
 
         // If no valid button number is specified, print an error message
@@ -25,4 +28,22 @@ void LeitnerAlgorithm::calculateInterval(CardStats& stats, int buttonPressed) {
             qDebug() << "[Leitner] Invalid button pressed.";
             break;
     }
-}
\ No newline at end of file
+}
+
+namespace {
+    // The answered button's factor is selected, see the SM2 kernel
+    MINDLEAP_BATCH_KERNEL
+    void leitnerKernel(int* __restrict interval, const quint8* __restrict buttons, const size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const int button = buttons[i];
+            const double factor = button == 1 ? 0.3 : button == 2 ? 0.6 : button == 3 ? 1.7 : 2.0;
+
+            // Invalid buttons keep the interval
+            interval[i] = button >= 1 && button <= 4 ? toInterval(interval[i] * factor) : interval[i];
+        }
+    }
+}
+
+void LeitnerAlgorithm::calculateBatch(StateBatch& batch, const std::span<const quint8> buttons) {
+    leitnerKernel(batch.interval.data(), buttons.data(), std::min(batch.size(), buttons.size()));
+}
@@ -0,0 +1,74 @@
+#include <array>
+
+#include "Backend/Classes/Algorithms/Registry.hpp"
+
+namespace {
+    // One instance each shared by all threads, none keeps state between answers
+    std::array<Algorithms::Any, Algorithms::COUNT> registry = {
+        Algorithms::Any(std::in_place_type<SM2Algorithm>),
+        Algorithms::Any(std::in_place_type<LeitnerAlgorithm>),
+        Algorithms::Any(std::in_place_type<FSRSAlgorithm>)
+    };
+
+    const std::array<QString, Algorithms::COUNT> names = {
+        QStringLiteral("SM2"),
+        QStringLiteral("Leitner"),
+        QStringLiteral("FSRS")
+    };
+
+    template <typename T>
+    constexpr bool registeredInOrder() {
+        return std::variant_alternative_t<static_cast<size_t>(T::ID), Algorithms::Any>::ID == T::ID;
+    }
+
+    static_assert(registeredInOrder<SM2Algorithm>() && registeredInOrder<LeitnerAlgorithm>() &&
+                  registeredInOrder<FSRSAlgorithm>(),
+                  "Algorithms::Any must list the algorithms in AlgorithmID order");
+}
+
+namespace Algorithms {
+    std::optional<AlgorithmID> fromName(const QString& name) {
+        for (size_t i = 0; i < names.size(); ++i) {
+            if (names[i].compare(name, Qt::CaseInsensitive) == 0) return static_cast<AlgorithmID>(i);
+        }
+        return std::nullopt;
+    }
+
+    QString name(const AlgorithmID id) {
+        return names[static_cast<size_t>(id)];
+    }
+
+    const Any& get(const AlgorithmID id) {
+        return registry[static_cast<size_t>(id)];
+    }
+
+    unsigned changes(const AlgorithmID id) {
+        return std::visit([](const auto& algorithm) { return std::decay_t<decltype(algorithm)>::CHANGES; }, get(id));
+    }
+
+    void calculateInterval(const AlgorithmID id, CardState& state, const int buttonPressed, const AnswerContext& context) {
+#ifndef NDEBUG
+        const CardState before = state;
+#endif
+
+        std::visit([&](auto& algorithm) { algorithm.calculateInterval(state, buttonPressed, context); },
+                   registry[static_cast<size_t>(id)]);
+
+#ifndef NDEBUG
+        // The algorithm keeps to the fields it declares
+        const unsigned declared = changes(id);
+        Q_ASSERT((declared & StateField::Interval) || state.interval == before.interval);
+        Q_ASSERT((declared & StateField::EaseFactor) || state.ease_factor == before.ease_factor);
+        Q_ASSERT((declared & StateField::Repetitions) || state.repetitions == before.repetitions);
+        Q_ASSERT((declared & StateField::Stability) || state.stability == before.stability);
+        Q_ASSERT((declared & StateField::Difficulty) || state.difficulty == before.difficulty);
+        Q_ASSERT(state.card_id == before.card_id && state.due == before.due &&
+                 state.last_seen == before.last_seen && state.lapses == before.lapses);
+#endif
+    }
+
+    void calculateBatch(const AlgorithmID id, StateBatch& batch, const std::span<const quint8> buttons) {
+        std::visit([&](auto& algorithm) { algorithm.calculateBatch(batch, buttons); },
+                   registry[static_cast<size_t>(id)]);
+    }
+}
@@ -2,44 +2,79 @@
 // Created by TehPig on 1/13/2025.
 //
 
-#include "Backend/Classes/Stats/CardStats.hpp"
+#include <algorithm>
+
 #include "Backend/Classes/Algorithms/SM2.hpp"
 #include "Backend/Utilities/Logger.hpp"
 
-void SM2Algorithm::calculateInterval(CardStats& stats, int buttonPressed) {
+void SM2Algorithm::calculateInterval(CardState& state, int buttonPressed, const AnswerContext&) {
     const double MIN_EASE_FACTOR = 1.3;
 
     switch (buttonPressed) {
         case 1: // "Again"
-            stats.setRepetitions(0);
-            stats.setEaseFactor(2.5);
-            stats.setInterval(0); // Due immediately
+            state.repetitions = 0;
+            state.ease_factor = 2.5f;
+            state.interval = 0; // Due immediately
             break;
         case 2: // "Hard"
-            stats.setEaseFactor(std::max(MIN_EASE_FACTOR, stats.getEaseFactor() - 0.15));
+            state.ease_factor = static_cast<float>(std::max(MIN_EASE_FACTOR, state.ease_factor - 0.15));
             // If it's the first time, keep it at 0 to see it again soon. Otherwise, scale by 1.2x days.
-            stats.setInterval((stats.getRepetitions() == 0) ? 0 : static_cast<int>(stats.getInterval() * 1.2));
+            state.interval = (state.repetitions == 0) ? 0 : toInterval(state.interval * 1.2);
             break;
         case 3: // "Good"
-            stats.setRepetitions(stats.getRepetitions() + 1);
-            if (stats.getRepetitions() == 1) {
-                stats.setInterval(1); // 1 day
+            ++state.repetitions;
+            if (state.repetitions == 1) {
+                state.interval = 1; // 1 day
             } else {
-                stats.setInterval(std::max(1, static_cast<int>(stats.getInterval() * stats.getEaseFactor())));
+                state.interval = std::max(1, toInterval(state.interval * state.ease_factor));
             }
             break;
         case 4: // "Easy"
-            stats.setRepetitions(stats.getRepetitions() + 1);
+            ++state.repetitions;
             // 4 days for the first time, then scale
-            stats.setInterval(std::max(1, stats.getRepetitions() == 1 ? 4 : static_cast<int>(stats.getInterval() * stats.getEaseFactor() * 1.3)));
-            stats.setEaseFactor(stats.getEaseFactor() + 0.15);
+            state.interval = std::max(1, state.repetitions == 1 ? 4 : toInterval(state.interval * state.ease_factor * 1.3));
+            state.ease_factor = static_cast<float>(state.ease_factor + 0.15);
             break;
 
         default:
             Logger::warn("Invalid button pressed", "SM2");
             break;
     }
+}
+
+namespace {
+    // Every button's result is computed and the answered one selected, the selects compile to
+    // blends so GCC and Clang vectorize the loop as it is. The arithmetic keeps the types of
+    // calculateInterval() so both give the same numbers.
+    MINDLEAP_BATCH_KERNEL
+    void sm2Kernel(int* __restrict interval, float* __restrict ease, int* __restrict repetitions,
+                   const quint8* __restrict buttons, const size_t count) {
+        constexpr double MIN_EASE_FACTOR = 1.3;
+
+        for (size_t i = 0; i < count; ++i) {
+            const int button = buttons[i];
+            const bool again = button == 1, hard = button == 2, good = button == 3, easy = button == 4;
+
+            const int previousInterval = interval[i];
+            const float previousEase = ease[i];
+            const int previousRepetitions = repetitions[i];
+            const bool first = previousRepetitions == 0;
+
+            const int hardInterval = first ? 0 : toInterval(previousInterval * 1.2);
+            const int goodInterval = first ? 1 : std::max(1, toInterval(previousInterval * previousEase));
+            const int easyInterval = std::max(1, first ? 4 : toInterval(previousInterval * previousEase * 1.3));
+
+            const float hardEase = static_cast<float>(std::max(MIN_EASE_FACTOR, previousEase - 0.15));
+            const float easyEase = static_cast<float>(previousEase + 0.15);
+
+            interval[i] = again ? 0 : hard ? hardInterval : good ? goodInterval : easy ? easyInterval : previousInterval;
+            ease[i] = again ? 2.5f : hard ? hardEase : easy ? easyEase : previousEase;
+            repetitions[i] = again ? 0 : good || easy ? previousRepetitions + 1 : previousRepetitions;
+        }
+    }
+}
 
-    Logger::info(QString("Calculated Interval: %1 days (Ease: %2, Reps: %3)")
-                 .arg(QString::number(stats.getInterval()), QString::number(stats.getEaseFactor()), QString::number(stats.getRepetitions())), "SM2");
+void SM2Algorithm::calculateBatch(StateBatch& batch, const std::span<const quint8> buttons) {
+    sm2Kernel(batch.interval.data(), batch.ease_factor.data(), batch.repetitions.data(), buttons.data(),
+              std::min(batch.size(), buttons.size()));
 }
\ No newline at end of file
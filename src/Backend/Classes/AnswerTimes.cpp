@@ -0,0 +1,242 @@
+#include <algorithm>
+#include <cmath>
+
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "Backend/Classes/AnswerTimes.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Database/transaction.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+namespace {
+    void writeVarint(QByteArray& data, quint64 value) {
+        while (value >= 0x80) {
+            data.append(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        data.append(static_cast<char>(value));
+    }
+
+    bool readVarint(const QByteArray& data, qsizetype& position, quint64& value) {
+        value = 0;
+        for (int shift = 0; shift < 64 && position < data.size(); shift += 7) {
+            const auto byte = static_cast<quint8>(data[position++]);
+            value |= static_cast<quint64>(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return true;
+        }
+        return false;
+    }
+}
+
+// Define static members
+std::mutex AnswerTimes::mutex;
+QString AnswerTimes::userID;
+std::unordered_map<QString, AnswerTimes::Histogram> AnswerTimes::decks;
+QString AnswerTimes::pendingUserID;
+std::unordered_map<QString, AnswerTimes::Histogram> AnswerTimes::pending;
+
+int AnswerTimes::Histogram::indexOf(qint64 milliseconds) {
+    milliseconds = std::clamp<qint64>(milliseconds, 0, MAX_MS);
+    if (milliseconds < 2 * SUB_BUCKETS) return static_cast<int>(milliseconds);
+
+    // Keeps the top 7 bits, the first of them is always set
+    const int shift = std::bit_width(static_cast<quint64>(milliseconds)) - 7;
+    return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + static_cast<int>((milliseconds >> shift) - SUB_BUCKETS);
+}
+
+qint64 AnswerTimes::Histogram::lowestOf(const int index) {
+    if (index < 2 * SUB_BUCKETS) return index;
+
+    const int shift = (index - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1;
+    return static_cast<qint64>(SUB_BUCKETS + (index - 2 * SUB_BUCKETS) % SUB_BUCKETS) << shift;
+}
+
+qint64 AnswerTimes::Histogram::widthOf(const int index) {
+    if (index < 2 * SUB_BUCKETS) return 1;
+    return qint64(1) << ((index - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1);
+}
+
+void AnswerTimes::Histogram::record(const qint64 milliseconds, const quint64 count) {
+    counts[indexOf(milliseconds)] += count;
+    answers += count;
+}
+
+void AnswerTimes::Histogram::add(const Histogram& other) {
+    for (int i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+    answers += other.answers;
+}
+
+qint64 AnswerTimes::Histogram::percentile(const double share) const {
+    if (answers == 0) return 0;
+
+    const auto rank = std::max<quint64>(1, static_cast<quint64>(std::ceil(std::clamp(share, 0.0, 1.0) * answers)));
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        // Middle of the bucket
+        if (seen >= rank) return lowestOf(i) + (widthOf(i) - 1) / 2;
+    }
+    return MAX_MS;
+}
+
+QByteArray AnswerTimes::Histogram::encode() const {
+    QByteArray data;
+    data.append(FORMAT);
+
+    int previous = -1;
+    for (int i = 0; i < BUCKETS; ++i) {
+        if (counts[i] == 0) continue;
+        writeVarint(data, i - previous - 1);
+        writeVarint(data, counts[i]);
+        previous = i;
+    }
+    return data;
+}
+
+std::optional<AnswerTimes::Histogram> AnswerTimes::Histogram::decode(const QByteArray& data) {
+    if (data.isEmpty() || data[0] != FORMAT) return std::nullopt;
+
+    Histogram histogram;
+    qsizetype position = 1;
+    qint64 index = -1;
+    while (position < data.size()) {
+        quint64 gap, count;
+        if (!readVarint(data, position, gap) || !readVarint(data, position, count)) return std::nullopt;
+
+        index += static_cast<qint64>(std::min<quint64>(gap, BUCKETS)) + 1;
+        if (index >= BUCKETS) return std::nullopt;
+        histogram.counts[index] += count;
+        histogram.answers += count;
+    }
+    return histogram;
+}
+
+bool AnswerTimes::ensureLoaded(const QString& userID) {
+    if (AnswerTimes::userID == userID) return true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto query = Database::getInstance()->statement(SELECT_ANSWER_TIMES);
+    query->setForwardOnly(true);
+    query->bindValue(0, userID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to read answer times: " + query->lastError().text(), "AnswerTimes");
+        return false;
+    }
+
+    std::unordered_map<QString, Histogram> loaded;
+    while (query->next()) {
+        const std::optional<Histogram> histogram = Histogram::decode(query->value(1).toByteArray());
+        if (!histogram) {
+            Logger::warn("Unreadable answer times of deck " + query->value(0).toString() + ", left out", "AnswerTimes");
+            continue;
+        }
+        loaded.emplace(query->value(0).toString(), *histogram);
+    }
+
+    // Answers not saved yet are only in memory
+    if (pendingUserID == userID) {
+        for (const auto& [deckID, histogram] : pending) loaded[deckID].add(histogram);
+    }
+
+    decks = std::move(loaded);
+    AnswerTimes::userID = userID;
+
+    Logger::info(QString("Answer times loaded in %1 ms").arg(QString::number(timer.elapsed())), "AnswerTimes");
+    return true;
+}
+
+AnswerTimes::Histogram AnswerTimes::forUser(const QString& userID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureLoaded(userID)) return {};
+
+    Histogram total;
+    for (const auto& [deckID, histogram] : decks) total.add(histogram);
+    return total;
+}
+
+AnswerTimes::Histogram AnswerTimes::forDeck(const QString& userID, const QString& deckID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureLoaded(userID)) return {};
+
+    const auto it = decks.find(deckID);
+    return it != decks.end() ? it->second : Histogram{};
+}
+
+void AnswerTimes::cardAnswered(const QString& userID, const QString& deckID, const qint64 milliseconds) {
+    std::lock_guard lock(mutex);
+
+    // Another user's answers are written before this one's start
+    if (pendingUserID != userID) {
+        if (!pending.empty() && !savePending()) {
+            Logger::warn("Answer times of the previous user are lost", "AnswerTimes");
+        }
+        pending.clear();
+        pendingUserID = userID;
+    }
+
+    pending[deckID].record(milliseconds);
+    if (AnswerTimes::userID == userID) decks[deckID].record(milliseconds);
+}
+
+bool AnswerTimes::savePending() {
+    if (pending.empty()) return true;
+    const Database* db = Database::getInstance();
+
+    // The whole histogram of every deck is written, read it first when it is not in memory
+    if (!ensureLoaded(pendingUserID)) return false;
+
+    Transaction transaction(db->getDB());
+    if (!transaction.isActive()) {
+        Logger::error("Could not start a transaction for answer times", "AnswerTimes");
+        return false;
+    }
+
+    for (const auto& [deckID, histogram] : pending) {
+        const auto query = db->statement(UPSERT_ANSWER_TIMES);
+        query->bindValue(0, pendingUserID);
+        query->bindValue(1, deckID);
+        query->bindValue(2, decks[deckID].encode());
+
+        if (!query->exec()) {
+            Logger::error("Failed to save answer times: " + query->lastError().text(), "AnswerTimes");
+            return false;
+        }
+    }
+
+    if (!transaction.commit()) return false;
+    pending.clear();
+    return true;
+}
+
+bool AnswerTimes::save() {
+    std::lock_guard lock(mutex);
+    return savePending();
+}
+
+void AnswerTimes::deckDeleted(const QString& deckID) {
+    std::lock_guard lock(mutex);
+
+    // Its row goes with it
+    decks.erase(deckID);
+    pending.erase(deckID);
+}
+
+void AnswerTimes::invalidate() {
+    std::lock_guard lock(mutex);
+    userID.clear();
+    decks.clear();
+}
+
+void AnswerTimes::clear() {
+    std::lock_guard lock(mutex);
+    userID.clear();
+    decks.clear();
+    pendingUserID.clear();
+    pending.clear();
+}
@@ -5,7 +5,12 @@
 
 #include "Backend/Utilities/generateID.hpp"
 #include "Backend/Classes/Card.hpp"
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Classes/Heatmap.hpp"
+#include "Backend/Classes/StatsService.hpp"
 #include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Database/counters.hpp"
 
 // Constructors
 Card::Card(const QString& id, const QString& q, const QString& a, const CardType& type)
@@ -50,7 +55,7 @@ bool Card::create() {
         cardId = generateID();
         qDebug() << "[Debug - Card] Generated ID" << cardId << "for question" << this->question;
 
-        query.prepare("INSERT INTO Cards (id, question, answer) VALUES (?, ?, ?);");
+        query.prepare("INSERT INTO Cards (uid, question, answer) VALUES (?, ?, ?);");
         query.addBindValue(cardId);
         query.addBindValue(this->question);
         query.addBindValue(this->answer);
@@ -78,10 +83,13 @@ bool Card::_delete() const {
         return false;
     }
 
+    // Counts of the card's decks are recomputed on the next read
+    DeckCounters::invalidateCard(this->id);
+
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare("DELETE FROM Cards WHERE id = ?;");
+    query.prepare("DELETE FROM Cards WHERE uid = ?;");
     query.addBindValue(this->id);
 
     if (!query.exec()) {
@@ -89,6 +97,9 @@ bool Card::_delete() const {
         return false;
     }
 
+    Forecast::invalidate();
+    Heatmap::invalidate(); // Its answers are gone
+    StatsService::cardsChanged();
     return true;
 }
 
@@ -128,22 +139,21 @@ CardType Card::stringToType(const QString& str) {
 
 QString Card::typeToString(CardType type) {
     switch (type) {
-        case CardType::New:      return "New";
-        case CardType::Learning: return "Learning";
-        case CardType::Review:   return "Review";
+        case CardType::New:      return QStringLiteral("New");
+        case CardType::Learning: return QStringLiteral("Learning");
+        case CardType::Review:   return QStringLiteral("Review");
     }
-    return "New";
+    return QStringLiteral("New");
 }
 
 bool Card::saveType() const {
     const Database *db = Database::getInstance();
-    QSqlQuery query(db->getDB());
-    query.prepare("UPDATE Cards SET type = ? WHERE id = ?");
-    query.addBindValue(typeToString(this->type));
-    query.addBindValue(this->id);
+    const auto query = db->statement(UPDATE_CARD_TYPE);
+    query->bindValue(0, typeToString(this->type));
+    query->bindValue(1, this->id);
     
-    if (!query.exec()) {
-        qDebug() << "[DB] Failed to save card type:" << query.lastError().text();
+    if (!query->exec()) {
+        qDebug() << "[DB] Failed to save card type:" << query->lastError().text();
         return false;
     }
     return true;
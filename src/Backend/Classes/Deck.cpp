@@ -1,3 +1,5 @@
+#include <initializer_list>
+#include <limits>
 #include <vector>
 
 #include <QSqlQuery>
@@ -6,13 +8,37 @@
 #include <QString>
 
 #include "Backend/Utilities/Logger.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
 #include "Backend/Classes/Deck.hpp"
+#include "Backend/Classes/AnswerTimes.hpp"
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Classes/Stats/CardState.hpp"
 #include "Backend/Classes/Stats/UserStats.hpp"
+#include "Backend/Classes/StatsService.hpp"
 #include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Database/transaction.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Database/counters.hpp"
+#include "Backend/Database/rollups.hpp"
 #include "Backend/Utilities/statsUpdateContext.hpp"
 #include "Backend/Utilities/createUniqueDeck.hpp"
-#include "Backend/Classes/Algorithms/SM2.hpp"
-#include "Backend/Classes/Algorithms/Leitner.hpp"
+#include "Backend/Classes/Algorithms/Registry.hpp"
+
+namespace {
+    // Values bound in order, logged only when it fails
+    bool runAnswerStatement(const char* sql, const std::initializer_list<QVariant> values) {
+        const auto query = Database::getInstance()->statement(sql);
+        int index = 0;
+        for (const QVariant& value : values) query->bindValue(index++, value);
+
+        if (!query->exec()) {
+            Logger::error("Failed to save the card response: " + query->lastError().text(), "Deck");
+            return false;
+        }
+        return true;
+    }
+}
 
 // DEBUG: Speed up time by changing the interval multiplier (default 86400 for days)
 // Set this to 60 to treat intervals as minutes for testing.
@@ -36,9 +62,6 @@ QString Deck::getName() const { return this->name; }
 // Get Deck ID
 QString Deck::getID() const { return this->id; }
 
-// Get Study Queue Size
-int Deck::getStudyQueueSize() const { return this->studyQueue.size(); }
-
 // Setters
 
 // Database Operations
@@ -49,21 +72,19 @@ bool Deck::create() {
     const Database* db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    // Retrieve saved deck ID
-    query.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!query.exec() || !query.next()) {
+    // Retrieve saved user ID
+    const QString user_id = SessionContext::getUserID();
+    if (user_id.isEmpty()) {
         Logger::error("Could not retrieve user ID for deck creation", "Deck");
         return false;
     }
 
-    const QString user_id = query.value(0).toString();
-
     // Check if deck with the given name exists for that user
     query.prepare(QStringLiteral(R"(
             SELECT COUNT(*)
             FROM Decks d
             INNER JOIN UsersDecks ud ON d.id = ud.deck_id
-            WHERE ud.user_id = ? AND d.name = ?;
+            WHERE ud.user_id = (SELECT id FROM Users WHERE uid = ?) AND d.name = ?;
         )"));
     query.addBindValue(user_id);
     query.addBindValue(this->name.isEmpty() ? "Default" : this->name);
@@ -97,7 +118,7 @@ bool Deck::_delete() const {
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare("DELETE FROM Decks WHERE id = ?;");
+    query.prepare("DELETE FROM Decks WHERE uid = ?;");
     query.addBindValue(this->id);
 
     if (!query.exec()) {
@@ -105,6 +126,10 @@ bool Deck::_delete() const {
         return false;
     }
 
+    SessionContext::invalidateDeck(this->id);
+    Forecast::invalidate();
+    StatsService::deckDeleted(this->id);
+    AnswerTimes::deckDeleted(this->id);
     return true;
 }
 
@@ -116,7 +141,7 @@ bool Deck::fetch() {
     QSqlQuery query(db->getDB());
 
     if (!this->id.isEmpty()) {
-        query.prepare(QStringLiteral("SELECT * FROM Decks WHERE id = ?;"));
+        query.prepare(QStringLiteral("SELECT name FROM Decks WHERE uid = ?;"));
         query.addBindValue(this->id);
 
         if (!query.exec() || !query.next()) {
@@ -126,7 +151,7 @@ bool Deck::fetch() {
 
         this->name = query.value("name").toString();
     } else if (!this->name.isEmpty()) {
-        query.prepare(QStringLiteral("SELECT * FROM Decks WHERE name = ?;"));
+        query.prepare(QStringLiteral("SELECT uid AS id FROM Decks WHERE name = ?;"));
         query.addBindValue(this->name);
 
         if (!query.exec() || !query.next()) {
@@ -150,26 +175,23 @@ bool Deck::addCard(Card& card) {
     const Database* db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("SELECT * FROM Cards WHERE id = ? LIMIT 1"));
+    query.prepare(QStringLiteral("SELECT id FROM Cards WHERE uid = ? LIMIT 1"));
     query.addBindValue(card.getID());
 
+    bool created = false;
     if (!query.exec() || !query.next()) {
         Logger::db("Card not found, creating Card...", "Deck");
         if (!card.create()) {
             Logger::error("Could not create Card", "Deck");
             return false;
         }
+        created = true;
     }
 
-    query.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!query.exec() || !query.next()) {
-        Logger::error("Could not fetch saved user", "Deck");
-        return false;
-    }
-
-    const QString user_id = query.value(0).toString();
-
-    query.prepare(QStringLiteral("INSERT INTO DecksCards (deck_id, card_id) VALUES (?, ?)"));
+    query.prepare(QStringLiteral(R"(
+            INSERT INTO DecksCards (deck_id, card_id)
+            VALUES ((SELECT id FROM Decks WHERE uid = ?), (SELECT id FROM Cards WHERE uid = ?))
+        )"));
     query.addBindValue(this->id);
     query.addBindValue(card.getID());
 
@@ -178,6 +200,12 @@ bool Deck::addCard(Card& card) {
         return false;
     }
 
+    if (!DeckCounters::cardAdded(this->id, created)) {
+        Logger::warn("Deck counters were not updated", "Deck");
+    }
+    // An existing card may bring its schedule into the deck
+    if (!created) Forecast::invalidate();
+
     // Update Deck Stats
     stats.setDeckID(this->id);
     stats.initialize(); // Ensure record for today exists
@@ -190,6 +218,7 @@ bool Deck::addCard(Card& card) {
         Logger::error("Failed to update deck stats", "Deck");
         return false;
     }
+    StatsService::cardAdded(SessionContext::getUserID(), this->id);
 
     Logger::info("Successfully added card to deck", "Deck");
     return true;
@@ -207,7 +236,7 @@ bool Deck::rename(const QString& newName) {
     const Database* db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("UPDATE Decks SET name = ? WHERE id = ?;"));
+    query.prepare(QStringLiteral("UPDATE Decks SET name = ? WHERE uid = ?;"));
     query.addBindValue(newName);
     query.addBindValue(this->id);
 
@@ -221,6 +250,35 @@ bool Deck::rename(const QString& newName) {
     return true;
 }
 
+// Set Deck algorithm
+bool Deck::setAlgorithm(const QString& algorithm) const {
+    Logger::entity("Setting Deck Algorithm", this->id);
+
+    const std::optional<AlgorithmID> id = Algorithms::fromName(algorithm);
+    if (!id) {
+        Logger::warn("Deck Set Algorithm - Unknown algorithm: " + algorithm, "Deck");
+        return false;
+    }
+
+    const auto query = Database::getInstance()->statement(UPDATE_DECK_ALGORITHM);
+    query->bindValue(0, Algorithms::name(*id));
+    query->bindValue(1, this->id);
+
+    if (!query->exec()) {
+        Logger::error("Could not update Deck algorithm: " + query->lastError().text(), "Deck");
+        return false;
+    }
+
+    SessionContext::invalidateDeck(this->id);
+    return true;
+}
+
+// Get Deck algorithm
+QString Deck::fetchAlgorithm() const {
+    const std::optional<DeckSettings> settings = SessionContext::getDeckSettings(this->id);
+    return settings ? Algorithms::name(settings->algorithm) : QString();
+}
+
 // Set Deck description
 bool Deck::setDescription(const QString& description) const {
     Logger::entity("Setting Deck Description", this->id);
@@ -233,7 +291,7 @@ bool Deck::setDescription(const QString& description) const {
     const Database* db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("UPDATE Decks SET description = ? WHERE id = ?"));
+    query.prepare(QStringLiteral("UPDATE Decks SET description = ? WHERE uid = ?"));
     query.addBindValue(description);
     query.addBindValue(this->id);
 
@@ -252,7 +310,7 @@ QString Deck::getDescription() const {
     const Database* db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("SELECT description FROM Decks WHERE id = ?"));
+    query.prepare(QStringLiteral("SELECT description FROM Decks WHERE uid = ?"));
     query.addBindValue(this->id);
 
     if (!query.exec() || !query.next()) {
@@ -271,7 +329,11 @@ std::vector<Card> Deck::listCards() const {
     const Database* db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("SELECT id, question, answer, type FROM Cards WHERE deck_id = ?"));
+    query.prepare(QStringLiteral(R"(
+            SELECT c.uid AS id, c.question, c.answer, c.type FROM Cards c
+            INNER JOIN DecksCards dc ON c.id = dc.card_id
+            WHERE dc.deck_id = (SELECT id FROM Decks WHERE uid = ?)
+        )"));
     query.addBindValue(this->id);
 
     if (!query.exec()) {
@@ -289,560 +351,123 @@ std::vector<Card> Deck::listCards() const {
 // Get card count in the deck
 int Deck::getCardCount() const {
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
+    const auto query = db->statement(COUNT_DECK_CARDS);
 
-    query.prepare(QStringLiteral("SELECT COUNT(*) FROM DecksCards WHERE deck_id = ?"));
-    query.addBindValue(this->id);
+    query->bindValue(0, this->id);
 
-    if (!query.exec()) {
-        Logger::error("Failed to get card count: " + query.lastError().text(), "Deck");
+    if (!query->exec()) {
+        Logger::error("Failed to get card count: " + query->lastError().text(), "Deck");
         return -1;
     }
 
-    return query.next() ? query.value(0).toInt() : 0;
+    return query->next() ? query->value(0).toInt() : 0;
 }
 
 std::vector<int> Deck::getCardInformation() const {
-    const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
-
     // Fetch user ID
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) return {0, 0, 0};
-    const QString currentUserID = userQuery.value(0).toString();
-
-    // Fetch limits
-    query.prepare("SELECT daily_new_card_limit, max_review_cards FROM DeckSettings WHERE id = ?");
-    query.addBindValue(this->id);
-    int newLimit = 20;
-    int reviewLimit = 100;
-    if (query.exec() && query.next()) {
-        newLimit = query.value(0).toInt();
-        reviewLimit = query.value(1).toInt();
-    }
-
-    // Count new cards studied today
-    query.prepare(QStringLiteral(R"(
-        SELECT COUNT(DISTINCT id) FROM CardStats
-        WHERE user_id = ? AND date = DATE('now')
-          AND id IN (SELECT card_id FROM DecksCards WHERE deck_id = ?)
-          AND id NOT IN (SELECT id FROM CardStats WHERE date < DATE('now'))
-    )"));
-    query.addBindValue(currentUserID);
-    query.addBindValue(this->id);
-    int newStudiedToday = 0;
-    if (query.exec() && query.next()) newStudiedToday = query.value(0).toInt();
-    
-    int remainingNewLimit = std::max(0, newLimit - newStudiedToday);
-
-    // Count reviews studied today
-    query.prepare(QStringLiteral(R"(
-        SELECT COUNT(DISTINCT id) FROM CardStats
-        WHERE user_id = ? AND date = DATE('now')
-          AND id IN (SELECT card_id FROM DecksCards WHERE deck_id = ?)
-          AND id IN (SELECT id FROM CardStats WHERE date < DATE('now'))
-    )"));
-    query.addBindValue(currentUserID);
-    query.addBindValue(this->id);
-    int reviewsStudiedToday = 0;
-    if (query.exec() && query.next()) reviewsStudiedToday = query.value(0).toInt();
-
-    int remainingReviewLimit = std::max(0, reviewLimit - reviewsStudiedToday);
-
-    // Count available New cards (up to remaining limit)
-    query.prepare(R"(
-        SELECT COUNT(*) FROM Cards c
-        INNER JOIN DecksCards dc ON c.id = dc.card_id
-        WHERE dc.deck_id = ? AND c.type = 'New'
-          AND c.id NOT IN (SELECT id FROM CardStats WHERE user_id = ?)
-    )");
-    query.addBindValue(this->id);
-    query.addBindValue(currentUserID);
-    int availableNew = 0;
-    if (query.exec() && query.next()) availableNew = std::min(remainingNewLimit, query.value(0).toInt());
-
-    // Count available Learning cards (No limit)
-    query.prepare(R"(
-        SELECT COUNT(*) FROM Cards c
-        INNER JOIN DecksCards dc ON c.id = dc.card_id
-        WHERE dc.deck_id = ? AND c.type = 'Learning'
-    )");
-    query.addBindValue(this->id);
-    int availableLearn = 0;
-    if (query.exec() && query.next()) availableLearn = query.value(0).toInt();
-
-    // Count due Review cards (up to remaining limit)
-    query.prepare(R"(
-        SELECT COUNT(*) FROM Cards c
-        INNER JOIN DecksCards dc ON c.id = dc.card_id
-        INNER JOIN CardStats cs ON c.id = cs.id
-        WHERE dc.deck_id = ? AND c.type = 'Review' AND cs.user_id = ?
-          AND (cs.last_seen + (cs.interval * ?)) <= ?
-    )");
-    query.addBindValue(this->id);
-    query.addBindValue(currentUserID);
-    query.addBindValue(STUDY_INTERVAL_MULTIPLIER);
-    query.addBindValue(QDateTime::currentSecsSinceEpoch());
-    int availableReview = 0;
-    if (query.exec() && query.next()) availableReview = std::min(remainingReviewLimit, query.value(0).toInt());
-
-    return { availableNew, availableLearn, availableReview };
-}
-
-// Studying Process
-
-// Start study session
-bool Deck::study() {
-    Logger::entity("Starting Study Session", this->id);
-
-    if (this->id.isEmpty()) {
-        Logger::error("Deck Study - Missing ID", "Deck");
-        return false;
-    }
-
-    if (getCardCount() == 0) {
-        Logger::info("Deck Study - No cards in the deck", "Deck");
-        return false;
-    }
-
-    const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
-
-    // Fetch daily limits from DeckSettings
-    query.prepare(QStringLiteral(R"(
-        SELECT daily_new_card_limit, max_review_cards
-        FROM DeckSettings
-        WHERE id = ?
-    )"));
-    query.addBindValue(this->id);
-
-    int dailyNewCardLimit = 0;
-    int maxReviewCards = 0;
-
-    if (!query.exec() || !query.next()) {
-        Logger::error("Failed to fetch deck settings: " + query.lastError().text(), "Deck");
-        return false;
-    }
-
-    dailyNewCardLimit = query.value(0).toInt();
-    maxReviewCards = query.value(1).toInt();
-
-    // Load DeckStats
-    DeckStats deckStats;
-    deckStats.setDeckID(this->id);
-    delete deckStats.load();
-    if (!deckStats.initialize()) {
-        Logger::error("Failed to initialize deck stats", "Deck");
-        return false;
-    }
-
-    // Get current progress
-    const std::vector<int> currentInfo = getCardInformation();
-    const int availableNew = currentInfo[0];
-    const int availableLearn = currentInfo[1];
-    const int availableReview = currentInfo[2];
-
-    if (availableNew == 0 && availableLearn == 0 && availableReview == 0) {
-        Logger::info("No cards available for study (limits reached or nothing due)", "Deck");
-        return false;
-    }
-
-    // Initialize session start time
-    StatsUpdateContext context;
-    context.type = StatsUpdateType::Deck;
-    context.deck.update_start_study = true;
-    if (!deckStats.update(context)) {
-        Logger::error("Could not update deck stats session start", "Deck");
-        return false;
-    }
-
-    // Fetch total cards in deck for logging
-    QSqlQuery countQuery(db->getDB());
-    countQuery.prepare("SELECT COUNT(*) FROM DecksCards WHERE deck_id = ?");
-    countQuery.addBindValue(this->id);
-    if (countQuery.exec() && countQuery.next()) {
-        Logger::info(QString("Total cards in deck: %1").arg(countQuery.value(0).toInt()), "Deck");
-    }
-
-    // Fetch the current user's ID to bind to the query
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) {
-        Logger::error("Could not retrieve user ID for study query", "Deck");
-        return false;
-    }
-    const QString currentUserID = userQuery.value(0).toString();
-
-    // Fetch due and learning cards for studying
-    query.prepare(QStringLiteral(R"(
-        SELECT c.id, c.question, c.answer, c.type,
-               COALESCE(latest_cs.last_seen + (latest_cs.interval * ?), 0) AS due_date
-        FROM Cards c
-        INNER JOIN DecksCards dc ON c.id = dc.card_id
-        LEFT JOIN (
-            SELECT id, last_seen, interval, 
-                   ROW_NUMBER() OVER (PARTITION BY id ORDER BY date DESC) as rn
-            FROM CardStats
-            WHERE user_id = ?
-        ) latest_cs ON c.id = latest_cs.id AND latest_cs.rn = 1
-        WHERE dc.deck_id = ?
-          AND (latest_cs.id IS NULL OR (latest_cs.last_seen + (latest_cs.interval * ?)) <= ? OR c.type = 'Learning')
-        ORDER BY due_date ASC
-        LIMIT 1000
-    )"));
-
-    query.addBindValue(STUDY_INTERVAL_MULTIPLIER);
-    query.addBindValue(currentUserID);
-    query.addBindValue(this->id);
-    query.addBindValue(STUDY_INTERVAL_MULTIPLIER);
-    query.addBindValue(QDateTime::currentSecsSinceEpoch());
-
-    if (!query.exec()) {
-        Logger::error("Could not retrieve cards for study: " + query.lastError().text(), "Deck");
-        return false;
-    }
-
-    int newCardsFetched = 0;
-    while (query.next()) {
-        Card card(
-            query.value("id").toString(),
-            query.value("question").toString(),
-            query.value("answer").toString(),
-            Card::stringToType(query.value("type").toString())
-        );
-
-        if (card.getType() == CardType::New) {
-            if (newCardsFetched >= dailyNewCardLimit) continue;
-            newCardsFetched++;
-        }
-
-        this->studyQueue.push(card);
-    }
+    const QString currentUserID = SessionContext::getUserID();
+    if (currentUserID.isEmpty()) return {0, 0, 0};
 
-    if (this->studyQueue.empty()) {
-        Logger::info("No cards available for study in this deck", "Deck");
-        return false;
-    }
-
-    Logger::info(QString("Study session ready. Cards loaded: %1").arg(QString::number(this->studyQueue.size())), "Deck");
-    return true;
+    const DeckCounts counts = StatsService::counts(currentUserID, this->id);
+    return { counts.new_cards, counts.learning, counts.due_reviews };
 }
 
-// Ends study session
-bool Deck::endStudy() const {
-    Logger::entity("Ending Study Session", this->id);
-
-    if (this->id.isEmpty()) {
-        return false;
-    }
-
+// Apply an answer to the database
+// Runs on the committer thread, inside the batch transaction
+bool Deck::applyCardResponse(const ReviewEvent& event) {
+    const int buttonPressed = event.button;
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
 
-    // Fetch session start time and time spent from DeckStats
-    DeckStats deckStats;
-    deckStats.setDeckID(this->id);
-
-    delete deckStats.load();
-    if (!deckStats.initialize()) {
+    // A savepoint inside the batch (a commit of its own when applied in place),
+    // any failure below rolls back every write of this answer
+    Transaction transaction(db->getDB());
+    if (!transaction.isActive()) {
+        Logger::error("Could not start a transaction for the card response", "Deck");
         return false;
     }
 
-    const qint64 sessionStartTimeSecs = deckStats.getSessionStartTime();
-    const qint64 existingTimeSpent = deckStats.getTimeSpent();
-
-    if (existingTimeSpent < 0) {
-        Logger::error("Invalid existing time spent", "Deck");
-        return false;
-    }
-
-    const qint64 timeSpentInSession = QDateTime::currentDateTime().toSecsSinceEpoch() - sessionStartTimeSecs;
-
-    // Fetch selected user
-    query.prepare("SELECT id FROM SavedUser LIMIT 1");
-    if (!query.exec() || !query.next()) {
-        Logger::error("Could not fetch saved user", "Deck");
-        return false;
-    }
-
-    deckStats.setUserID(query.value(0).toString());
-
-    StatsUpdateContext context;
-    context.type = StatsUpdateType::Deck;
-    context.deck.update_time_spent = true;
-    context.deck.time_spent_increment = timeSpentInSession;
-
-    if (!deckStats.update(context)) {
-        Logger::error("Failed to update deck stats at session end", "Deck");
-        return false;
-    }
-
-    Logger::info(QString("Study session for deck %1 ended. Session duration: %2s").arg(this->id, QString::number(timeSpentInSession)), "Deck");
-    return true;
-}
-
-// Process card response on button press
-bool Deck::processCardResponse(Card& card, const int buttonPressed) {
-    if (this->id.isEmpty()) {
-        qDebug() << "[DB] Process Card Response - Missing Deck ID.";
-        return false;
-    }
-
-    if (card.getID().isEmpty()) {
-        Logger::error("Process Card Response - Missing Card ID", "Deck");
-        return false;
-    }
-
-    logAction("Process Deck Card Response");
     // Check the deck algorithm and use the corresponding function
-    const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
-
-    query.prepare(QStringLiteral(R"(
-        SELECT algorithm
-        FROM DeckSettings
-        WHERE id = ?
-    )"));
-    query.addBindValue(this->id);
-
-    if (!query.exec() || !query.next()) {
-        qDebug() << "[DB] Failed to fetch deck algorithm:" << query.lastError().text();
+    const std::optional<DeckSettings> settings = SessionContext::getDeckSettings(event.deck_id);
+    if (!settings) {
+        qDebug() << "[DB] Failed to fetch deck algorithm";
         return false;
     }
 
-    const QString algorithm = query.value(0).toString();
-    Logger::info("Using algorithm: " + algorithm, "Deck");
-
-    // Fetch the current user's ID
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) {
+    // The user who answered, the selected one may have changed since
+    const QString currentUserID = !event.user_id.isEmpty() ? event.user_id : SessionContext::getUserID();
+    if (currentUserID.isEmpty()) {
         Logger::error("Could not retrieve user ID for CardStats", "Deck");
         return false;
     }
-    const QString currentUserID = userQuery.value(0).toString();
-
-    // Load latest card stats
-    CardStats cardStats;
-    cardStats.setCardID(card.getID());
-    cardStats.setUserID(currentUserID);
-
-    delete cardStats.load(); // Load latest history if available
-    
-    // Ensure today's record exists (carries over latest stats if needed)
-    if (!cardStats.initialize()) {
-        Logger::error("Failed to initialize card stats for today", "Deck");
-        return false;
-    }
-
-    // Apply the algorithm
-    SM2Algorithm sm2;
-    LeitnerAlgorithm leitner;
 
-    if (algorithm.toUpper() == "SM2") sm2.calculateInterval(cardStats, buttonPressed);
-    else if (algorithm.toLower() == "leitner") leitner.calculateInterval(cardStats, buttonPressed);
-    else {
-        Logger::error("Unknown algorithm: " + algorithm, "Deck");
+    // Load the card's scheduling state
+    CardState state;
+    bool scheduled = false;
+    if (!CardState::load(currentUserID, event.card_id, state, scheduled)) {
+        Logger::error("Failed to load card state", "Deck");
         return false;
     }
+    const int previousInterval = state.interval;
+    const std::optional<qint64> previousDue = scheduled ? std::optional<qint64>(state.due) : std::nullopt;
 
-    // Update the card's stats
-    StatsUpdateContext context;
-    context.type = StatsUpdateType::Card;
-    if (algorithm == "SM2") {
-        context.card.update_repetitions = true;
-        context.card.update_ease_factor = true;
-    }
-    context.card.update_interval = true;
-    context.card.update_last_seen = true;
-    context.card.update_times_seen = true;
-    context.card.update_time_spent = true;
-    context.card.time_spent_increment = QDateTime::currentSecsSinceEpoch() - cardStats.getCardStartTime();
+    // Apply the algorithm
+    const qint64 answeredAt = event.answered_at / 1000;
+    Algorithms::calculateInterval(settings->algorithm, state, buttonPressed, { answeredAt, currentUserID });
 
-    Logger::info(QString("Processing response for card %1 (Button: %2, Interval: %3)").arg(card.getID(), QString::number(buttonPressed), QString::number(cardStats.getInterval())), "Deck");
+    // Forgetting a card that had an interval is a lapse, whatever the algorithm
+    if (buttonPressed == 1 && previousInterval > 0 && state.lapses < std::numeric_limits<quint16>::max()) ++state.lapses;
 
-    if (!cardStats.update(context)) {
-        Logger::error("Failed to update card stats", "Deck");
+    // Log the answer and store the new state
+    const qint64 due = answeredAt + static_cast<qint64>(state.interval) * STUDY_INTERVAL_MULTIPLIER;
+    state.last_seen = CardState::toSeconds(answeredAt);
+    state.due = CardState::toSeconds(due);
+    if (!state.save(currentUserID, event, previousInterval)) {
+        Logger::error("Failed to record the review", "Deck");
         return false;
     }
 
-    // Update User and Deck Statistics
-    UserStats userStats(currentUserID);
-    userStats.initialize(); // Ensure record for today exists
-
-    DeckStats deckStats;
-    deckStats.setDeckID(this->id);
-    deckStats.initialize(); // Ensure record for today exists
-
-    StatsUpdateContext userContext(StatsUpdateType::User);
-    userContext.user.update_button_counts = true;
-    userContext.user.update_cards_seen = true;
-    userContext.user.cards_seen_increment = 1;
-
-    switch (buttonPressed) {
-        case 1: userContext.user.pressed_again = 1; break;
-        case 2: userContext.user.pressed_hard = 1; break;
-        case 3: userContext.user.pressed_good = 1; break;
-        case 4: userContext.user.pressed_easy = 1; break;
-    }
-
-    userStats.update(userContext);
-
-    StatsUpdateContext deckContext(StatsUpdateType::Deck);
-    deckContext.deck.update_cards_seen = true;
-    deckStats.update(deckContext);
-
-    // Handle Learning cards (Again or Hard)
-    if (buttonPressed == 1 || buttonPressed == 2) { // Again or Hard
-        card.setType(CardType::Learning);
-        this->studyQueue.push(card); // Add back to queue
-    } else {
-        card.setType(CardType::Review);
-    }
-    
-    card.saveType(); // Persist the type change to DB
-
-    return true;
-}
-
-// Get Next Card
-Card Deck::getNextCard() {
-    if (this->studyQueue.empty()) {
-        Logger::info("Study Queue is empty", "Deck");
-        return {};
-    }
-
-    const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
+    // Learning for Again or Hard
+    const CardType newType = buttonPressed == 1 || buttonPressed == 2 ? CardType::Learning : CardType::Review;
 
-    // Fetch dailyNewCardLimit and maxReviewCards from DeckSettings
-    query.prepare(QStringLiteral(R"(
-        SELECT daily_new_card_limit, max_review_cards
-        FROM DeckSettings
-        WHERE id = ?
-    )"));
-    query.addBindValue(this->id);
-
-    if (!query.exec() || !query.next()) {
-        Logger::error("Failed to fetch deck settings: " + query.lastError().text(), "Deck");
-        return {};
+    if (!DeckCounters::cardAnswered(currentUserID, event.card_id, static_cast<CardType>(event.card_type), newType,
+                                    scheduled, due)) {
+        Logger::error("Failed to update deck counters", "Deck");
+        return false;
     }
 
-    const int dailyNewCardLimit = query.value(0).toInt();
-    const int maxReviewCards = query.value(1).toInt();
+    // Today's user and deck stats rows, the first answer of the day creates them
+    // Cached statements bound from the event, no stats objects per answer
+    {
+        const auto query = db->statement(INSERT_USER_STATS_TODAY);
+        query->bindValue(0, currentUserID);
 
-    // Load DeckStats
-    DeckStats deckStats;
-    deckStats.setDeckID(this->id);
-    if (Stats* loadedStats = deckStats.load()) {
-        delete loadedStats;
-    } else {
-        if (!deckStats.initialize()) {
-            Logger::error("Failed to initialize deck stats", "Deck");
-            return {};
+        if (!query->exec()) {
+            Logger::error("Failed to initialize user stats for today: " + query->lastError().text(), "Deck");
+            return false;
         }
-    }
 
-    // Fetch progress from CardStats
-    QSqlQuery progressQuery(db->getDB());
-    
-    // New cards studied today
-    progressQuery.prepare(QStringLiteral(R"(
-        SELECT COUNT(DISTINCT id)
-        FROM CardStats
-        WHERE user_id = (SELECT id FROM SavedUser LIMIT 1)
-          AND date = DATE('now')
-          AND id IN (SELECT card_id FROM DecksCards WHERE deck_id = ?)
-          AND id NOT IN (SELECT id FROM CardStats WHERE date < DATE('now'))
-    )"));
-    progressQuery.addBindValue(this->id);
-    int dailyNewCardsStudiedToday = 0;
-    if (progressQuery.exec() && progressQuery.next()) {
-        dailyNewCardsStudiedToday = progressQuery.value(0).toInt();
-    }
-
-    // Review cards studied today
-    progressQuery.prepare(QStringLiteral(R"(
-        SELECT COUNT(DISTINCT id)
-        FROM CardStats
-        WHERE user_id = (SELECT id FROM SavedUser LIMIT 1)
-          AND date = DATE('now')
-          AND id IN (SELECT card_id FROM DecksCards WHERE deck_id = ?)
-          AND id IN (SELECT id FROM CardStats WHERE date < DATE('now'))
-    )"));
-    progressQuery.addBindValue(this->id);
-    int dailyReviewsStudiedToday = 0;
-    if (progressQuery.exec() && progressQuery.next()) {
-        dailyReviewsStudiedToday = progressQuery.value(0).toInt();
-    }
-
-    Card nextCard = this->studyQueue.front();
-    
-    // Check limits based on card type
-    if (nextCard.getType() == CardType::New) {
-        if (dailyNewCardsStudiedToday >= dailyNewCardLimit) {
-            Logger::info("Daily new card limit reached during session", "Deck");
-            // Optionally clear the queue of other new cards? 
-            // For now just stop.
-            return {};
-        }
-    } else if (nextCard.getType() == CardType::Review) {
-        if (dailyReviewsStudiedToday >= maxReviewCards) {
-            Logger::info("Daily review card limit reached during session", "Deck");
-            return {};
+        // First row of a new day, the days before it are final now
+        if (query->numRowsAffected() > 0 && !StatsRollups::rollOver(currentUserID)) {
+            Logger::warn("Stats rollups are behind, they catch up on the next read", "Deck");
         }
     }
 
-    this->studyQueue.pop();
-
-    // Check if the next card is "Brand New" (has NO stats records at all)
-    // This is a secondary check to ensure consistency if getType() is not 'New' but it has no stats.
-    query.prepare(QStringLiteral("SELECT COUNT(*) FROM CardStats WHERE id = ?"));
-    query.addBindValue(nextCard.getID());
-    
-    bool isBrandNew = true;
-    if (query.exec() && query.next() && query.value(0).toInt() > 0) {
-        isBrandNew = false;
-    }
-
-    if (isBrandNew && nextCard.getType() != CardType::New) {
-         // Should not happen often but handle just in case
-         if (dailyNewCardsStudiedToday >= dailyNewCardLimit) return {};
-    }
-
-    // Set the timer in the database using CardStats class
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) {
-        Logger::error("Could not retrieve user ID for getNextCard", "Deck");
-        return {};
-    }
-    const QString currentUserID = userQuery.value(0).toString();
-
-    CardStats cardStats;
-    cardStats.setCardID(nextCard.getID());
-    cardStats.setUserID(currentUserID);
-
-    if (Stats* loadedCardStats = cardStats.load()) {
-        delete loadedCardStats;
-    } else {
-        if (!cardStats.initialize()) {
-            Logger::error("Failed to initialize card stats", "Deck");
-            return {};
-        }
+    if (!runAnswerStatement(INSERT_DECK_STATS_TODAY, { event.deck_id, currentUserID }) ||
+        !runAnswerStatement(UPDATE_USER_STATS_ANSWER, { buttonPressed == 1 ? 1 : 0, buttonPressed == 2 ? 1 : 0,
+                                                        buttonPressed == 3 ? 1 : 0, buttonPressed == 4 ? 1 : 0,
+                                                        currentUserID }) ||
+        !runAnswerStatement(UPDATE_DECK_STATS_ANSWER, { event.deck_id, currentUserID }) ||
+        !runAnswerStatement(UPDATE_CARD_TYPE, { Card::typeToString(newType), event.card_id })) {
+        return false;
     }
 
-    StatsUpdateContext context;
-    context.type = StatsUpdateType::Card;
-    context.card.update_start_study = true;
-
-    if (!cardStats.update(context)) {
-        Logger::error("Failed to set card timer", "Deck");
-        return {};
+    if (!transaction.commit()) {
+        Logger::error("Failed to commit card response", "Deck");
+        return false;
     }
 
-    return nextCard;
+    Forecast::cardAnswered(currentUserID, event.card_id, previousDue, due);
+    return true;
 }
 
 // Get Deck stats object (For UI)
@@ -0,0 +1,129 @@
+#include <algorithm>
+
+#include "Backend/Classes/DueIndex.hpp"
+#include "Backend/Utilities/statsDay.hpp"
+
+void DueIndex::clear() {
+    cards.clear();
+    pending = {};
+    newCount = learningCount = dueReviewCount = 0;
+    newLimit = reviewLimit = 0;
+    newStudiedToday = reviewsStudiedToday = 0;
+    day = QDate();
+    built = false;
+}
+
+bool DueIndex::isBuilt() const { return built; }
+
+void DueIndex::setLimits(const int newLimit, const int reviewLimit, const int newStudiedToday, const int reviewsStudiedToday) {
+    this->newLimit = newLimit;
+    this->reviewLimit = reviewLimit;
+    this->newStudiedToday = newStudiedToday;
+    this->reviewsStudiedToday = reviewsStudiedToday;
+    this->day = statsToday();
+}
+
+void DueIndex::add(const QString& cardID, const CardType type, const std::optional<qint64> due, const qint64 now) {
+    Entry entry;
+    entry.type = type;
+    entry.scheduled = due.has_value();
+
+    switch (type) {
+        case CardType::New:
+            // Cards with a state row are not offered as new (same as the deck counters)
+            if (!entry.scheduled) ++newCount;
+            break;
+        case CardType::Learning:
+            ++learningCount;
+            break;
+        case CardType::Review:
+            if (!entry.scheduled) break;
+            if (*due <= now) {
+                ++dueReviewCount;
+            } else {
+                entry.waiting = true;
+                pending.push({ *due, cardID });
+            }
+            break;
+    }
+
+    cards[cardID] = entry;
+}
+
+void DueIndex::finish() { built = true; }
+
+void DueIndex::advance(const qint64 now) {
+    while (!pending.empty() && pending.top().due <= now) {
+        const auto it = cards.find(pending.top().card_id);
+        // Skip entries of cards that were answered while they waited
+        if (it != cards.end() && it->second.waiting) {
+            it->second.waiting = false;
+            ++dueReviewCount;
+        }
+        pending.pop();
+    }
+}
+
+void DueIndex::rollOver() {
+    const QDate today = statsToday();
+    if (day == today) return;
+
+    day = today;
+    newStudiedToday = 0;
+    reviewsStudiedToday = 0;
+}
+
+void DueIndex::answered(const QString& cardID, const CardType before, const CardType after) {
+    rollOver();
+
+    Entry& entry = cards[cardID];
+
+    // Leave the old bucket
+    switch (before) {
+        case CardType::New:
+            if (!entry.scheduled) newCount = std::max(0, newCount - 1);
+            ++newStudiedToday;
+            break;
+        case CardType::Learning:
+            learningCount = std::max(0, learningCount - 1);
+            break;
+        case CardType::Review:
+            if (entry.waiting) entry.waiting = false;
+            else dueReviewCount = std::max(0, dueReviewCount - 1);
+            ++reviewsStudiedToday;
+            break;
+    }
+
+    // Join the new one
+    // A card that graduates to Review is at least a day out and is not studied again this session
+    if (after == CardType::Learning) ++learningCount;
+
+    entry.type = after;
+    entry.scheduled = true;
+}
+
+DueIndex::Counts DueIndex::counts(const qint64 now) {
+    rollOver();
+    advance(now);
+
+    Counts counts;
+    counts.available_new = std::min(std::max(0, newLimit - newStudiedToday), newCount);
+    counts.learning = learningCount;
+    counts.due_reviews = std::min(std::max(0, reviewLimit - reviewsStudiedToday), dueReviewCount);
+    return counts;
+}
+
+bool DueIndex::canStudy(const CardType type) {
+    rollOver();
+
+    switch (type) {
+        case CardType::New: return newStudiedToday < newLimit;
+        case CardType::Review: return reviewsStudiedToday < reviewLimit;
+        default: return true;
+    }
+}
+
+bool DueIndex::isScheduled(const QString& cardID) const {
+    const auto it = cards.find(cardID);
+    return it != cards.end() && it->second.scheduled;
+}
@@ -0,0 +1,138 @@
+#include <algorithm>
+
+#include <QDate>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+namespace {
+    constexpr qint64 SECONDS_PER_DAY = 86400;
+
+    qint64 todayStart() {
+        return QDate::currentDate().startOfDay().toSecsSinceEpoch();
+    }
+
+    void move(Forecast::Histogram& histogram, const int from, const int to) {
+        if (from >= 0) histogram[from] = std::max(0, histogram[from] - 1);
+        if (to >= 0) ++histogram[to];
+    }
+}
+
+// Define static members
+std::mutex Forecast::mutex;
+QString Forecast::userID;
+Forecast::Snapshot Forecast::snapshot;
+
+int Forecast::dayIndex(const qint64 due, const qint64 dayStart) {
+    if (due < dayStart) return 0;
+
+    const qint64 day = (due - dayStart) / SECONDS_PER_DAY;
+    return day < DAYS ? static_cast<int>(day) : -1;
+}
+
+Forecast::Snapshot Forecast::build(QSqlQuery& rows, const qint64 dayStart) {
+    Snapshot result;
+    result.day_start = dayStart;
+
+    // Rows come ordered by card, a card in several decks counts once for the user
+    qint64 previousCard = -1;
+    // Integer deck key, the public ID is only read the first time a deck shows up
+    std::unordered_map<qint64, Histogram*> decks;
+
+    while (rows.next()) {
+        const int day = dayIndex(rows.value(3).toLongLong(), dayStart);
+        if (day < 0) continue;
+
+        const qint64 card = rows.value(0).toLongLong();
+        if (card != previousCard) {
+            ++result.total[day];
+            previousCard = card;
+        }
+
+        const qint64 deck = rows.value(1).toLongLong();
+        auto it = decks.find(deck);
+        if (it == decks.end()) {
+            it = decks.emplace(deck, &result.decks.try_emplace(rows.value(2).toString()).first->second).first;
+        }
+        ++(*it->second)[day];
+    }
+
+    return result;
+}
+
+bool Forecast::ensureBuilt(const QString& userID) {
+    const qint64 dayStart = todayStart();
+    if (Forecast::userID == userID && snapshot.day_start == dayStart) return true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const auto query = Database::getInstance()->statement(SELECT_FORECAST_STATE);
+    query->setForwardOnly(true);
+    query->bindValue(0, userID);
+    query->bindValue(1, dayStart + DAYS * SECONDS_PER_DAY);
+
+    if (!query->exec()) {
+        Logger::error("Failed to read the review forecast: " + query->lastError().text(), "Forecast");
+        return false;
+    }
+
+    snapshot = build(*query, dayStart);
+    Forecast::userID = userID;
+
+    Logger::info(QString("Review forecast built in %1 ms").arg(QString::number(timer.elapsed())), "Forecast");
+    return true;
+}
+
+Forecast::Histogram Forecast::forUser(const QString& userID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureBuilt(userID)) return Histogram{};
+    return snapshot.total;
+}
+
+Forecast::Histogram Forecast::forDeck(const QString& userID, const QString& deckID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureBuilt(userID)) return Histogram{};
+
+    const auto it = snapshot.decks.find(deckID);
+    return it != snapshot.decks.end() ? it->second : Histogram{};
+}
+
+void Forecast::cardAnswered(const QString& userID, const QString& cardID, const std::optional<qint64> previousDue, const qint64 due) {
+    std::lock_guard lock(mutex);
+
+    // Not built or from another day, the next read starts over anyway
+    if (Forecast::userID != userID || snapshot.day_start != todayStart()) return;
+
+    const int from = previousDue ? dayIndex(*previousDue, snapshot.day_start) : -1;
+    const int to = dayIndex(due, snapshot.day_start);
+    if (from == to) return;
+
+    const auto query = Database::getInstance()->statement(SELECT_CARD_DECKS_FOR_USER);
+    query->bindValue(0, userID);
+    query->bindValue(1, cardID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to read the decks of an answered card: " + query->lastError().text(), "Forecast");
+        Forecast::userID.clear();
+        return;
+    }
+
+    move(snapshot.total, from, to);
+    while (query->next()) {
+        Histogram& histogram = snapshot.decks.try_emplace(query->value(0).toString()).first->second;
+        move(histogram, from, to);
+    }
+}
+
+void Forecast::invalidate() {
+    std::lock_guard lock(mutex);
+    userID.clear();
+    snapshot = Snapshot();
+}
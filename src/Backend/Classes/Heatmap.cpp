@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <limits>
+
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "Backend/Classes/Heatmap.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+namespace {
+    const qint64 EPOCH_JULIAN_DAY = QDate(1970, 1, 1).toJulianDay();
+    constexpr qint64 MS_PER_DAY = 86400 * 1000;
+
+    quint32 saturated(const qint64 value) {
+        return static_cast<quint32>(std::clamp<qint64>(value, 0, std::numeric_limits<quint32>::max()));
+    }
+}
+
+// Define static members
+std::mutex Heatmap::mutex;
+QString Heatmap::userID;
+Heatmap::Snapshot Heatmap::snapshot;
+
+Heatmap::Day Heatmap::Snapshot::at(const qint32 epochDay) const {
+    const qint64 index = static_cast<qint64>(epochDay) - first_day;
+    if (index < 0 || index >= static_cast<qint64>(days.size())) return {};
+    return days[index];
+}
+
+qint32 Heatmap::epochDay(const QDate& date) {
+    return static_cast<qint32>(date.toJulianDay() - EPOCH_JULIAN_DAY);
+}
+
+QDate Heatmap::dateOf(const qint32 epochDay) {
+    return QDate::fromJulianDay(EPOCH_JULIAN_DAY + epochDay);
+}
+
+qint32 Heatmap::epochDayOf(const qint64 msecs) {
+    // UTC days are all the same length
+    const qint64 day = msecs / MS_PER_DAY - (msecs % MS_PER_DAY < 0 ? 1 : 0);
+    return static_cast<qint32>(day);
+}
+
+void Heatmap::add(Snapshot& snapshot, const qint32 epochDay, const quint32 reviews, const qint64 durationMs) {
+    if (snapshot.days.empty()) snapshot.first_day = epochDay;
+
+    // Before the first day only when the clock went back, counted on the first day
+    const qint64 index = std::max<qint64>(0, static_cast<qint64>(epochDay) - snapshot.first_day);
+    if (index >= static_cast<qint64>(snapshot.days.size())) snapshot.days.resize(index + 1);
+
+    Day& day = snapshot.days[index];
+    day.reviews = saturated(static_cast<qint64>(day.reviews) + reviews);
+    day.duration_ms = saturated(static_cast<qint64>(day.duration_ms) + durationMs);
+}
+
+Heatmap::Snapshot Heatmap::build(QSqlQuery& earlierDays, QSqlQuery& reviews) {
+    Snapshot result;
+
+    while (earlierDays.next()) {
+        const QDate date = earlierDays.value(0).toDate();
+        if (!date.isValid()) continue;
+        add(result, epochDay(date), earlierDays.value(1).toUInt(), earlierDays.value(2).toLongLong() * 1000);
+    }
+
+    // Same days as the UserStats dates above, so the two meet without a gap or an overlap
+    while (reviews.next()) {
+        add(result, epochDayOf(reviews.value(0).toLongLong()), 1, reviews.value(1).toLongLong());
+    }
+
+    return result;
+}
+
+bool Heatmap::ensureBuilt(const QString& userID) {
+    if (Heatmap::userID == userID) return true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Answers still queued are counted by the answer path
+    if (!ReviewCommitter::getInstance()->flush()) {
+        Logger::warn("Some answers are not saved yet, the review calendar leaves them out", "Heatmap");
+    }
+
+    const Database* db = Database::getInstance();
+
+    const auto earlierDays = db->statement(SELECT_HEATMAP_EARLIER_DAYS);
+    earlierDays->setForwardOnly(true);
+    earlierDays->bindValue(0, userID);
+    earlierDays->bindValue(1, userID);
+
+    const auto reviews = db->statement(SELECT_HEATMAP_REVIEWS);
+    reviews->setForwardOnly(true);
+    reviews->bindValue(0, userID);
+
+    if (!earlierDays->exec() || !reviews->exec()) {
+        Logger::error("Failed to read the review history: " + earlierDays->lastError().text() + reviews->lastError().text(), "Heatmap");
+        return false;
+    }
+
+    snapshot = build(*earlierDays, *reviews);
+    Heatmap::userID = userID;
+
+    Logger::info(QString("Review calendar built in %1 ms").arg(QString::number(timer.elapsed())), "Heatmap");
+    return true;
+}
+
+Heatmap::Snapshot Heatmap::forUser(const QString& userID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureBuilt(userID)) return Snapshot{};
+    return snapshot;
+}
+
+void Heatmap::cardAnswered(const QString& userID, const qint64 answeredAt, const qint64 durationMs) {
+    std::lock_guard lock(mutex);
+
+    // Not built, the first read includes this answer
+    if (Heatmap::userID != userID) return;
+    add(snapshot, epochDayOf(answeredAt), 1, durationMs);
+}
+
+void Heatmap::invalidate() {
+    std::lock_guard lock(mutex);
+    userID.clear();
+    snapshot = Snapshot();
+}
@@ -0,0 +1,138 @@
+#include <QDateTime>
+#include <QSqlError>
+
+#include "Backend/Classes/Reschedule.hpp"
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Classes/StatsService.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Database/transaction.hpp"
+#include "Backend/Utilities/Logger.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
+
+namespace {
+    constexpr qint64 SECONDS_PER_DAY = 86400;
+
+    bool run(const char* sql, const QString& what) {
+        const auto query = Database::getInstance()->statement(sql);
+        if (!query->exec()) {
+            Logger::error("Failed to " + what + ": " + query->lastError().text(), "Reschedule");
+            return false;
+        }
+        return true;
+    }
+}
+
+int Reschedule::apply(const Operation operation, const int days, const std::function<bool()>& select) {
+    const QString userID = SessionContext::getUserID();
+    if (userID.isEmpty()) {
+        Logger::error("No user selected", "Reschedule");
+        return -1;
+    }
+
+    // A queued answer would otherwise land on top of the new schedule
+    if (!ReviewCommitter::getInstance()->flush()) {
+        Logger::error("Queued answers could not be saved, nothing was rescheduled", "Reschedule");
+        return -1;
+    }
+
+    const Database* db = Database::getInstance();
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    Transaction transaction(db->getDB());
+    if (!transaction.isActive()) return -1;
+
+    if (!run(CREATE_RESCHEDULE_SELECTION, "create the selection") ||
+        !run(CLEAR_RESCHEDULE_SELECTION, "clear the selection") || !select()) {
+        return -1;
+    }
+
+    int changed = 0;
+    {
+        const char* sql = operation == Operation::Postpone ? POSTPONE_SELECTION
+                        : operation == Operation::Spread ? SPREAD_SELECTION
+                        : FORGET_SELECTION_STATE;
+        const auto query = db->statement(sql);
+
+        switch (operation) {
+            case Operation::Postpone:
+                query->bindValue(0, days * SECONDS_PER_DAY);
+                query->bindValue(1, userID);
+                query->bindValue(2, now);
+                break;
+            case Operation::Spread:
+                query->bindValue(0, now);
+                query->bindValue(1, days);
+                query->bindValue(2, userID);
+                query->bindValue(3, now);
+                query->bindValue(4, userID);
+                break;
+            case Operation::Forget:
+                query->bindValue(0, userID);
+                break;
+        }
+
+        if (!query->exec()) {
+            Logger::error("Failed to reschedule cards: " + query->lastError().text(), "Reschedule");
+            return -1;
+        }
+        changed = query->numRowsAffected();
+    }
+
+    if (operation == Operation::Forget && !run(FORGET_SELECTION_TYPE, "reset card types")) return -1;
+
+    if (!run(DELETE_DECK_COUNTERS_SELECTION, "invalidate deck counters") ||
+        !run(CLEAR_RESCHEDULE_SELECTION, "clear the selection")) {
+        return -1;
+    }
+
+    if (!transaction.commit()) {
+        Logger::error("Failed to commit the rescheduled cards", "Reschedule");
+        return -1;
+    }
+
+    Forecast::invalidate();
+    StatsService::cardsChanged();
+    Logger::info(QString("Rescheduled %1 cards").arg(QString::number(changed)), "Reschedule");
+    return changed;
+}
+
+int Reschedule::postponeOverdue(const QString& deckID, const int days) {
+    if (days <= 0) return 0;
+    return apply(Operation::Postpone, days, [&deckID] {
+        const auto query = Database::getInstance()->statement(SELECT_DECK_INTO_SELECTION);
+        query->bindValue(0, deckID);
+        return query->exec();
+    });
+}
+
+int Reschedule::spreadOverdue(const QString& deckID, const int days) {
+    if (days <= 0) return 0;
+    return apply(Operation::Spread, days, [&deckID] {
+        const auto query = Database::getInstance()->statement(SELECT_DECK_INTO_SELECTION);
+        query->bindValue(0, deckID);
+        return query->exec();
+    });
+}
+
+int Reschedule::resetDeck(const QString& deckID) {
+    return apply(Operation::Forget, 0, [&deckID] {
+        const auto query = Database::getInstance()->statement(SELECT_DECK_INTO_SELECTION);
+        query->bindValue(0, deckID);
+        return query->exec();
+    });
+}
+
+int Reschedule::forget(const std::vector<QString>& cardIDs) {
+    if (cardIDs.empty()) return 0;
+    return apply(Operation::Forget, 0, [&cardIDs] {
+        // One prepared insert per card into the temporary table, the changes below stay set-based
+        const auto query = Database::getInstance()->statement(SELECT_CARD_INTO_SELECTION);
+        for (const QString& cardID : cardIDs) {
+            query->bindValue(0, cardID);
+            if (!query->exec()) return false;
+        }
+        return true;
+    });
+}
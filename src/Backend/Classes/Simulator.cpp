@@ -0,0 +1,243 @@
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <random>
+
+#include <QDate>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QThread>
+
+#include "Backend/Classes/Simulator.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+#include "Backend/Utilities/WorkerPool.hpp"
+
+namespace {
+    constexpr double SECONDS_PER_DAY = 86400.0;
+
+    // Totals of one day of one run
+    struct RunDay {
+        int reviews = 0;
+        int new_cards = 0;
+        int recalled = 0;
+        double seconds = 0;
+    };
+
+    // Index of the outcome u falls on, weights need not add up to one
+    template <size_t N>
+    int pick(const std::array<double, N>& weights, double u) {
+        double total = 0;
+        for (const double weight : weights) total += weight;
+
+        u *= total;
+        for (size_t i = 0; i + 1 < N; ++i) {
+            if (u < weights[i]) return static_cast<int>(i);
+            u -= weights[i];
+        }
+        return static_cast<int>(N) - 1;
+    }
+
+    void simulate(const Simulator::Collection& collection, const Algorithms::Any& algorithm,
+                  const Simulator::Settings& settings, const int run, std::vector<RunDay>& days) {
+        // Own stream per run, seeded from the settings and the run only
+        std::seed_seq seed = { static_cast<quint32>(settings.seed), static_cast<quint32>(settings.seed >> 32), static_cast<quint32>(run) };
+        std::mt19937_64 random(seed);
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+        const FSRSAlgorithm::Weights& w = settings.recall_weights;
+        const size_t count = collection.size();
+
+        StateBatch state = collection.state;
+        std::vector<int> last = collection.last_day;
+
+        // What the user actually remembers, the scheduler only sees state
+        std::vector<FSRSAlgorithm::Memory<double>> memory(count);
+        std::vector<std::vector<quint32>> dueOn(settings.days);
+        std::vector<quint32> newCards;
+
+        for (size_t i = 0; i < count; ++i) {
+            if (collection.fresh[i]) {
+                newCards.push_back(static_cast<quint32>(i));
+                continue;
+            }
+
+            // Cards FSRS never scheduled are as stable as their interval
+            memory[i] = state.stability[i] > 0
+                ? FSRSAlgorithm::Memory<double>{ state.stability[i], state.difficulty[i] }
+                : FSRSAlgorithm::Memory<double>{ std::max(1.0, static_cast<double>(state.interval[i])), FSRSAlgorithm::first<double>(w, 3).difficulty };
+
+            const int due = std::max(0, collection.due_day[i]);
+            if (due < settings.days) dueOn[due].push_back(static_cast<quint32>(i));
+        }
+
+        std::deque<quint32> waiting; // Due and over the review limit
+        size_t nextNew = 0;
+
+        std::vector<quint32> cards;
+        std::vector<quint8> buttons;
+        StateBatch batch;
+
+        for (int day = 0; day < settings.days; ++day) {
+            RunDay& totals = days[day];
+
+            waiting.insert(waiting.end(), dueOn[day].begin(), dueOn[day].end());
+            std::vector<quint32>().swap(dueOn[day]);
+
+            const size_t reviews = settings.max_reviews_per_day > 0 ? std::min<size_t>(settings.max_reviews_per_day, waiting.size()) : waiting.size();
+            const size_t fresh = std::min<size_t>(std::max(0, settings.new_cards_per_day), newCards.size() - nextNew);
+
+            cards.assign(waiting.begin(), waiting.begin() + static_cast<std::ptrdiff_t>(reviews));
+            waiting.erase(waiting.begin(), waiting.begin() + static_cast<std::ptrdiff_t>(reviews));
+            cards.insert(cards.end(), newCards.begin() + static_cast<std::ptrdiff_t>(nextNew), newCards.begin() + static_cast<std::ptrdiff_t>(nextNew + fresh));
+            nextNew += fresh;
+
+            batch.resize(cards.size());
+            buttons.resize(cards.size());
+
+            // Answer every card and copy its state into the day's batch
+            for (size_t k = 0; k < cards.size(); ++k) {
+                const quint32 i = cards[k];
+                int button;
+
+                if (k < reviews) {
+                    const double elapsed = day - last[i];
+                    const bool recalled = chance(random) < FSRSAlgorithm::retrievability(elapsed, memory[i].stability);
+                    button = recalled ? pick(settings.recall_buttons, chance(random)) + 2 : 1;
+                    memory[i] = FSRSAlgorithm::next(w, memory[i], elapsed, button);
+
+                    ++totals.reviews;
+                    totals.recalled += recalled;
+                    totals.seconds += recalled ? settings.review_seconds : settings.again_seconds;
+                    batch.elapsed_days[k] = static_cast<float>(elapsed);
+                } else {
+                    button = pick(settings.first_buttons, chance(random)) + 1;
+                    memory[i] = FSRSAlgorithm::first<double>(w, button);
+
+                    ++totals.new_cards;
+                    totals.seconds += settings.new_seconds;
+                    batch.elapsed_days[k] = 0.0f;
+                }
+
+                buttons[k] = static_cast<quint8>(button);
+                batch.interval[k] = state.interval[i];
+                batch.ease_factor[k] = state.ease_factor[i];
+                batch.repetitions[k] = state.repetitions[i];
+                batch.stability[k] = state.stability[i];
+                batch.difficulty[k] = state.difficulty[i];
+            }
+
+            std::visit([&](const auto& scheduler) { scheduler.calculateBatch(batch, buttons); }, algorithm);
+
+            // Store the new state, Again comes back the next day
+            for (size_t k = 0; k < cards.size(); ++k) {
+                const quint32 i = cards[k];
+                state.interval[i] = batch.interval[k];
+                state.ease_factor[i] = batch.ease_factor[k];
+                state.repetitions[i] = batch.repetitions[k];
+                state.stability[i] = batch.stability[k];
+                state.difficulty[i] = batch.difficulty[k];
+                last[i] = day;
+
+                const int due = day + std::max(1, batch.interval[k]);
+                if (due < settings.days) dueOn[due].push_back(i);
+            }
+        }
+    }
+}
+
+void Simulator::Collection::addNew() {
+    addScheduled(0, 2.5f, 0, 0.0f, 0.0f, 0, 0);
+    fresh.back() = 1;
+}
+
+void Simulator::Collection::addScheduled(const int interval, const float easeFactor, const int repetitions,
+                                         const float stability, const float difficulty, const int lastDay, const int dueDay) {
+    const size_t i = size();
+    state.resize(i + 1);
+    state.interval[i] = interval;
+    state.ease_factor[i] = easeFactor;
+    state.repetitions[i] = repetitions;
+    state.stability[i] = stability;
+    state.difficulty[i] = difficulty;
+
+    last_day.push_back(lastDay);
+    due_day.push_back(dueDay);
+    fresh.push_back(0);
+}
+
+std::optional<Simulator::Collection> Simulator::load(const QString& userID, const QString& deckID) {
+    const auto query = Database::getInstance()->statement(SELECT_SIMULATION_STATE);
+    query->setForwardOnly(true);
+    query->bindValue(0, userID);
+    query->bindValue(1, deckID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to read the deck for the simulation: " + query->lastError().text(), "Simulator");
+        return std::nullopt;
+    }
+
+    // Days are counted from local midnight like the forecast
+    const qint64 dayStart = QDate::currentDate().startOfDay().toSecsSinceEpoch();
+    const auto dayOf = [dayStart](const qint64 seconds) {
+        return static_cast<int>(std::floor((seconds - dayStart) / SECONDS_PER_DAY));
+    };
+
+    Collection collection;
+    while (query->next()) {
+        if (query->value(0).isNull()) {
+            collection.addNew();
+            continue;
+        }
+        collection.addScheduled(query->value(0).toInt(), query->value(1).toFloat(), query->value(2).toInt(),
+                                query->value(3).toFloat(), query->value(4).toFloat(),
+                                std::min(0, dayOf(query->value(5).toLongLong())), std::max(0, dayOf(query->value(6).toLongLong())));
+    }
+    return collection;
+}
+
+Simulator::Report Simulator::run(const Collection& collection, const Algorithms::Any& algorithm, const Settings& settings, const int threads) {
+    QElapsedTimer timer;
+    timer.start();
+
+    Report report;
+    if (settings.days <= 0 || settings.runs <= 0) return report;
+
+    std::vector<std::vector<RunDay>> runs(settings.runs, std::vector<RunDay>(settings.days));
+
+    WorkerPool pool(std::min(threads > 0 ? threads : QThread::idealThreadCount(), settings.runs));
+    pool.run(runs.size(), 1, [&](int, const size_t begin, const size_t end) {
+        for (size_t run = begin; run < end; ++run) simulate(collection, algorithm, settings, static_cast<int>(run), runs[run]);
+    });
+
+    // Added up in run order, the same report for any thread count
+    report.days.resize(settings.days);
+    double reviews = 0, recalled = 0;
+
+    for (int day = 0; day < settings.days; ++day) {
+        double dayRecalled = 0;
+        Day& average = report.days[day];
+
+        for (const std::vector<RunDay>& run : runs) {
+            average.reviews += run[day].reviews;
+            average.new_cards += run[day].new_cards;
+            average.minutes += run[day].seconds / 60.0;
+            dayRecalled += run[day].recalled;
+        }
+
+        average.retention = average.reviews > 0 ? dayRecalled / average.reviews : 0.0;
+        reviews += average.reviews;
+        recalled += dayRecalled;
+
+        average.reviews /= settings.runs;
+        average.new_cards /= settings.runs;
+        average.minutes /= settings.runs;
+        report.total_minutes += average.minutes;
+    }
+
+    report.retention = reviews > 0 ? recalled / reviews : 0.0;
+    report.elapsed_ms = timer.elapsed();
+    return report;
+}
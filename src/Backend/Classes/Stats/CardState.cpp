@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <limits>
+
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "Backend/Classes/Stats/CardState.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+quint32 CardState::toSeconds(const qint64 seconds) {
+    return static_cast<quint32>(std::clamp<qint64>(seconds, 0, std::numeric_limits<quint32>::max()));
+}
+
+// Load the scheduling state of the card, one row whether it was answered or not
+bool CardState::load(const QString& userID, const QString& cardID, CardState& state, bool& scheduled) {
+    const auto query = Database::getInstance()->statement(SELECT_CARD_STATE);
+    query->bindValue(0, userID);
+    query->bindValue(1, cardID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to load card state: " + query->lastError().text(), "CardState");
+        return false;
+    }
+    if (!query->next()) {
+        Logger::error("Card " + cardID + " does not exist", "CardState");
+        return false;
+    }
+
+    state = CardState();
+    state.card_id = query->value(0).toUInt();
+
+    // Never answered, start from the defaults
+    scheduled = !query->value(1).isNull();
+    if (!scheduled) return true;
+
+    state.due = toSeconds(query->value(1).toLongLong());
+    state.last_seen = toSeconds(query->value(2).toLongLong());
+    state.interval = query->value(3).toInt();
+    state.ease_factor = query->value(4).toFloat();
+    state.repetitions = static_cast<quint16>(query->value(5).toUInt());
+    state.lapses = static_cast<quint16>(query->value(6).toUInt());
+    state.stability = query->value(7).toFloat();
+    state.difficulty = query->value(8).toFloat();
+    return true;
+}
+
+// Log the answer and store the state the algorithm produced
+bool CardState::save(const QString& userID, const ReviewEvent& event, const int previousInterval) const {
+    const Database* db = Database::getInstance();
+
+    {
+        const auto query = db->statement(INSERT_REVIEW_LOG);
+        query->bindValue(0, this->card_id);
+        query->bindValue(1, userID);
+        query->bindValue(2, event.answered_at);
+        query->bindValue(3, event.card_type);
+        query->bindValue(4, event.button);
+        query->bindValue(5, previousInterval);
+        query->bindValue(6, this->interval);
+        query->bindValue(7, qRound(this->ease_factor * 1000));
+        query->bindValue(8, event.duration_ms);
+
+        if (!query->exec()) {
+            Logger::error("Failed to log review: " + query->lastError().text(), "CardState");
+            return false;
+        }
+    }
+
+    const auto query = db->statement(UPSERT_CARD_STATE);
+    query->bindValue(0, userID);
+    query->bindValue(1, this->card_id);
+    query->bindValue(2, this->due);
+    query->bindValue(3, this->last_seen);
+    query->bindValue(4, this->interval);
+    query->bindValue(5, this->ease_factor);
+    query->bindValue(6, this->repetitions);
+    query->bindValue(7, this->lapses);
+    query->bindValue(8, this->stability);
+    query->bindValue(9, this->difficulty);
+
+    if (!query->exec()) {
+        Logger::error("Failed to save card state: " + query->lastError().text(), "CardState");
+        return false;
+    }
+
+    return true;
+}
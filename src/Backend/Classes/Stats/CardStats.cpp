@@ -10,6 +10,8 @@
 #include "Backend/Utilities/statsUpdateContext.hpp"
 #include "Backend/Classes/Stats/CardStats.hpp"
 #include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
 
 // Constructors
 CardStats::CardStats(
@@ -63,47 +65,39 @@ void CardStats::setInterval(const int interval) { this->interval = interval; }
 void CardStats::setRepetitions(const int repetitions) { this->repetitions = repetitions; }
 
 // Database Operations
-// Load stats from database
-// Using the reserved keyword "new", clearing memory is required on the frontend
-Stats* CardStats::load() {
+// Load the latest stats row into this object
+bool CardStats::loadLatest() {
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
+    const auto query = db->statement(SELECT_LATEST_CARD_STATS);
 
     Logger::db("Loading card stats", QString("CardID: %1").arg(this->card_id));
 
-    query.prepare(QStringLiteral("SELECT * FROM CardStats WHERE id = ? ORDER BY date DESC LIMIT 1"));
-    query.addBindValue(this->card_id);
+    query->bindValue(0, this->card_id);
 
-    if (!query.exec()) {
-        Logger::error("Failed to load card stats: " + query.lastError().text(), "CardStats");
-        return {};
+    if (!query->exec()) {
+        Logger::error("Failed to load card stats: " + query->lastError().text(), "CardStats");
+        return false;
     }
-    if (!query.next()) return {};
+    if (!query->next()) return false;
 
     // Load stats into object
-    this->card_id = query.value("id").toString();
-    this->user_id = query.value("user_id").toString();
-    this->date = query.value("date").toDate();
-    this->times_seen = query.value("times_seen").toInt();
-    this->time_spent_seconds = query.value("time_spent_seconds").toInt();
-    this->last_seen = query.value("last_seen").toLongLong();
-    this->easeFactor = query.value("ease_factor").toFloat();
-    this->interval = query.value("interval").toInt();
-    this->repetitions = query.value("repetitions").toInt();
-    this->card_start_time = query.value("card_start_time").toLongLong();
-
-    return new CardStats(
-        this->card_id,
-        this->user_id,
-        this->date,
-        this->times_seen,
-        this->time_spent_seconds,
-        this->last_seen,
-        this->easeFactor,
-        this->interval,
-        this->repetitions,
-        this->card_start_time
-    );
+    this->user_id = query->value("user_id").toString();
+    this->date = query->value("date").toDate();
+    this->times_seen = query->value("times_seen").toInt();
+    this->time_spent_seconds = query->value("time_spent_seconds").toInt();
+    this->last_seen = query->value("last_seen").toLongLong();
+    this->easeFactor = query->value("ease_factor").toFloat();
+    this->interval = query->value("interval").toInt();
+    this->repetitions = query->value("repetitions").toInt();
+    this->card_start_time = query->value("card_start_time").toLongLong();
+    return true;
+}
+
+// Load stats from database
+// Using the reserved keyword "new", clearing memory is required on the frontend
+Stats* CardStats::load() {
+    if (!loadLatest()) return {};
+    return new CardStats(*this);
 }
 
 Stats* CardStats::loadTotal() {
@@ -118,41 +112,44 @@ bool CardStats::initialize() const {
     }
 
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
 
     // Check if a record for the current date already exists
-    query.prepare(QStringLiteral("SELECT COUNT(*) FROM CardStats WHERE id = ? AND date = DATE('now')"));
-    query.addBindValue(this->card_id);
+    {
+        const auto query = db->statement(COUNT_CARD_STATS_TODAY);
+        query->bindValue(0, this->card_id);
 
-    if (!query.exec()) {
-        Logger::error("Failed to check existing stats: " + query.lastError().text(), "CardStats");
-        return false;
+        if (!query->exec()) {
+            Logger::error("Failed to check existing stats: " + query->lastError().text(), "CardStats");
+            return false;
+        }
+        if (query->next() && query->value(0).toInt() > 0) return true; // Stats already exist
     }
-    if (query.next() && query.value(0).toInt() > 0) return true; // Stats already exist
 
     // Fetch the most recent stats to carry over
-    query.prepare(QStringLiteral("SELECT ease_factor, interval, repetitions FROM CardStats WHERE id = ? ORDER BY date DESC LIMIT 1"));
-    query.addBindValue(this->card_id);
-
     float latestEaseFactor = 2.5f;
     int latestInterval = 0;
     int latestRepetitions = 0;
+    {
+        const auto query = db->statement(SELECT_CARD_STATS_CARRY_OVER);
+        query->bindValue(0, this->card_id);
 
-    if (query.exec() && query.next()) {
-        latestEaseFactor = query.value(0).toFloat();
-        latestInterval = query.value(1).toInt();
-        latestRepetitions = query.value(2).toInt();
+        if (query->exec() && query->next()) {
+            latestEaseFactor = query->value(0).toFloat();
+            latestInterval = query->value(1).toInt();
+            latestRepetitions = query->value(2).toInt();
+        }
     }
 
     // Insert new stats entry for the current date
-    query.prepare(QStringLiteral("INSERT INTO CardStats (id, user_id, date, ease_factor, interval, repetitions) VALUES (?, (SELECT id FROM SavedUser LIMIT 1), DATE('now'), ?, ?, ?)"));
-    query.addBindValue(this->card_id);
-    query.addBindValue(latestEaseFactor);
-    query.addBindValue(latestInterval);
-    query.addBindValue(latestRepetitions);
-
-    if (!query.exec()) {
-        Logger::error("Failed to save stats for Card: " + query.lastError().text(), "CardStats");
+    const auto query = db->statement(INSERT_CARD_STATS_TODAY);
+    query->bindValue(0, this->card_id);
+    query->bindValue(1, SessionContext::getUserID());
+    query->bindValue(2, latestEaseFactor);
+    query->bindValue(3, latestInterval);
+    query->bindValue(4, latestRepetitions);
+
+    if (!query->exec()) {
+        Logger::error("Failed to save stats for Card: " + query->lastError().text(), "CardStats");
         return false;
     }
 
@@ -206,22 +203,22 @@ bool CardStats::update(const StatsUpdateContext& context) {
     }
 
     // Construct query
-    QString queryString = QString("UPDATE CardStats SET %1 WHERE id = ? AND user_id = ? AND date = DATE('now')")
+    QString queryString = QString("UPDATE CardStats SET %1 WHERE id = (SELECT id FROM Cards WHERE uid = ?) "
+                                  "AND user_id = (SELECT id FROM Users WHERE uid = ?) AND date = DATE('now')")
                           .arg(updates.join(", "));
     bindValues << this->card_id << this->user_id; // Add the card_id and user_id for the WHERE clause
 
-    // Prepare query
-    QSqlQuery query(Database::getInstance()->getDB());
-    query.prepare(queryString);
+    // Prepared once per flag combination
+    const auto query = Database::getInstance()->statement(queryString);
 
     // Bind values
-    for (const auto& value : bindValues) {
-        query.addBindValue(value);
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues[i]);
     }
 
     // Execute query
-    if (!query.exec()) {
-        Logger::error("Failed to update stats: " + query.lastError().text(), "CardStats");
+    if (!query->exec()) {
+        Logger::error("Failed to update stats: " + query->lastError().text(), "CardStats");
         return false;
     }
 
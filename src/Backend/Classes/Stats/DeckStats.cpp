@@ -9,7 +9,10 @@
 
 #include "Backend/Utilities/statsUpdateContext.hpp"
 #include "Backend/Classes/Stats/DeckStats.hpp"
+#include "Backend/Database/rollups.hpp"
 #include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
 
 // Constructors
 DeckStats::DeckStats(
@@ -45,34 +48,30 @@ void DeckStats::setUserID(const QString& id) { this->user_id = id; }
 // Using the reserved keyword "new", clearing memory is required on the frontend
 Stats* DeckStats::load() {
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
 
     // Fetch current user ID
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) return {};
-    const QString currentUserID = userQuery.value(0).toString();
+    const QString currentUserID = SessionContext::getUserID();
+    if (currentUserID.isEmpty()) return {};
 
     Logger::db("Loading deck stats", QString("DeckID: %1").arg(this->deck_id));
 
-    query.prepare(QStringLiteral("SELECT * FROM DeckStats WHERE id = ? AND user_id = ? ORDER BY date DESC LIMIT 1"));
-    query.addBindValue(this->deck_id);
-    query.addBindValue(currentUserID);
+    const auto query = db->statement(SELECT_LATEST_DECK_STATS);
+    query->bindValue(0, this->deck_id);
+    query->bindValue(1, currentUserID);
 
-    if (!query.exec()) {
-        Logger::error("Failed to load deck stats: " + query.lastError().text(), "DeckStats");
+    if (!query->exec()) {
+        Logger::error("Failed to load deck stats: " + query->lastError().text(), "DeckStats");
         return {};
     }
 
-    if (!query.next()) return {};
+    if (!query->next()) return {};
 
-    this->user_id = query.value("user_id").toString();
-    this->deck_id = query.value("id").toString();
-    this->date = query.value("date").toDate();
-    this->cards_added = query.value("cards_added").toInt();
-    this->cards_seen = query.value("cards_seen").toInt();
-    this->time_spent_seconds = query.value("time_spent_seconds").toLongLong();
-    this->session_start_time = query.value("session_start_time").toLongLong();
+    this->user_id = currentUserID;
+    this->date = query->value("date").toDate();
+    this->cards_added = query->value("cards_added").toInt();
+    this->cards_seen = query->value("cards_seen").toInt();
+    this->time_spent_seconds = query->value("time_spent_seconds").toLongLong();
+    this->session_start_time = query->value("session_start_time").toLongLong();
 
     return new DeckStats(
         this->user_id,
@@ -85,30 +84,32 @@ Stats* DeckStats::load() {
     );
 }
 
-Stats* DeckStats::loadTotal() {
-    const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
-
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) return {};
-    const QString currentUserID = userQuery.value(0).toString();
+// Sums of the week, month or all time into this object, from the rollups and today's row
+bool DeckStats::loadPeriod(const StatsPeriod period) {
+    const QString currentUserID = SessionContext::getUserID();
+    if (!StatsRollups::rollOver(currentUserID)) return false;
 
-    query.prepare(QStringLiteral(R"(
-        SELECT SUM(cards_added), SUM(cards_seen), SUM(time_spent_seconds)
-        FROM DeckStats 
-        WHERE id = ? AND user_id = ?
-    )"));
-    query.addBindValue(this->deck_id);
-    query.addBindValue(currentUserID);
+    const auto query = Database::getInstance()->statement(SELECT_DECK_STATS_ROLLUP);
+    query->bindValue(0, currentUserID);
+    query->bindValue(1, this->deck_id);
+    query->bindValue(2, static_cast<int>(period));
 
-    if (!query.exec() || !query.next()) return {};
+    if (!query->exec() || !query->next()) {
+        Logger::error("Failed to load deck stats totals: " + query->lastError().text(), "DeckStats");
+        return false;
+    }
 
     this->user_id = currentUserID;
-    this->cards_added = query.value(0).toInt();
-    this->cards_seen = query.value(1).toInt();
-    this->time_spent_seconds = query.value(2).toLongLong();
-    this->date = QDate::currentDate(); // Use today as a placeholder
+    this->date = QDate::currentDate();
+    this->cards_added = query->value(0).toInt();
+    this->cards_seen = query->value(1).toInt();
+    this->time_spent_seconds = query->value(2).toLongLong();
+    this->session_start_time = 0;
+    return true;
+}
+
+Stats* DeckStats::loadTotal() {
+    if (!loadPeriod(StatsPeriod::AllTime)) return {};
 
     return new DeckStats(
         this->user_id,
@@ -121,38 +122,54 @@ Stats* DeckStats::loadTotal() {
     );
 }
 
+// Sums over every deck of the user, the deck ID stays empty
+DeckStats DeckStats::totalOfUser(const QString& userID, const StatsPeriod period) {
+    DeckStats total(userID, QString());
+    if (!StatsRollups::rollOver(userID)) return total;
+
+    const auto query = Database::getInstance()->statement(SELECT_USER_DECK_STATS_ROLLUP);
+    query->bindValue(0, userID);
+    query->bindValue(1, static_cast<int>(period));
+
+    if (!query->exec() || !query->next()) {
+        Logger::error("Failed to load deck stats totals: " + query->lastError().text(), "DeckStats");
+        return total;
+    }
+
+    total.cards_added = query->value(0).toInt();
+    total.cards_seen = query->value(1).toInt();
+    total.time_spent_seconds = query->value(2).toLongLong();
+    return total;
+}
+
 // Initialize stats to database.
 bool DeckStats::initialize() const {
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
 
-    // Fetch current user ID
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) return false;
-    const QString currentUserID = userQuery.value(0).toString();
+    // The user set on this object, the selected one otherwise
+    const QString currentUserID = !this->user_id.isEmpty() ? this->user_id : SessionContext::getUserID();
+    if (currentUserID.isEmpty()) return false;
 
     // Check if a record for the current date already exists
-    query.prepare(QStringLiteral("SELECT COUNT(*) FROM DeckStats WHERE id = ? AND user_id = ? AND date = DATE('now')"));
-    query.addBindValue(this->deck_id);
-    query.addBindValue(currentUserID);
-
-    if (!query.exec()) {
-        Logger::error("Failed to check existing stats: " + query.lastError().text(), "DeckStats");
-        return false;
+    {
+        const auto query = db->statement(COUNT_DECK_STATS_TODAY);
+        query->bindValue(0, this->deck_id);
+        query->bindValue(1, currentUserID);
+
+        if (!query->exec()) {
+            Logger::error("Failed to check existing stats: " + query->lastError().text(), "DeckStats");
+            return false;
+        }
+        if (query->next() && query->value(0).toInt() > 0) return true; // Stats already exist
     }
-    if (query.next() && query.value(0).toInt() > 0) return true; // Stats already exist
-
-        // Insert new stats entry for the current date
-    query.prepare(QStringLiteral(
-        "INSERT INTO DeckStats (id, user_id, date) "
-        "VALUES (?, ?, DATE('now'))"
-    ));
-    query.addBindValue(this->deck_id);
-    query.addBindValue(currentUserID);
-
-    if (!query.exec()) {
-        Logger::error("Failed to save stats for Deck: " + query.lastError().text(), "DeckStats");
+
+    // Insert new stats entry for the current date
+    const auto query = db->statement(INSERT_DECK_STATS_TODAY);
+    query->bindValue(0, this->deck_id);
+    query->bindValue(1, currentUserID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to save stats for Deck: " + query->lastError().text(), "DeckStats");
         return false;
     }
 
@@ -193,29 +210,27 @@ bool DeckStats::update(const StatsUpdateContext& context) {
         return true;
     }
 
-    // Fetch current user ID
-    QSqlQuery userQuery(db->getDB());
-    userQuery.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1"));
-    if (!userQuery.exec() || !userQuery.next()) return false;
-    const QString currentUserID = userQuery.value(0).toString();
+    // The user set on this object, the selected one otherwise
+    const QString currentUserID = !this->user_id.isEmpty() ? this->user_id : SessionContext::getUserID();
+    if (currentUserID.isEmpty()) return false;
 
     // Construct query
-    QString queryString = QString("UPDATE DeckStats SET %1 WHERE id = ? AND user_id = ? AND date = DATE('now')")
+    QString queryString = QString("UPDATE DeckStats SET %1 WHERE id = (SELECT id FROM Decks WHERE uid = ?) "
+                                  "AND user_id = (SELECT id FROM Users WHERE uid = ?) AND date = DATE('now')")
                           .arg(updates.join(", "));
     bindValues << this->deck_id << currentUserID; // Add the deck_id and user_id for the WHERE clause
 
-    // Prepare query
-    QSqlQuery query(Database::getInstance()->getDB());
-    query.prepare(queryString);
+    // Prepared once per flag combination
+    const auto query = db->statement(queryString);
 
     // Bind values
-    for (const auto& value : bindValues) {
-        query.addBindValue(value);
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues[i]);
     }
 
     // Execute query
-    if (!query.exec()) {
-        Logger::error("Failed to update deck stats: " + query.lastError().text(), "DeckStats");
+    if (!query->exec()) {
+        Logger::error("Failed to update deck stats: " + query->lastError().text(), "DeckStats");
         return false;
     }
 
@@ -9,7 +9,9 @@
 
 #include "Backend/Utilities/statsUpdateContext.hpp"
 #include "Backend/Classes/Stats/UserStats.hpp"
+#include "Backend/Database/rollups.hpp"
 #include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
 
 // Constructors
 UserStats::UserStats(
@@ -36,6 +38,8 @@ UserStats::UserStats()
       times_used(0) {}
 
 // Getters
+QDate UserStats::getDate() const { return date; }
+
 int UserStats::getCardsSeen() const { return cards_seen; }
 
 int UserStats::getPressedAgain() const { return pressed_again; }
@@ -58,28 +62,26 @@ void UserStats::setUserID(const QString& user_id) { this->user_id = user_id; }
 // Using the reserved keyword "new", clearing memory is required on the frontend
 Stats* UserStats::load() {
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
+    const auto query = db->statement(SELECT_LATEST_USER_STATS);
 
     Logger::db("Loading user stats", QString("UserID: %1").arg(this->user_id));
 
-    query.prepare(QStringLiteral("SELECT * FROM UserStats WHERE id = ? ORDER BY date DESC LIMIT 1"));
-    query.addBindValue(this->user_id);
+    query->bindValue(0, this->user_id);
 
-    if (!query.exec()) {
-        Logger::error("Failed to load user stats: " + query.lastError().text(), "UserStats");
+    if (!query->exec()) {
+        Logger::error("Failed to load user stats: " + query->lastError().text(), "UserStats");
         return {};
     }
-    if (!query.next()) return {};
-
-    this->user_id = query.value("id").toString();
-    this->date = query.value("date").toDate();
-    this->cards_seen = query.value("cards_seen").toInt();
-    this->pressed_again = query.value("pressed_again").toInt();
-    this->pressed_hard = query.value("pressed_hard").toInt();
-    this->pressed_good = query.value("pressed_good").toInt();
-    this->pressed_easy = query.value("pressed_easy").toInt();
-    this->time_spent_seconds = query.value("time_spent_seconds").toInt();
-    this->times_used = query.value("times_used").toInt();
+    if (!query->next()) return {};
+
+    this->date = query->value("date").toDate();
+    this->cards_seen = query->value("cards_seen").toInt();
+    this->pressed_again = query->value("pressed_again").toInt();
+    this->pressed_hard = query->value("pressed_hard").toInt();
+    this->pressed_good = query->value("pressed_good").toInt();
+    this->pressed_easy = query->value("pressed_easy").toInt();
+    this->time_spent_seconds = query->value("time_spent_seconds").toInt();
+    this->times_used = query->value("times_used").toInt();
 
     return new UserStats(
         this->user_id,
@@ -94,28 +96,32 @@ Stats* UserStats::load() {
     );
 }
 
-Stats* UserStats::loadTotal() {
-    const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
+// Sums of the week, month or all time into this object, from the rollups and today's row
+bool UserStats::loadPeriod(const StatsPeriod period) {
+    if (!StatsRollups::rollOver(this->user_id)) return false;
 
-    query.prepare(QStringLiteral(R"(
-        SELECT SUM(cards_seen), SUM(pressed_again), SUM(pressed_hard), 
-               SUM(pressed_good), SUM(pressed_easy), SUM(time_spent_seconds),
-               SUM(times_used)
-        FROM UserStats WHERE id = ?
-    )"));
-    query.addBindValue(this->user_id);
+    const auto query = Database::getInstance()->statement(SELECT_USER_STATS_ROLLUP);
+    query->bindValue(0, this->user_id);
+    query->bindValue(1, static_cast<int>(period));
 
-    if (!query.exec() || !query.next()) return {};
+    if (!query->exec() || !query->next()) {
+        Logger::error("Failed to load user stats totals: " + query->lastError().text(), "UserStats");
+        return false;
+    }
 
     this->date = QDate::currentDate();
-    this->cards_seen = query.value(0).toInt();
-    this->pressed_again = query.value(1).toInt();
-    this->pressed_hard = query.value(2).toInt();
-    this->pressed_good = query.value(3).toInt();
-    this->pressed_easy = query.value(4).toInt();
-    this->time_spent_seconds = query.value(5).toInt();
-    this->times_used = query.value(6).toInt();
+    this->cards_seen = query->value(0).toInt();
+    this->pressed_again = query->value(1).toInt();
+    this->pressed_hard = query->value(2).toInt();
+    this->pressed_good = query->value(3).toInt();
+    this->pressed_easy = query->value(4).toInt();
+    this->time_spent_seconds = query->value(5).toInt();
+    this->times_used = query->value(6).toInt();
+    return true;
+}
+
+Stats* UserStats::loadTotal() {
+    if (!loadPeriod(StatsPeriod::AllTime)) return {};
 
     return new UserStats(
         this->user_id,
@@ -133,26 +139,32 @@ Stats* UserStats::loadTotal() {
 // Initialize stats to database.
 bool UserStats::initialize() const {
     const Database* db = Database::getInstance();
-    QSqlQuery query(db->getDB());
 
     // Check if a record for the current date already exists
-    query.prepare(QStringLiteral("SELECT COUNT(*) FROM UserStats WHERE id = ? AND date = DATE('now')"));
-    query.addBindValue(this->user_id);
+    {
+        const auto query = db->statement(COUNT_USER_STATS_TODAY);
+        query->bindValue(0, this->user_id);
 
-    if (!query.exec()) {
-        Logger::error("Failed to check existing stats: " + query.lastError().text(), "UserStats");
-        return false;
+        if (!query->exec()) {
+            Logger::error("Failed to check existing stats: " + query->lastError().text(), "UserStats");
+            return false;
+        }
+        if (query->next() && query->value(0).toInt() > 0) return true; // Stats already exist
     }
-    if (query.next() && query.value(0).toInt() > 0) return true; // Stats already exist
 
-        // Insert new stats entry for the current date
-        query.prepare(QStringLiteral("INSERT INTO UserStats (id, date) VALUES (?, DATE('now'))"));
-        query.addBindValue(this->user_id);
+    // Insert new stats entry for the current date
+    const auto query = db->statement(INSERT_USER_STATS_TODAY);
+    query->bindValue(0, this->user_id);
 
-        if (!query.exec()) {
-            Logger::error("Failed to save stats for User: " + query.lastError().text(), "UserStats");
-            return false;
-        }
+    if (!query->exec()) {
+        Logger::error("Failed to save stats for User: " + query->lastError().text(), "UserStats");
+        return false;
+    }
+
+    // First row of a new day, the days before it are final now
+    if (!StatsRollups::rollOver(this->user_id)) {
+        Logger::warn("Stats rollups are behind, they catch up on the next read", "UserStats");
+    }
 
     return true;
 }
@@ -201,22 +213,21 @@ bool UserStats::update(const StatsUpdateContext& context) {
     }
 
     // Construct query
-    QString queryString = QString("UPDATE UserStats SET %1 WHERE id = ? AND date = DATE('now')")
+    QString queryString = QString("UPDATE UserStats SET %1 WHERE id = (SELECT id FROM Users WHERE uid = ?) AND date = DATE('now')")
                           .arg(updates.join(", "));
     bindValues << this->user_id; // Add the user_id for the WHERE clause
 
-    // Prepare query
-    QSqlQuery query(Database::getInstance()->getDB());
-    query.prepare(queryString);
+    // Prepared once per flag combination
+    const auto query = Database::getInstance()->statement(queryString);
 
     // Bind values
-    for (const auto& value : bindValues) {
-        query.addBindValue(value);
+    for (int i = 0; i < bindValues.size(); ++i) {
+        query->bindValue(i, bindValues[i]);
     }
 
     // Execute query
-    if (!query.exec()) {
-        Logger::error("Failed to update user stats: " + query.lastError().text(), "UserStats");
+    if (!query->exec()) {
+        Logger::error("Failed to update user stats: " + query->lastError().text(), "UserStats");
         return false;
     }
 
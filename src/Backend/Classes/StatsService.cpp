@@ -0,0 +1,285 @@
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "Backend/Classes/StatsService.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Database/rollups.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+#include "Backend/Utilities/statsDay.hpp"
+
+namespace {
+    // Everything submitted is in the database before it is read
+    void flushAnswers() {
+        if (!ReviewCommitter::getInstance()->flush()) {
+            Logger::warn("Some answers are not saved yet, stats leave them out", "StatsService");
+        }
+    }
+}
+
+// Define static members
+std::mutex StatsService::mutex;
+QString StatsService::userID;
+StatsService::Snapshot StatsService::snapshot;
+StatsListener* StatsService::listener = nullptr;
+
+bool StatsService::ensureLoaded(const QString& userID) {
+    // The day the UserStats rows are dated by
+    const QDate today = statsToday();
+    if (StatsService::userID == userID && snapshot.date == today) return true;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Answers submitted so far are counted by the database, later ones by the events
+    flushAnswers();
+
+    Snapshot loaded;
+    loaded.date = today;
+
+    // Rolls the finished days up first
+    UserStats total(userID);
+    if (!total.loadPeriod(StatsPeriod::AllTime)) return false;
+    loaded.total = { total.getCardsSeen(), total.getPressedAgain(), total.getPressedHard(), total.getPressedGood(),
+                     total.getPressedEasy(), total.getTimeSpentSeconds(), total.getTimesUsed() };
+
+    UserStats latest(userID);
+    if (Stats* ptr = latest.load()) {
+        delete ptr;
+        if (latest.getDate() == today) {
+            loaded.today = { latest.getCardsSeen(), latest.getPressedAgain(), latest.getPressedHard(), latest.getPressedGood(),
+                             latest.getPressedEasy(), latest.getTimeSpentSeconds(), latest.getTimesUsed() };
+        }
+    }
+
+    const auto query = Database::getInstance()->statement(SELECT_DECK_STATS_ROLLUP_BY_DECK);
+    query->setForwardOnly(true);
+    query->bindValue(0, userID);
+    query->bindValue(1, static_cast<int>(StatsPeriod::AllTime));
+
+    if (!query->exec()) {
+        Logger::error("Failed to read deck stats totals: " + query->lastError().text(), "StatsService");
+        return false;
+    }
+
+    while (query->next()) {
+        const DeckTotals deck = { query->value(1).toInt(), query->value(2).toInt(), query->value(3).toLongLong() };
+        loaded.decks.emplace(query->value(0).toString(), deck);
+
+        loaded.decks_total.cards_added += deck.cards_added;
+        loaded.decks_total.cards_seen += deck.cards_seen;
+        loaded.decks_total.time_spent_seconds += deck.time_spent_seconds;
+    }
+
+    snapshot = std::move(loaded);
+    StatsService::userID = userID;
+
+    Logger::info(QString("Stats loaded in %1 ms").arg(QString::number(timer.elapsed())), "StatsService");
+    return true;
+}
+
+bool StatsService::isCurrent(const QString& userID) {
+    if (StatsService::userID != userID) return false;
+
+    // From another day, the next read starts over
+    if (snapshot.date != statsToday()) {
+        StatsService::userID.clear();
+        snapshot = Snapshot();
+        return false;
+    }
+    return true;
+}
+
+UserStats StatsService::toUserStats(const UserTotals& totals) {
+    return UserStats(userID, snapshot.date, totals.cards_seen, totals.pressed_again, totals.pressed_hard,
+                     totals.pressed_good, totals.pressed_easy, totals.time_spent_seconds, totals.times_used);
+}
+
+UserStats StatsService::userTotal(const QString& userID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureLoaded(userID)) return UserStats(userID);
+    return toUserStats(snapshot.total);
+}
+
+UserStats StatsService::userToday(const QString& userID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureLoaded(userID)) return UserStats(userID);
+    return toUserStats(snapshot.today);
+}
+
+DeckStats StatsService::deckTotal(const QString& userID, const QString& deckID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureLoaded(userID)) return DeckStats(userID, deckID);
+
+    DeckTotals totals = snapshot.decks_total;
+    if (!deckID.isEmpty()) {
+        const auto it = snapshot.decks.find(deckID);
+        totals = it != snapshot.decks.end() ? it->second : DeckTotals{};
+    }
+    return DeckStats(userID, deckID, snapshot.date, totals.cards_added, totals.cards_seen, totals.time_spent_seconds, 0);
+}
+
+void StatsService::expireCounts() {
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    if (!snapshot.counts.empty() && now - snapshot.counts_read_at < COUNTS_MAX_AGE) return;
+
+    snapshot.counts.clear();
+    snapshot.all_counts = false;
+    snapshot.counts_read_at = now;
+}
+
+std::unordered_map<QString, DeckCounts> StatsService::counts(const QString& userID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureLoaded(userID)) return {};
+
+    expireCounts();
+    if (!snapshot.all_counts) {
+        flushAnswers();
+        snapshot.counts = DeckCounters::load(userID);
+        snapshot.all_counts = true;
+    }
+    return snapshot.counts;
+}
+
+DeckCounts StatsService::counts(const QString& userID, const QString& deckID) {
+    std::lock_guard lock(mutex);
+    if (userID.isEmpty() || !ensureLoaded(userID)) return {};
+
+    expireCounts();
+    auto it = snapshot.counts.find(deckID);
+    if (it == snapshot.counts.end()) {
+        flushAnswers();
+        const std::optional<DeckCounts> loaded = DeckCounters::load(userID, deckID);
+        if (!loaded) return {};
+        it = snapshot.counts.emplace(deckID, *loaded).first;
+    }
+    return it->second;
+}
+
+void StatsService::cardAnswered(const QString& userID, const QString& deckID, const int buttonPressed) {
+    {
+        std::lock_guard lock(mutex);
+
+        if (isCurrent(userID)) {
+            for (UserTotals* totals : { &snapshot.total, &snapshot.today }) {
+                ++totals->cards_seen;
+                switch (buttonPressed) {
+                    case 1: ++totals->pressed_again; break;
+                    case 2: ++totals->pressed_hard; break;
+                    case 3: ++totals->pressed_good; break;
+                    case 4: ++totals->pressed_easy; break;
+                }
+            }
+
+            ++snapshot.decks[deckID].cards_seen;
+            ++snapshot.decks_total.cards_seen;
+
+            snapshot.counts.erase(deckID);
+            snapshot.all_counts = false;
+        }
+    }
+
+    notify(StatsChange::User);
+    notify(StatsChange::Deck, deckID);
+    notify(StatsChange::Counts, deckID);
+}
+
+void StatsService::cardAdded(const QString& userID, const QString& deckID) {
+    {
+        std::lock_guard lock(mutex);
+
+        if (isCurrent(userID)) {
+            ++snapshot.decks[deckID].cards_added;
+            ++snapshot.decks_total.cards_added;
+
+            snapshot.counts.erase(deckID);
+            snapshot.all_counts = false;
+        }
+    }
+
+    notify(StatsChange::Deck, deckID);
+    notify(StatsChange::Counts, deckID);
+}
+
+void StatsService::cardsChanged() {
+    {
+        std::lock_guard lock(mutex);
+        snapshot.counts.clear();
+        snapshot.all_counts = false;
+    }
+
+    notify(StatsChange::Counts);
+}
+
+void StatsService::deckDeleted(const QString& deckID) {
+    {
+        std::lock_guard lock(mutex);
+
+        // Its stats rows go with it
+        const auto it = snapshot.decks.find(deckID);
+        if (it != snapshot.decks.end()) {
+            snapshot.decks_total.cards_added -= it->second.cards_added;
+            snapshot.decks_total.cards_seen -= it->second.cards_seen;
+            snapshot.decks_total.time_spent_seconds -= it->second.time_spent_seconds;
+            snapshot.decks.erase(it);
+        }
+        snapshot.counts.erase(deckID);
+    }
+
+    notify(StatsChange::Deck, deckID);
+    notify(StatsChange::Counts, deckID);
+}
+
+void StatsService::timeSpent(const QString& userID, const QString& deckID, const qint64 seconds) {
+    {
+        std::lock_guard lock(mutex);
+
+        if (isCurrent(userID)) {
+            snapshot.decks[deckID].time_spent_seconds += seconds;
+            snapshot.decks_total.time_spent_seconds += seconds;
+        }
+    }
+
+    notify(StatsChange::Deck, deckID);
+}
+
+void StatsService::appLaunched(const QString& userID) {
+    {
+        std::lock_guard lock(mutex);
+
+        if (isCurrent(userID)) {
+            ++snapshot.total.times_used;
+            ++snapshot.today.times_used;
+        }
+    }
+
+    notify(StatsChange::User);
+}
+
+void StatsService::invalidate() {
+    {
+        std::lock_guard lock(mutex);
+        userID.clear();
+        snapshot = Snapshot();
+    }
+
+    notify(StatsChange::User);
+    notify(StatsChange::Counts);
+}
+
+void StatsService::setListener(StatsListener* listener) {
+    std::lock_guard lock(mutex);
+    StatsService::listener = listener;
+}
+
+void StatsService::notify(const StatsChange change, const QString& deckID) {
+    StatsListener* current;
+    {
+        std::lock_guard lock(mutex);
+        current = listener;
+    }
+    if (current) current->statsChanged(change, deckID);
+}
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <unordered_set>
+
+#include <QDateTime>
+#include <QSqlError>
+#include <QSqlQuery>
+
+#include "Backend/Classes/StudySession.hpp"
+#include "Backend/Classes/AnswerTimes.hpp"
+#include "Backend/Classes/Deck.hpp"
+#include "Backend/Classes/Heatmap.hpp"
+#include "Backend/Classes/Stats/DeckStats.hpp"
+#include "Backend/Classes/StatsService.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Utilities/Logger.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
+#include "Backend/Utilities/statsUpdateContext.hpp"
+
+StudySession::StudySession(const std::vector<QString>& deckIDs) : deckIDs(deckIDs) {}
+
+bool StudySession::isActive() const { return active; }
+
+int StudySession::getQueueSize() const { return static_cast<int>(queue.size() + learning.size()); }
+
+QString StudySession::getCurrentDeckID() const { return currentDeckID; }
+
+std::optional<qint64> StudySession::getNextLearningDue() const {
+    if (learning.empty()) return std::nullopt;
+    return learning.top().due;
+}
+
+void StudySession::push(QueuedCard entry) {
+    entry.order = nextOrder++;
+    queue.push(std::move(entry));
+}
+
+void StudySession::pushLearning(QueuedCard entry) {
+    entry.order = nextOrder++;
+    learning.push(std::move(entry));
+}
+
+void StudySession::prefetch() {
+    if (!prefetcher) return;
+
+    while (cursor < upcoming.size() && prefetcher->pending() + CardPrefetcher::BATCH_SIZE <= PREFETCH_WINDOW) {
+        const size_t end = std::min(upcoming.size(), cursor + CardPrefetcher::BATCH_SIZE);
+        prefetcher->request(std::vector<QString>(upcoming.begin() + static_cast<std::ptrdiff_t>(cursor),
+                                                 upcoming.begin() + static_cast<std::ptrdiff_t>(end)));
+        cursor = end;
+    }
+}
+
+bool StudySession::start() {
+    Logger::info(QString("Starting Study Session (%1)").arg(deckIDs.empty() ? QString("all decks") : QString("%1 deck(s)").arg(deckIDs.size())), "StudySession");
+
+    this->userID = SessionContext::getUserID();
+    if (this->userID.isEmpty()) {
+        Logger::error("Could not retrieve user ID for the study session", "StudySession");
+        return false;
+    }
+
+    const Database* db = Database::getInstance();
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const std::unordered_set<QString> wanted(deckIDs.begin(), deckIDs.end());
+
+    // What every deck already studied today
+    std::unordered_map<QString, std::pair<int, int>> studiedToday;
+    {
+        const auto query = db->statement(SELECT_STUDIED_TODAY_BY_DECK);
+        query->bindValue(0, this->userID);
+        if (!query->exec()) {
+            Logger::error("Failed to count cards studied today: " + query->lastError().text(), "StudySession");
+            return false;
+        }
+        while (query->next()) {
+            studiedToday[query->value("deck_id").toString()] = { query->value("new_studied").toInt(), query->value("reviews_studied").toInt() };
+        }
+    }
+
+    // Every card of every deck in one pass
+    const auto query = db->statement(SELECT_SESSION_CARDS);
+    query->bindValue(0, now);
+    query->bindValue(1, this->userID);
+
+    if (!query->exec()) {
+        Logger::error("Could not retrieve cards for study: " + query->lastError().text(), "StudySession");
+        return false;
+    }
+
+    std::vector<QueuedCard> ready;
+    while (query->next()) {
+        const QString deckID = query->value("deck_id").toString();
+        if (!wanted.empty() && !wanted.contains(deckID)) continue;
+
+        auto [it, inserted] = indexes.try_emplace(deckID);
+        DueIndex& index = it->second;
+        if (inserted) {
+            const DeckSettings settings = SessionContext::getDeckSettings(deckID).value_or(DeckSettings{});
+            const auto studied = studiedToday[deckID];
+            index.setLimits(settings.daily_new_card_limit, settings.max_review_cards, studied.first, studied.second);
+        }
+
+        const QString cardID = query->value("id").toString();
+        const CardType type = Card::stringToType(query->value("type").toString());
+        const QVariant due = query->value("due");
+        index.add(cardID, type, due.isNull() ? std::nullopt : std::optional<qint64>(due.toLongLong()), now);
+
+        if (!query->value("ready").toBool()) continue;
+        ready.push_back({ due.toLongLong(), 0, cardID, type, deckID, std::nullopt });
+    }
+
+    // Only queue what the daily limits of each deck still allow
+    std::unordered_map<QString, DueIndex::Counts> budget;
+    for (auto& [deckID, index] : indexes) {
+        index.finish();
+        budget[deckID] = index.counts(now);
+    }
+
+    std::unordered_set<QString> queued;
+    for (const QueuedCard& entry : ready) {
+        // A card shared by several decks is studied once
+        if (!queued.insert(entry.card_id).second) continue;
+
+        DueIndex::Counts& left = budget[entry.deck_id];
+        if (entry.type == CardType::New) {
+            if (left.available_new <= 0) continue;
+            --left.available_new;
+        } else if (entry.type == CardType::Review) {
+            if (left.due_reviews <= 0) continue;
+            --left.due_reviews;
+        }
+
+        // Same order as the queue hands them out, the list is sorted by due already
+        upcoming.push_back(entry.card_id);
+        push(entry);
+    }
+
+    if (queue.empty()) {
+        Logger::info("No cards available for study (limits reached or nothing due)", "StudySession");
+        indexes.clear();
+        return false;
+    }
+
+    prefetcher = std::make_unique<CardPrefetcher>();
+    prefetcher->start();
+    prefetch();
+
+    this->active = true;
+    Logger::info(QString("Study session ready. Cards queued: %1").arg(QString::number(queue.size())), "StudySession");
+    return true;
+}
+
+Card StudySession::getNextCard() {
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    for (;;) {
+        QueuedCard next;
+        // A learning step that is over goes before the rest
+        if (!learning.empty() && learning.top().due <= now) {
+            next = learning.top();
+            learning.pop();
+        } else if (!queue.empty()) {
+            next = queue.top();
+            queue.pop();
+            prefetch();
+        } else {
+            break;
+        }
+
+        // Another deck may still have room, only this card is skipped
+        DueIndex& index = indexes[next.deck_id];
+        const CardType type = next.type;
+        const bool overLimit = (type == CardType::New || type == CardType::Review) && !index.canStudy(type);
+        // A card without any state counts as new even if its type says otherwise
+        const bool overNewLimit = type != CardType::New && !index.isScheduled(next.card_id) && !index.canStudy(CardType::New);
+
+        if (overLimit || overNewLimit) {
+            if (overLimit) Logger::info("Daily limit reached for deck " + next.deck_id, "StudySession");
+            if (!next.card) prefetcher->discard(next.card_id);
+            continue;
+        }
+
+        if (!next.card) {
+            const auto text = prefetcher->take(next.card_id);
+            if (!text) {
+                Logger::warn("Card " + next.card_id + " is gone, skipped", "StudySession");
+                continue;
+            }
+            next.card.emplace(next.card_id, text->first, text->second, type);
+        }
+
+        // Timed in memory, the answer stores how long it took
+        this->currentDeckID = next.deck_id;
+        this->cardShown.start();
+        return *next.card;
+    }
+
+    if (learning.empty()) Logger::info("Study Queue is empty", "StudySession");
+    return {};
+}
+
+bool StudySession::processCardResponse(Card& card, const int buttonPressed) {
+    if (this->currentDeckID.isEmpty()) {
+        Logger::error("Process Card Response - No card was handed out", "StudySession");
+        return false;
+    }
+
+    if (card.getID().isEmpty()) {
+        Logger::error("Process Card Response - Missing Card ID", "StudySession");
+        return false;
+    }
+
+    ReviewEvent event;
+    event.user_id = this->userID;
+    event.deck_id = this->currentDeckID;
+    event.card_id = card.getID();
+    event.card_type = static_cast<int>(card.getType());
+    event.button = buttonPressed;
+    event.answered_at = QDateTime::currentMSecsSinceEpoch();
+    event.duration_ms = this->cardShown.isValid() ? this->cardShown.elapsed() : 0;
+
+    // Applied in place when the committer is not running
+    if (!ReviewCommitter::getInstance()->submit(event) && !Deck::applyCardResponse(event)) {
+        return false;
+    }
+    Heatmap::cardAnswered(this->userID, event.answered_at, event.duration_ms);
+    AnswerTimes::cardAnswered(this->userID, event.deck_id, event.duration_ms);
+    // Last, open views read everything above again when told
+    StatsService::cardAnswered(this->userID, event.deck_id, buttonPressed);
+
+    this->timeSpent[event.deck_id] += event.duration_ms;
+
+    // Handle Learning cards (Again or Hard)
+    const bool relearn = buttonPressed == 1 || buttonPressed == 2;
+    const CardType previousType = card.getType();
+    card.setType(relearn ? CardType::Learning : CardType::Review);
+    this->indexes[event.deck_id].answered(card.getID(), previousType, card.getType());
+
+    // Shown again once its step is over
+    if (relearn) {
+        const qint64 step = buttonPressed == 1 ? AGAIN_STEP : HARD_STEP;
+        pushLearning({ event.answered_at / 1000 + step, 0, card.getID(), card.getType(), event.deck_id, card });
+    }
+
+    return true;
+}
+
+bool StudySession::end() {
+    if (!this->active) return false;
+    Logger::info("Ending Study Session", "StudySession");
+
+    // Answers still queued belong to this session
+    if (!ReviewCommitter::getInstance()->flush()) {
+        Logger::warn("Some answers are not saved yet, they are kept in the journal", "StudySession");
+    }
+    if (!AnswerTimes::save()) {
+        Logger::warn("Failed to save answer times", "StudySession");
+    }
+
+    // Time spent is the time cards were on screen, per deck
+    bool status = true;
+    for (const auto& [deckID, milliseconds] : this->timeSpent) {
+        DeckStats deckStats;
+        deckStats.setDeckID(deckID);
+        deckStats.setUserID(this->userID);
+
+        if (!deckStats.initialize()) {
+            status = false;
+            continue;
+        }
+
+        StatsUpdateContext context;
+        context.type = StatsUpdateType::Deck;
+        context.deck.update_time_spent = true;
+        context.deck.time_spent_increment = static_cast<int>(milliseconds / 1000);
+
+        if (!deckStats.update(context)) {
+            Logger::error("Failed to update deck stats at session end", "StudySession");
+            status = false;
+            continue;
+        }
+        StatsService::timeSpent(this->userID, deckID, context.deck.time_spent_increment);
+    }
+
+    Logger::info(QString("Study session ended, %1 deck(s) studied").arg(QString::number(this->timeSpent.size())), "StudySession");
+
+    this->prefetcher.reset();
+    this->queue = {};
+    this->learning = {};
+    this->upcoming.clear();
+    this->cursor = 0;
+    this->indexes.clear();
+    this->timeSpent.clear();
+    this->currentDeckID.clear();
+    this->cardShown.invalidate();
+    this->active = false;
+    return status;
+}
+
+std::vector<int> StudySession::getCardInformation() {
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    std::vector<int> counts = { 0, 0, 0 };
+    for (auto& [deckID, index] : this->indexes) {
+        const DueIndex::Counts deckCounts = index.counts(now);
+        counts[0] += deckCounts.available_new;
+        counts[1] += deckCounts.learning;
+        counts[2] += deckCounts.due_reviews;
+    }
+    return counts;
+}
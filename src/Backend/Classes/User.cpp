@@ -4,8 +4,11 @@
 #include <QString>
 
 #include "Backend/Classes/User.hpp"
+#include "Backend/Classes/StatsService.hpp"
+#include "Backend/Database/committer.hpp"
 #include "Backend/Database/setup.hpp"
 #include "Backend/Utilities/createUniqueUser.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
 
 // Constructors
 User::User(const QString& name, const QString& id)
@@ -27,7 +30,7 @@ QString User::getUsername() const {
         const Database *db = Database::getInstance();
         QSqlQuery query(db->getDB());
 
-        query.prepare(QStringLiteral("SELECT username FROM Users WHERE id = ?"));
+        query.prepare(QStringLiteral("SELECT username FROM Users WHERE uid = ?"));
         query.addBindValue(this->id);
 
         if (!query.exec() || !query.next()){
@@ -99,7 +102,7 @@ bool User::_delete() const {
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("DELETE FROM Users WHERE id = ?;"));
+    query.prepare(QStringLiteral("DELETE FROM Users WHERE uid = ?;"));
     query.addBindValue(this->id);
 
     if (!query.exec()) {
@@ -107,6 +110,8 @@ bool User::_delete() const {
         return false;
     }
 
+    SessionContext::invalidateUser();
+
     return true; // UsersDecks and UserStats are cleaned up automatically.
 }
 
@@ -122,11 +127,11 @@ User User::fetch() const {
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("SELECT * FROM Users WHERE id = ?;"));
+    query.prepare(QStringLiteral("SELECT uid AS id, username FROM Users WHERE uid = ?;"));
     query.addBindValue(this->id);
 
     if (!query.exec() || !query.next()) {
-        query.prepare(QStringLiteral("SELECT * FROM Users WHERE username = ?;"));
+        query.prepare(QStringLiteral("SELECT uid AS id, username FROM Users WHERE username = ?;"));
         query.addBindValue(this->username);
 
         if (!query.exec() || !query.next()) {
@@ -148,17 +153,13 @@ User User::fetch() const {
 bool User::fetchSelected() {
     logAction("Fetch Selected User");
 
-    const Database *db = Database::getInstance();
-    QSqlQuery query(db->getDB());
-
-    query.prepare(QStringLiteral("SELECT id FROM SavedUser LIMIT 1;"));
-
-    if (!query.exec() || !query.next()) {
+    const QString selectedID = SessionContext::getUserID();
+    if (selectedID.isEmpty()) {
         qDebug() << "[DB] No selected user found.";
         return false;
     }
 
-    this->id = query.value(0).toString();
+    this->id = selectedID;
     return true;
 }
 
@@ -175,7 +176,7 @@ bool User::select() const {
     QSqlQuery query(db->getDB());
 
     // Prepare the SQL query to select the user
-    query.prepare(QStringLiteral("SELECT username FROM Users WHERE id = ?;"));
+    query.prepare(QStringLiteral("SELECT id, username FROM Users WHERE uid = ?;"));
     query.addBindValue(this->id);
 
     // Execute the query and check for errors
@@ -185,6 +186,12 @@ bool User::select() const {
     }
 
     const QString username = query.value(QStringLiteral("username")).toString();
+    const qint64 userKey = query.value(QStringLiteral("id")).toLongLong();
+
+    // Answers still queued belong to the user selected until now
+    if (!ReviewCommitter::getInstance()->flush()) {
+        qDebug() << "[DB] Some answers are not saved yet, they keep the user who gave them";
+    }
 
     // Check if there is a saved user
     query.prepare(QStringLiteral("SELECT COUNT(*) FROM SavedUser LIMIT 1"));
@@ -197,13 +204,14 @@ bool User::select() const {
     if (query.value(0).toInt() == 0) query.prepare(QStringLiteral("INSERT INTO SavedUser (id) VALUES (?);"));
     else query.prepare(QStringLiteral("UPDATE SavedUser SET id = ?;"));
 
-    query.addBindValue(this->id);
+    query.addBindValue(userKey);
 
     if (!query.exec()) {
         qDebug() << "[DB] Failed to save selected user ID:" << query.lastError().text();
         return false;
     }
 
+    SessionContext::invalidateUser();
     qDebug() << "[DB] Selected User" << username;
     return true;
 }
@@ -224,7 +232,7 @@ bool User::rename(const QString &username) {
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("UPDATE Users SET username = ? WHERE id = ?;"));
+    query.prepare(QStringLiteral("UPDATE Users SET username = ? WHERE uid = ?;"));
     query.addBindValue(username);
     query.addBindValue(this->id);
 
@@ -253,7 +261,7 @@ bool User::updateLaunchStats() const {
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("UPDATE UserStats SET times_used = times_used + 1 WHERE id = ? AND date = DATE('now');"));
+    query.prepare(QStringLiteral("UPDATE UserStats SET times_used = times_used + 1 WHERE id = (SELECT id FROM Users WHERE uid = ?) AND date = DATE('now');"));
     query.addBindValue(this->id);
 
     if (!query.exec()) {
@@ -261,6 +269,7 @@ bool User::updateLaunchStats() const {
         return false;
     }
 
+    StatsService::appLaunched(this->id);
     return true;
 }
 
@@ -272,29 +281,15 @@ std::vector<Deck> User::listDecks() const {
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    // Retrieve all deck IDs for the user
-    query.prepare(QStringLiteral("SELECT deck_id FROM UsersDecks WHERE user_id = ?"));
+    // Retrieve all decks of the user in creation order
+    query.prepare(QStringLiteral(R"(
+            SELECT d.uid AS id, d.name FROM Decks d
+            INNER JOIN UsersDecks ud ON d.id = ud.deck_id
+            WHERE ud.user_id = (SELECT id FROM Users WHERE uid = ?)
+            ORDER BY d.id
+        )"));
     query.addBindValue(this->id);
 
-    if (!query.exec()) {
-        qDebug() << "Failed to retrieve deck IDs:" << query.lastError().text();
-        return decks;
-    }
-
-    QStringList deckIds;
-    while (query.next()) {
-        deckIds << query.value(0).toString(); // Use column index 0 for deck_id
-    }
-
-    if (deckIds.isEmpty()) return decks; // No decks found
-
-    // Retrieve all decks using a single query, quote deck IDs properly
-    QStringList quotedDeckIds;
-    for (const QString& deckId : deckIds) {
-        quotedDeckIds << QStringLiteral("'") + deckId + QStringLiteral("'");  // Ensure each deck_id is wrapped in single quotes
-    }
-
-    query.prepare(QStringLiteral("SELECT id, name FROM Decks WHERE id IN (%1)").arg(quotedDeckIds.join(", ")));
     if (!query.exec()) {
         qDebug() << "Failed to retrieve decks:" << query.lastError().text();
         return decks;
@@ -318,7 +313,7 @@ std::vector<User> User::listUsers() {
     const Database *db = Database::getInstance();
     QSqlQuery query(db->getDB());
 
-    query.prepare(QStringLiteral("SELECT * FROM Users;"));
+    query.prepare(QStringLiteral("SELECT uid AS id, username FROM Users ORDER BY Users.id;"));
     if (!query.exec()) {
         qDebug() << "[DB] Failed to list users:" << query.lastError().text();
         return users;
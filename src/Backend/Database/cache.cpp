@@ -0,0 +1,61 @@
+#include <QSqlError>
+
+#include "Backend/Database/cache.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+std::atomic<quint64> StatementCache::totalHits{0};
+std::atomic<quint64> StatementCache::totalMisses{0};
+
+StatementCache::StatementCache(const QSqlDatabase& db) : db(db) {}
+
+std::unique_ptr<QSqlQuery> StatementCache::prepare(const QString& sql) {
+    auto query = std::make_unique<QSqlQuery>(db);
+    if (!query->prepare(sql)) {
+        // Still handed out, exec() will fail and report the error to the caller
+        Logger::error("Failed to prepare statement: " + query->lastError().text(), "StatementCache");
+    }
+    return query;
+}
+
+Statement StatementCache::get(const char* sql) {
+    auto it = statements.find(sql);
+    if (it != statements.end()) {
+        ++counters.hits;
+        ++totalHits;
+        return Statement(*it->second);
+    }
+
+    ++counters.misses;
+    ++totalMisses;
+    it = statements.emplace(sql, prepare(QString::fromUtf8(sql))).first;
+    return Statement(*it->second);
+}
+
+Statement StatementCache::get(const QString& sql) {
+    auto it = dynamicStatements.find(sql);
+    if (it != dynamicStatements.end()) {
+        ++counters.hits;
+        ++totalHits;
+        return Statement(*it->second);
+    }
+
+    ++counters.misses;
+    ++totalMisses;
+    it = dynamicStatements.emplace(sql, prepare(sql)).first;
+    return Statement(*it->second);
+}
+
+void StatementCache::clear() {
+    statements.clear();
+    dynamicStatements.clear();
+}
+
+int StatementCache::size() const {
+    return static_cast<int>(statements.size() + dynamicStatements.size());
+}
+
+StatementCache::Counters StatementCache::getCounters() const { return counters; }
+
+StatementCache::Counters StatementCache::getTotalCounters() {
+    return { totalHits.load(), totalMisses.load() };
+}
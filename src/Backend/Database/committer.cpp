@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <chrono>
+
+#include <QSqlError>
+#include <QThread>
+
+#include "Backend/Database/committer.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Database/transaction.hpp"
+#include "Backend/Classes/Deck.hpp"
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+// Define static members
+std::unique_ptr<ReviewCommitter> ReviewCommitter::instance;
+std::once_flag ReviewCommitter::initInstanceFlag;
+
+ReviewCommitter::ReviewCommitter(const QString& journalPath) : journal(journalPath) {}
+
+ReviewCommitter::~ReviewCommitter() {
+    stop();
+}
+
+ReviewCommitter* ReviewCommitter::getInstance() {
+    std::call_once(initInstanceFlag, []() {
+        instance.reset(new ReviewCommitter(Database::getInstance()->getPath() + ".answers"));
+    });
+    return instance.get();
+}
+
+bool ReviewCommitter::start() {
+    std::lock_guard lock(mutex);
+    if (running) return true;
+
+    const Database* db = Database::getInstance();
+
+    // Two writers need a busy timeout, the legacy profile keeps answering in place
+    if (db->getProfile().busy_timeout <= 0) {
+        Logger::info("Busy timeout disabled, answers are written synchronously", "ReviewCommitter");
+        return false;
+    }
+
+    quint64 committed = 0;
+    {
+        const auto query = db->statement(SELECT_COMMITTED_SEQUENCE);
+        if (!query->exec() || !query->next()) {
+            Logger::error("Could not read the committed answer sequence: " + query->lastError().text(), "ReviewCommitter");
+            return false;
+        }
+        committed = query->value(0).toULongLong();
+    }
+
+    // Answers that reached the journal but not the database
+    pending.clear();
+    nextSequence = committed + 1;
+    for (const ReviewEvent& event : readJournal()) {
+        nextSequence = std::max(nextSequence, event.sequence + 1);
+        if (event.sequence > committed) pending.push_back(event);
+    }
+
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        Logger::error("Could not open the answer journal: " + journal.errorString(), "ReviewCommitter");
+        pending.clear();
+        return false;
+    }
+
+    if (pending.empty()) journal.resize(0);
+    else Logger::info(QString("Replaying %1 answers from the journal").arg(QString::number(pending.size())), "ReviewCommitter");
+
+    stopping = false;
+    running = true;
+    worker = QThread::create([this] { run(); });
+    worker->start();
+    return true;
+}
+
+bool ReviewCommitter::submit(ReviewEvent event) {
+    {
+        std::unique_lock lock(mutex);
+        if (!running || stopping) return false;
+
+        drained.wait(lock, [this] { return pending.size() < CAPACITY || !running; });
+        if (!running) return false;
+
+        event.sequence = nextSequence++;
+        if (!appendToJournal(event)) {
+            Logger::warn("Could not journal the answer, it is lost if the app quits before it is saved", "ReviewCommitter");
+        }
+        pending.push_back(std::move(event));
+    }
+
+    wake.notify_one();
+    return true;
+}
+
+bool ReviewCommitter::flush() {
+    std::unique_lock lock(mutex);
+    if (!running) return pending.empty();
+
+    // Skip the batch window
+    ++flushing;
+    wake.notify_one();
+    // Bounded, the callers run on the GUI thread and a locked database may not let go
+    const bool drainedInTime = drained.wait_for(lock, std::chrono::milliseconds(FLUSH_TIMEOUT_MS), [this] {
+        return pending.empty() || !running;
+    });
+    --flushing;
+
+    if (!drainedInTime) {
+        Logger::warn(QString("%1 answers still queued after %2 ms").arg(QString::number(pending.size()), QString::number(FLUSH_TIMEOUT_MS)), "ReviewCommitter");
+    }
+    return pending.empty();
+}
+
+void ReviewCommitter::stop() {
+    {
+        std::lock_guard lock(mutex);
+        if (!worker) return;
+        stopping = true;
+    }
+    wake.notify_all();
+
+    // The worker drains the queue before it exits
+    worker->wait();
+    delete worker;
+    worker = nullptr;
+    journal.close();
+
+    if (!pending.empty()) {
+        Logger::warn(QString("%1 answers not saved, kept in the journal for the next start").arg(QString::number(pending.size())), "ReviewCommitter");
+    }
+}
+
+bool ReviewCommitter::isRunning() {
+    std::lock_guard lock(mutex);
+    return running;
+}
+
+void ReviewCommitter::run() {
+    for (;;) {
+        std::vector<ReviewEvent> batch;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (pending.empty()) break;
+
+            // Let a burst of answers share one commit
+            wake.wait_for(lock, std::chrono::milliseconds(BATCH_WINDOW_MS), [this] {
+                return stopping || flushing > 0 || pending.size() >= BATCH_SIZE;
+            });
+
+            const size_t count = std::min(pending.size(), BATCH_SIZE);
+            batch.assign(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(count));
+        }
+
+        const std::optional<size_t> applied = applyBatch(batch, attempts >= MAX_ATTEMPTS);
+
+        if (applied && *applied > 0) {
+            {
+                std::lock_guard lock(mutex);
+                pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(*applied));
+
+                // Everything is in the database, start the journal over
+                if (pending.empty()) journal.resize(0);
+            }
+            drained.notify_all();
+        }
+
+        if (applied && *applied == batch.size()) {
+            attempts = 0;
+            continue;
+        }
+
+        // The answer at the front failed, the first time unless nothing went in before it
+        if (applied) attempts = *applied == 0 ? attempts + 1 : 1;
+
+        // The answers left already moved their cards in the forecast
+        Forecast::invalidate();
+
+        // Stays queued and journaled, retried until stop()
+        std::unique_lock lock(mutex);
+        if (stopping) break;
+        wake.wait_for(lock, std::chrono::milliseconds(RETRY_DELAY_MS), [this] { return stopping; });
+    }
+
+    {
+        std::lock_guard lock(mutex);
+        running = false;
+    }
+    drained.notify_all();
+}
+
+std::optional<size_t> ReviewCommitter::applyBatch(const std::vector<ReviewEvent>& batch, const bool dropFirst) const {
+    const Database* db = Database::getInstance();
+
+    Transaction transaction(db->getDB());
+    if (!transaction.isActive()) return std::nullopt;
+
+    size_t applied = 0;
+    for (const ReviewEvent& event : batch) {
+        if (applied == 0 && dropFirst) {
+            Logger::error(QString("Dropped answer %1 for card %2 after %3 attempts")
+                          .arg(QString::number(event.sequence), event.card_id, QString::number(MAX_ATTEMPTS)), "ReviewCommitter");
+            ++applied;
+            continue;
+        }
+
+        // Rolled back to its own savepoint, it and the answers after it are tried again
+        if (!Deck::applyCardResponse(event)) {
+            Logger::warn(QString("Could not apply answer %1 for card %2, retrying").arg(QString::number(event.sequence), event.card_id), "ReviewCommitter");
+            break;
+        }
+        ++applied;
+    }
+
+    if (applied == 0) return 0;
+
+    // Replayed from the journal after a crash are only the answers past this one
+    {
+        const auto query = db->statement(UPDATE_COMMITTED_SEQUENCE);
+        query->bindValue(0, static_cast<qint64>(batch[applied - 1].sequence));
+
+        if (!query->exec()) {
+            Logger::error("Failed to store the committed answer sequence: " + query->lastError().text(), "ReviewCommitter");
+            return std::nullopt;
+        }
+    }
+
+    if (!transaction.commit()) return std::nullopt;
+    return applied;
+}
+
+// One tab separated line per answer:
+// sequence, user ID, deck ID, card ID, card type, button, answered at, duration
+bool ReviewCommitter::appendToJournal(const ReviewEvent& event) {
+    const QString line = QString("%1\t%2\t%3\t%4\t%5\t%6\t%7\t%8\n")
+                         .arg(QString::number(event.sequence), event.user_id, event.deck_id, event.card_id,
+                              QString::number(event.card_type), QString::number(event.button),
+                              QString::number(event.answered_at), QString::number(event.duration_ms));
+
+    // Flushed to the OS right away, survives the process dying
+    if (journal.write(line.toUtf8()) < 0) return false;
+    return journal.flush();
+}
+
+std::vector<ReviewEvent> ReviewCommitter::readJournal() const {
+    std::vector<ReviewEvent> events;
+
+    QFile file(journal.fileName());
+    if (!file.exists()) return events;
+    if (!file.open(QIODevice::ReadOnly)) {
+        Logger::error("Could not read the answer journal: " + file.errorString(), "ReviewCommitter");
+        return events;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray raw = file.readLine();
+        // A torn last line has no newline, it was never acknowledged
+        if (!raw.endsWith('\n')) break;
+
+        QStringList fields = QString::fromUtf8(raw).trimmed().split('\t');
+        // Lines written before the user was journaled go to the selected user
+        if (fields.size() == 7) fields.insert(1, QString());
+        if (fields.size() != 8) continue;
+
+        ReviewEvent event;
+        event.sequence = fields[0].toULongLong();
+        event.user_id = fields[1];
+        event.deck_id = fields[2];
+        event.card_id = fields[3];
+        event.card_type = fields[4].toInt();
+        event.button = fields[5].toInt();
+        event.answered_at = fields[6].toLongLong();
+        event.duration_ms = fields[7].toLongLong();
+
+        if (event.sequence > 0) events.push_back(event);
+    }
+
+    return events;
+}
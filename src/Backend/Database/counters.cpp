@@ -0,0 +1,130 @@
+#include <QDateTime>
+#include <QSqlError>
+#include <QVariant>
+
+#include "Backend/Database/counters.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+namespace {
+    DeckCounts readCounts(const QSqlQuery& query) {
+        DeckCounts counts;
+        counts.total = query.value("total").toInt();
+        counts.new_cards = query.value("new_cards").toInt();
+        counts.learning = query.value("learning").toInt();
+        counts.due_reviews = query.value("due_reviews").toInt();
+        return counts;
+    }
+}
+
+bool DeckCounters::refresh(const QString& userID) {
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    const auto query = Database::getInstance()->statement(REFRESH_DECK_COUNTERS);
+    query->bindValue(0, now);
+    query->bindValue(1, now);
+    query->bindValue(2, userID);
+    query->bindValue(3, now);
+
+    if (!query->exec()) {
+        Logger::error("Failed to refresh deck counters: " + query->lastError().text(), "DeckCounters");
+        return false;
+    }
+    return true;
+}
+
+std::unordered_map<QString, DeckCounts> DeckCounters::load(const QString& userID) {
+    std::unordered_map<QString, DeckCounts> decks;
+    if (userID.isEmpty() || !refresh(userID)) return decks;
+
+    const auto query = Database::getInstance()->statement(SELECT_DECK_COUNTERS);
+    query->bindValue(0, userID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to load deck counters: " + query->lastError().text(), "DeckCounters");
+        return decks;
+    }
+
+    while (query->next()) decks.emplace(query->value("id").toString(), readCounts(*query));
+    return decks;
+}
+
+std::optional<DeckCounts> DeckCounters::load(const QString& userID, const QString& deckID) {
+    if (userID.isEmpty() || !refresh(userID)) return std::nullopt;
+
+    const auto query = Database::getInstance()->statement(SELECT_DECK_COUNTERS_FOR_DECK);
+    query->bindValue(0, userID);
+    query->bindValue(1, deckID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to load deck counters: " + query->lastError().text(), "DeckCounters");
+        return std::nullopt;
+    }
+    if (!query->next()) return std::nullopt;
+
+    return readCounts(*query);
+}
+
+bool DeckCounters::cardAdded(const QString& deckID, const bool newCard) {
+    // An existing card may already be scheduled, recompute instead of guessing
+    const auto query = Database::getInstance()->statement(newCard ? UPDATE_DECK_COUNTERS_CARD_ADDED : DELETE_DECK_COUNTERS_DECK);
+    query->bindValue(0, deckID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to update deck counters: " + query->lastError().text(), "DeckCounters");
+        return false;
+    }
+    return true;
+}
+
+bool DeckCounters::cardAnswered(const QString& userID, const QString& cardID, const CardType before, const CardType after,
+                                const bool hadState, const qint64 due) {
+    const Database* db = Database::getInstance();
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+
+    // Reviews that are not due yet only move next_due
+    const bool dueNow = after == CardType::Review && due <= now;
+    const QVariant nextDue = after == CardType::Review && !dueNow ? QVariant(due) : QVariant();
+
+    {
+        const auto query = db->statement(UPDATE_DECK_COUNTERS_ANSWER);
+        query->bindValue(0, before == CardType::New && !hadState ? 1 : 0);
+        query->bindValue(1, (after == CardType::Learning ? 1 : 0) - (before == CardType::Learning ? 1 : 0));
+        query->bindValue(2, (dueNow ? 1 : 0) - (before == CardType::Review ? 1 : 0));
+        query->bindValue(3, nextDue);
+        query->bindValue(4, nextDue);
+        query->bindValue(5, before == CardType::New ? 1 : 0);
+        query->bindValue(6, before == CardType::Review ? 1 : 0);
+        query->bindValue(7, userID);
+        query->bindValue(8, cardID);
+
+        if (!query->exec()) {
+            Logger::error("Failed to update deck counters: " + query->lastError().text(), "DeckCounters");
+            return false;
+        }
+    }
+
+    if (before == after) return true;
+
+    const auto query = db->statement(DELETE_DECK_COUNTERS_OTHER_USERS);
+    query->bindValue(0, userID);
+    query->bindValue(1, cardID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to invalidate deck counters: " + query->lastError().text(), "DeckCounters");
+        return false;
+    }
+    return true;
+}
+
+bool DeckCounters::invalidateCard(const QString& cardID) {
+    const auto query = Database::getInstance()->statement(DELETE_DECK_COUNTERS_CARD);
+    query->bindValue(0, cardID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to invalidate deck counters: " + query->lastError().text(), "DeckCounters");
+        return false;
+    }
+    return true;
+}
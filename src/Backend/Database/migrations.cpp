@@ -0,0 +1,227 @@
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QStringList>
+
+#include "Backend/Database/migrations.hpp"
+#include "Backend/Database/queries.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+Migrator::Migrator(const QSqlDatabase& db) : db(db) {}
+
+// Append new versions at the end, never edit a released step
+const std::vector<Migration>& Migrator::migrations() {
+    static const std::vector<Migration> steps = {
+        {
+            1, "Initial schema",
+            {
+                CREATE_USERS_TABLE,
+                CREATE_DECKS_TABLE,
+                CREATE_CARDS_TABLE,
+                CREATE_DECKS_CARDS_TABLE,
+                CREATE_USERS_DECKS_TABLE,
+                CREATE_DECK_SETTINGS_TABLE,
+                CREATE_SAVED_USER_TABLE,
+                CREATE_USER_STATS_TABLE,
+                CREATE_DECK_STATS_TABLE,
+                CREATE_CARD_STATS_TABLE,
+                CARD_STATS_CARD_INDEX,
+                CARD_STATS_USER_INDEX,
+                CARD_STATS_DATE_INDEX,
+                CARD_STATS_CARD_USER_INDEX,
+                CARD_STATS_LAST_SEEN_INDEX
+            }
+        },
+        {
+            2, "Integer surrogate keys for Users, Decks and Cards",
+            {
+                CREATE_USERS_TABLE_V2, COPY_USERS_V2,
+                CREATE_DECKS_TABLE_V2, COPY_DECKS_V2,
+                CREATE_CARDS_TABLE_V2, COPY_CARDS_V2,
+                CREATE_DECKS_CARDS_TABLE_V2, COPY_DECKS_CARDS_V2,
+                CREATE_USERS_DECKS_TABLE_V2, COPY_USERS_DECKS_V2,
+                CREATE_DECK_SETTINGS_TABLE_V2, COPY_DECK_SETTINGS_V2,
+                CREATE_SAVED_USER_TABLE_V2, COPY_SAVED_USER_V2,
+                CREATE_USER_STATS_TABLE_V2, COPY_USER_STATS_V2,
+                CREATE_DECK_STATS_TABLE_V2, COPY_DECK_STATS_V2,
+                CREATE_CARD_STATS_TABLE_V2, COPY_CARD_STATS_V2,
+                DROP_CARD_STATS_V1, DROP_DECK_STATS_V1, DROP_USER_STATS_V1, DROP_SAVED_USER_V1,
+                DROP_DECK_SETTINGS_V1, DROP_USERS_DECKS_V1, DROP_DECKS_CARDS_V1,
+                DROP_CARDS_V1, DROP_DECKS_V1, DROP_USERS_V1,
+                RENAME_USERS_V2, RENAME_DECKS_V2, RENAME_CARDS_V2,
+                RENAME_DECKS_CARDS_V2, RENAME_USERS_DECKS_V2, RENAME_DECK_SETTINGS_V2,
+                RENAME_SAVED_USER_V2, RENAME_USER_STATS_V2, RENAME_DECK_STATS_V2, RENAME_CARD_STATS_V2,
+                DECKS_CARDS_CARD_INDEX_V2,
+                CARD_STATS_USER_INDEX_V2,
+                CARD_STATS_DATE_INDEX_V2,
+                CARD_STATS_LAST_SEEN_INDEX_V2
+            }
+        },
+        {
+            3, "Review committer journal position",
+            {
+                CREATE_REVIEW_JOURNAL_TABLE,
+                INSERT_REVIEW_JOURNAL_ROW
+            }
+        },
+        {
+            4, "Review log and card scheduling state",
+            {
+                CREATE_REVIEW_LOG_TABLE,
+                REVIEW_LOG_USER_TIME_INDEX,
+                REVIEW_LOG_USER_CARD_INDEX,
+                CREATE_CARD_STATE_TABLE,
+                COPY_CARD_STATE,
+                CARD_STATE_DUE_INDEX
+            }
+        },
+        {
+            5, "Materialized deck counters",
+            {
+                CREATE_DECK_COUNTERS_TABLE
+            }
+        },
+        {
+            6, "FSRS memory state and fitted weights",
+            {
+                ADD_CARD_STATE_STABILITY,
+                ADD_CARD_STATE_DIFFICULTY,
+                CREATE_FSRS_WEIGHTS_TABLE
+            }
+        },
+        {
+            7, "Card lapses",
+            {
+                ADD_CARD_STATE_LAPSES,
+                COUNT_CARD_STATE_LAPSES
+            }
+        },
+        {
+            8, "Weekly, monthly and all-time stats rollups",
+            {
+                CREATE_USER_STATS_ROLLUP_TABLE,
+                CREATE_DECK_STATS_ROLLUP_TABLE,
+                CREATE_STATS_ROLLUP_STATE_TABLE,
+                DECK_STATS_USER_DATE_INDEX
+            }
+        },
+        {
+            9, "Answer time histograms",
+            {
+                CREATE_ANSWER_TIMES_TABLE
+            }
+        }
+    };
+    return steps;
+}
+
+int Migrator::latestVersion() {
+    return migrations().back().version;
+}
+
+int Migrator::currentVersion() const {
+    QSqlQuery query(db);
+    if (!query.exec(QStringLiteral("PRAGMA user_version")) || !query.next()) {
+        Logger::error("Could not read schema version: " + query.lastError().text(), "Migrations");
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+bool Migrator::apply(const Migration& migration) {
+    Logger::db(QString("Applying migration %1: %2").arg(migration.version).arg(migration.description), "Migrations");
+
+    if (!db.transaction()) {
+        Logger::error("Could not start migration transaction: " + db.lastError().text(), "Migrations");
+        return false;
+    }
+
+    for (const char* statement : migration.statements) {
+        QSqlQuery query(db);
+        if (!query.exec(QString::fromUtf8(statement))) {
+            Logger::error(QString("Migration %1 failed: %2").arg(migration.version).arg(query.lastError().text()), "Migrations");
+            db.rollback();
+            return false;
+        }
+    }
+
+    // user_version is part of the transaction, a failed step leaves the previous version in place
+    QSqlQuery query(db);
+    if (!query.exec(QString("PRAGMA user_version = %1").arg(migration.version))) {
+        Logger::error("Could not update schema version: " + query.lastError().text(), "Migrations");
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        Logger::error("Could not commit migration: " + db.lastError().text(), "Migrations");
+        db.rollback();
+        return false;
+    }
+
+    return true;
+}
+
+bool Migrator::migrate() {
+    const int version = currentVersion();
+    if (version < 0) return false;
+
+    if (version == latestVersion()) {
+        Logger::db(QString("Schema is up to date (version %1)").arg(version), "Migrations");
+        return true;
+    }
+    if (version > latestVersion()) {
+        Logger::error(QString("Database schema version %1 is newer than this build supports (%2)").arg(version).arg(latestVersion()), "Migrations");
+        return false;
+    }
+
+    for (const Migration& migration : migrations()) {
+        if (migration.version <= version) continue;
+        if (!apply(migration)) return false;
+    }
+
+    Logger::db(QString("Schema migrated from version %1 to %2").arg(version).arg(latestVersion()), "Migrations");
+    return true;
+}
+
+bool Migrator::dropAll() {
+    // Read from the schema itself, so tables added by later versions go too
+    QStringList tables;
+    {
+        QSqlQuery query(db);
+        if (!query.exec(QStringLiteral("SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%'"))) {
+            Logger::error("Could not list tables: " + query.lastError().text(), "Migrations");
+            return false;
+        }
+        while (query.next()) tables << query.value(0).toString();
+    }
+
+    if (!db.transaction()) {
+        Logger::error("Could not start reset transaction: " + db.lastError().text(), "Migrations");
+        return false;
+    }
+
+    // Indexes go with their tables
+    QSqlQuery query(db);
+    for (const QString& table : tables) {
+        if (!query.exec(QString("DROP TABLE IF EXISTS \"%1\"").arg(table))) {
+            Logger::error(QString("Could not drop table %1: %2").arg(table, query.lastError().text()), "Migrations");
+            db.rollback();
+            return false;
+        }
+    }
+
+    if (!query.exec(QStringLiteral("PRAGMA user_version = 0"))) {
+        Logger::error("Could not reset schema version: " + query.lastError().text(), "Migrations");
+        db.rollback();
+        return false;
+    }
+
+    if (!db.commit()) {
+        Logger::error("Could not commit reset: " + db.lastError().text(), "Migrations");
+        db.rollback();
+        return false;
+    }
+
+    Logger::db(QString("Dropped %1 tables").arg(tables.size()), "Migrations");
+    return true;
+}
@@ -0,0 +1,56 @@
+#include <QThread>
+#include <QSqlError>
+
+#include "Backend/Database/pool.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+ConnectionPool::Lease::~Lease() {
+    statements.reset();
+    if (db.isOpen()) db.close();
+    db = QSqlDatabase(); // Drop the last handles before removing the connection
+    QSqlDatabase::removeDatabase(name);
+    --(*live);
+}
+
+ConnectionPool::ConnectionPool(const QString& path) :
+    path(path), profile(PerformanceProfile::balanced()), live(std::make_shared<std::atomic<int>>(0)) {}
+
+void ConnectionPool::setProfile(const PerformanceProfile& profile) { this->profile = profile; }
+
+QSqlDatabase ConnectionPool::checkout() {
+    if (leases.hasLocalData()) return leases.localData()->db;
+
+    // Thread IDs can be reused, but the previous owner removed its connection on exit
+    const QString name = QStringLiteral("mindleap_%1").arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
+
+    QSqlDatabase db = QSqlDatabase::addDatabase(QStringLiteral("QSQLITE"), name);
+    db.setDatabaseName(path);
+
+    auto* lease = new Lease{name, db, std::make_unique<StatementCache>(db), live};
+    ++(*live);
+
+    if (!lease->db.open()) {
+        Logger::error("Could not open pooled connection: " + lease->db.lastError().text(), "Pool");
+    } else {
+        Logger::db(QString("Opened connection %1").arg(name), "Pool");
+        profile.apply(lease->db);
+    }
+
+    leases.setLocalData(lease);
+    return lease->db;
+}
+
+StatementCache& ConnectionPool::statements() {
+    checkout();
+    return *leases.localData()->statements;
+}
+
+void ConnectionPool::release() {
+    if (leases.hasLocalData()) leases.setLocalData(nullptr); // Deletes the previous lease
+}
+
+bool ConnectionPool::hasConnection() const {
+    return leases.hasLocalData();
+}
+
+int ConnectionPool::size() const { return live->load(); }
@@ -0,0 +1,142 @@
+#include <QSqlError>
+#include <QThread>
+
+#include "Backend/Database/prefetcher.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+CardPrefetcher::~CardPrefetcher() {
+    stop();
+}
+
+void CardPrefetcher::start() {
+    std::lock_guard lock(mutex);
+    if (worker) return;
+
+    stopping = false;
+    worker = QThread::create([this] { run(); });
+    worker->start();
+}
+
+void CardPrefetcher::stop() {
+    {
+        std::lock_guard lock(mutex);
+        if (!worker) return;
+        stopping = true;
+    }
+    wake.notify_all();
+    loaded.notify_all();
+
+    worker->wait();
+    delete worker;
+
+    std::lock_guard lock(mutex);
+    worker = nullptr;
+    requested.clear();
+    inFlight.clear();
+}
+
+void CardPrefetcher::request(const std::vector<QString>& cardIDs) {
+    {
+        std::lock_guard lock(mutex);
+        for (const QString& cardID : cardIDs) {
+            if (window.contains(cardID) || !inFlight.insert(cardID).second) continue;
+            requested.push_back(cardID);
+        }
+    }
+    wake.notify_one();
+}
+
+std::optional<CardPrefetcher::Text> CardPrefetcher::take(const QString& cardID) {
+    {
+        std::unique_lock lock(mutex);
+
+        if (worker && !stopping) {
+            // Nobody asked for it yet, it goes first
+            if (!window.contains(cardID) && inFlight.insert(cardID).second) {
+                requested.push_front(cardID);
+                wake.notify_one();
+            }
+            loaded.wait(lock, [this, &cardID] { return !inFlight.contains(cardID) || stopping; });
+        }
+
+        const auto it = window.find(cardID);
+        if (it != window.end()) {
+            Text text = std::move(it->second);
+            window.erase(it);
+            return text;
+        }
+
+        // Read and gone, or the prefetcher was stopped before its batch
+        if (worker && !stopping) return std::nullopt;
+        inFlight.erase(cardID);
+    }
+
+    std::unordered_map<QString, Text> texts;
+    if (!readBatch({ cardID }, texts) || !texts.contains(cardID)) return std::nullopt;
+    return std::move(texts[cardID]);
+}
+
+void CardPrefetcher::discard(const QString& cardID) {
+    std::lock_guard lock(mutex);
+    window.erase(cardID);
+    // The worker drops it when its batch comes back
+    inFlight.erase(cardID);
+}
+
+size_t CardPrefetcher::pending() {
+    std::lock_guard lock(mutex);
+    return window.size() + inFlight.size();
+}
+
+void CardPrefetcher::run() {
+    for (;;) {
+        std::vector<QString> batch;
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this] { return stopping || !requested.empty(); });
+            if (stopping) break;
+
+            while (!requested.empty() && batch.size() < BATCH_SIZE) {
+                // Discarded while it waited
+                if (inFlight.contains(requested.front())) batch.push_back(requested.front());
+                requested.pop_front();
+            }
+        }
+
+        if (batch.empty()) continue;
+
+        std::unordered_map<QString, Text> texts;
+        const bool read = readBatch(batch, texts);
+
+        {
+            std::lock_guard lock(mutex);
+            for (const QString& cardID : batch) {
+                if (!inFlight.erase(cardID)) continue;
+
+                // Failed batches are not retried, take() reports the card as missing
+                const auto it = texts.find(cardID);
+                if (read && it != texts.end()) window.emplace(cardID, std::move(it->second));
+            }
+        }
+        loaded.notify_all();
+    }
+}
+
+bool CardPrefetcher::readBatch(const std::vector<QString>& ids, std::unordered_map<QString, Text>& texts) {
+    const auto query = Database::getInstance()->statement(SELECT_CARD_BATCH);
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+        query->bindValue(static_cast<int>(i), i < ids.size() ? ids[i] : QString(""));
+    }
+
+    if (!query->exec()) {
+        Logger::error("Failed to read study cards: " + query->lastError().text(), "CardPrefetcher");
+        return false;
+    }
+
+    while (query->next()) {
+        texts.emplace(query->value("id").toString(), Text{ query->value("question").toString(), query->value("answer").toString() });
+    }
+    return true;
+}
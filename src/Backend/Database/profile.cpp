@@ -0,0 +1,51 @@
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QStringList>
+
+#include "Backend/Database/profile.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+PerformanceProfile PerformanceProfile::legacy() {
+    return { "legacy", "DELETE", "FULL", 0, -2000, "DEFAULT", 0 };
+}
+
+PerformanceProfile PerformanceProfile::durable() {
+    return { "durable", "WAL", "FULL", 64LL * 1024 * 1024, -16000, "MEMORY", 5000 };
+}
+
+PerformanceProfile PerformanceProfile::balanced() {
+    // In WAL mode NORMAL only syncs on checkpoints, a crash can lose the last
+    // commits but never corrupts the database
+    return { "balanced", "WAL", "NORMAL", 256LL * 1024 * 1024, -32000, "MEMORY", 5000 };
+}
+
+PerformanceProfile PerformanceProfile::byName(const QString& name) {
+    const QString key = name.trimmed().toLower();
+    if (key == "legacy") return legacy();
+    if (key == "durable") return durable();
+    return balanced();
+}
+
+bool PerformanceProfile::apply(const QSqlDatabase& db) const {
+    // journal_mode cannot change inside a transaction, so this runs right after open()
+    const QStringList pragmas = {
+        QString("PRAGMA busy_timeout = %1").arg(busy_timeout),
+        QString("PRAGMA journal_mode = %1").arg(journal_mode),
+        QString("PRAGMA synchronous = %1").arg(synchronous),
+        QString("PRAGMA mmap_size = %1").arg(mmap_size),
+        QString("PRAGMA cache_size = %1").arg(cache_size),
+        QString("PRAGMA temp_store = %1").arg(temp_store)
+    };
+
+    bool ok = true;
+    for (const QString& pragma : pragmas) {
+        QSqlQuery query(db);
+        if (!query.exec(pragma)) {
+            Logger::warn(QString("%1 failed: %2").arg(pragma, query.lastError().text()), "Profile");
+            ok = false;
+        }
+    }
+
+    Logger::db(QString("Applied '%1' profile to %2").arg(name, db.connectionName()), "Profile");
+    return ok;
+}
@@ -0,0 +1,55 @@
+#include <QSqlError>
+#include <QVariant>
+
+#include "Backend/Database/rollups.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+#include "Backend/Database/transaction.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+bool StatsRollups::rollOver(const QString& userID) {
+    if (userID.isEmpty()) return false;
+    const Database* db = Database::getInstance();
+
+    // Days are compared as ISO dates in SQLite's calendar, the one the daily rows use
+    QString rolledThrough;
+    {
+        const auto query = db->statement(SELECT_STATS_ROLLUP_STATE);
+        query->bindValue(0, userID);
+
+        if (!query->exec() || !query->next()) {
+            Logger::error("Failed to read the stats rollup state: " + query->lastError().text(), "StatsRollups");
+            return false;
+        }
+
+        rolledThrough = query->value(0).toString();
+        if (rolledThrough >= query->value(1).toString()) return true;
+    }
+
+    Transaction transaction(db->getDB());
+    if (!transaction.isActive()) {
+        Logger::error("Could not start a transaction for the stats rollups", "StatsRollups");
+        return false;
+    }
+
+    for (const char* statement : { ROLL_UP_USER_STATS, ROLL_UP_DECK_STATS }) {
+        const auto query = db->statement(statement);
+        query->bindValue(0, userID);
+        query->bindValue(1, rolledThrough);
+
+        if (!query->exec()) {
+            Logger::error("Failed to roll up stats: " + query->lastError().text(), "StatsRollups");
+            return false;
+        }
+    }
+
+    const auto query = db->statement(UPSERT_STATS_ROLLUP_STATE);
+    query->bindValue(0, userID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to save the stats rollup state: " + query->lastError().text(), "StatsRollups");
+        return false;
+    }
+
+    return transaction.commit();
+}
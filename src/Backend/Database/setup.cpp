@@ -1,19 +1,33 @@
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
+#include <QThread>
 
 #include "Backend/Database/setup.hpp"
-#include "Backend/Database/queries.hpp"
+#include "Backend/Classes/AnswerTimes.hpp"
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Classes/Heatmap.hpp"
+#include "Backend/Classes/StatsService.hpp"
+#include "Backend/Database/migrations.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
 
 // Define static members
 std::unique_ptr<Database> Database::instance;
 std::once_flag Database::initInstanceFlag;
 
-Database::Database(const std::string &path) : db(QSqlDatabase::addDatabase("QSQLITE")), path(path) {
+Database::Database(const std::string &path) :
+    db(QSqlDatabase::addDatabase("QSQLITE")), path(path),
+    profile(PerformanceProfile::byName(qEnvironmentVariable("MINDLEAP_DB_PROFILE"))),
+    owner(QThread::currentThread()), pool(QString::fromStdString(path)) {
     db.setDatabaseName(QString::fromStdString(path));
+    statements = std::make_unique<StatementCache>(db);
 }
 
 Database::~Database() {
+    const StatementCache::Counters counters = StatementCache::getTotalCounters();
+    qDebug() << "[DB] Statement cache hits:" << counters.hits << "misses:" << counters.misses;
+
+    statements.reset();
     if (db.isOpen()) db.close();
 }
 
@@ -25,7 +39,41 @@ Database* Database::getInstance(const std::string &path) {
 }
 
 QSqlDatabase Database::getDB() const {
-    return db;
+    if (QThread::currentThread() == owner) return db;
+    return pool.checkout();
+}
+
+QString Database::getPath() const {
+    return QString::fromStdString(path);
+}
+
+ConnectionPool& Database::connections() const {
+    return pool;
+}
+
+StatementCache& Database::statementsForThread() const {
+    if (QThread::currentThread() == owner) return *statements;
+    return pool.statements();
+}
+
+Statement Database::statement(const char* sql) const {
+    return statementsForThread().get(sql);
+}
+
+Statement Database::statement(const QString& sql) const {
+    return statementsForThread().get(sql);
+}
+
+StatementCache::Counters Database::statementCounters() const {
+    return StatementCache::getTotalCounters();
+}
+
+void Database::setProfile(const PerformanceProfile& profile) {
+    this->profile = profile;
+}
+
+PerformanceProfile Database::getProfile() const {
+    return profile;
 }
 
 void Database::initialize() {
@@ -35,31 +83,15 @@ void Database::initialize() {
         std::exit(EXIT_FAILURE);
     }
 
-    // Create tables
-    const std::vector<std::string> queries = {
-        CREATE_USERS_TABLE,
-        CREATE_DECKS_TABLE,
-        CREATE_CARDS_TABLE,
-        CREATE_DECKS_CARDS_TABLE,
-        CREATE_USERS_DECKS_TABLE,
-        CREATE_DECK_SETTINGS_TABLE,
-        CREATE_SAVED_USER_TABLE,
-        CREATE_USER_STATS_TABLE,
-        CREATE_DECK_STATS_TABLE,
-        CREATE_CARD_STATS_TABLE,
-        CARD_STATS_CARD_INDEX,
-        CARD_STATS_USER_INDEX,
-        CARD_STATS_DATE_INDEX,
-        CARD_STATS_CARD_USER_INDEX,
-        CARD_STATS_LAST_SEEN_INDEX
-    };
-
-    for (const auto& query : queries) {
-        QSqlQuery q;
-        if (!q.exec(QString::fromStdString(query))) {
-            qCritical() << "[DB] Failed to initialize database:" + q.lastError().text();
-            std::exit(EXIT_FAILURE);
-        }
+    // Applied before any DDL, journal_mode cannot change inside a transaction
+    profile.apply(db);
+    pool.setProfile(profile);
+
+    // Create or upgrade the schema, skipped entirely when user_version is current
+    Migrator migrator(db);
+    if (!migrator.migrate()) {
+        qCritical() << "[DB] Failed to initialize database: schema migration failed";
+        std::exit(EXIT_FAILURE);
     }
 
     qDebug() << "[DB] Initialized successfully!";
@@ -67,42 +99,22 @@ void Database::initialize() {
 
 void Database::reset() {
     qDebug() << "[DB] Resetting database...";
-    const std::vector<std::string> tables = {
-        "CardStats",
-        "DeckStats",
-        "UserStats",
-        "DecksCards",
-        "UsersDecks",
-        "DeckSettings",
-        "SavedUser",
-        "Cards",
-        "Decks",
-        "Users"
-    };
-
-    const std::vector<std::string> indexes = {
-        "CARD_STATS_CARD_INDEX",
-        "CARD_STATS_USER_INDEX",
-        "CARD_STATS_DATE_INDEX"
-    };
-
-    for (const auto& index : indexes) {
-        QSqlQuery q;
-        if (!q.exec(QString("DROP INDEX IF EXISTS %1").arg(QString::fromStdString(index)))) {
-            qCritical() << "[DB] Failed to drop index:" << q.lastError().text();
-        }
-    }
+    statements->clear(); // Prepared statements would keep the old tables locked
+    SessionContext::clear();
 
-    // Drop existing tables
-    for (const auto& table : tables) {
-        QSqlQuery q;
-        if (!q.exec(QString("DROP TABLE IF EXISTS %1").arg(QString::fromStdString(table)))) {
-            qCritical() << "[DB] Failed to drop table" << QString::fromStdString(table) << ":" << q.lastError().text();
-        } else {
-            qDebug() << "[DB] Successfully dropped table" << QString::fromStdString(table);
-        }
+    // Every table the migrations created, whatever the version
+    Migrator migrator(db);
+    if (!migrator.dropAll()) {
+        qCritical() << "[DB] Failed to drop the schema, the database is left as it was";
+        return;
     }
 
+    // Nothing kept in memory belongs to the new database
+    AnswerTimes::clear();
+    Heatmap::invalidate();
+    Forecast::invalidate();
+    StatsService::invalidate();
+
     // Reinitialize the database
     initialize();
-}
\ No newline at end of file
+}
@@ -0,0 +1,59 @@
+#include <QSqlQuery>
+#include <QSqlError>
+
+#include "Backend/Database/transaction.hpp"
+#include "Backend/Utilities/Logger.hpp"
+
+// Every thread has its own connection, so nesting is tracked per thread
+static thread_local int depth = 0;
+
+Transaction::Transaction(const QSqlDatabase& db) : db(db) {
+    if (depth > 0) savepoint = QString("unit_%1").arg(depth);
+
+    // IMMEDIATE takes the write lock up front instead of failing on the first write
+    // when another connection got there in between
+    active = savepoint.isEmpty() ? exec("BEGIN IMMEDIATE") : exec("SAVEPOINT " + savepoint);
+    if (active) ++depth;
+}
+
+Transaction::~Transaction() {
+    if (active) rollback();
+}
+
+bool Transaction::exec(const QString& sql) const {
+    QSqlQuery query(db);
+    if (!query.exec(sql)) {
+        Logger::error(QString("%1 failed: %2").arg(sql, query.lastError().text()), "Transaction");
+        return false;
+    }
+    return true;
+}
+
+bool Transaction::isActive() const { return active; }
+
+bool Transaction::commit() {
+    if (!active) return false;
+
+    if (!exec(savepoint.isEmpty() ? QStringLiteral("COMMIT") : "RELEASE " + savepoint)) {
+        rollback();
+        return false;
+    }
+
+    active = false;
+    --depth;
+    return true;
+}
+
+void Transaction::rollback() {
+    if (!active) return;
+
+    if (savepoint.isEmpty()) exec("ROLLBACK");
+    else {
+        // ROLLBACK TO keeps the savepoint open, release it as well
+        exec("ROLLBACK TO " + savepoint);
+        exec("RELEASE " + savepoint);
+    }
+
+    active = false;
+    --depth;
+}
@@ -0,0 +1,74 @@
+#include <QSqlError>
+
+#include "Backend/Utilities/SessionContext.hpp"
+#include "Backend/Classes/Algorithms/Registry.hpp"
+#include "Backend/Utilities/Logger.hpp"
+#include "Backend/Database/setup.hpp"
+#include "Backend/Database/statements.hpp"
+
+// Define static members
+std::mutex SessionContext::mutex;
+QString SessionContext::userID;
+std::unordered_map<QString, DeckSettings> SessionContext::decks;
+
+QString SessionContext::getUserID() {
+    std::lock_guard lock(mutex);
+    if (!userID.isEmpty()) return userID;
+
+    const auto query = Database::getInstance()->statement(SELECT_SAVED_USER);
+    if (!query->exec()) {
+        Logger::error("Failed to load the selected user: " + query->lastError().text(), "SessionContext");
+        return {};
+    }
+
+    // Not cached when nobody is selected yet, User::select() fills it in later
+    if (query->next()) userID = query->value(0).toString();
+    return userID;
+}
+
+std::optional<DeckSettings> SessionContext::getDeckSettings(const QString& deckID) {
+    std::lock_guard lock(mutex);
+
+    const auto it = decks.find(deckID);
+    if (it != decks.end()) return it->second;
+
+    const auto query = Database::getInstance()->statement(SELECT_DECK_SETTINGS);
+    query->bindValue(0, deckID);
+
+    if (!query->exec()) {
+        Logger::error("Failed to load deck settings: " + query->lastError().text(), "SessionContext");
+        return std::nullopt;
+    }
+    if (!query->next()) return std::nullopt;
+
+    DeckSettings settings;
+    settings.daily_new_card_limit = query->value(0).toInt();
+    settings.max_review_cards = query->value(1).toInt();
+
+    // Parsed once here, answers only see the ID
+    const QString algorithm = query->value(2).toString();
+    if (const std::optional<AlgorithmID> id = Algorithms::fromName(algorithm)) {
+        settings.algorithm = *id;
+    } else {
+        Logger::warn("Unknown algorithm '" + algorithm + "' for deck " + deckID + ", using SM2", "SessionContext");
+    }
+
+    decks.emplace(deckID, settings);
+    return settings;
+}
+
+void SessionContext::invalidateUser() {
+    std::lock_guard lock(mutex);
+    userID.clear();
+}
+
+void SessionContext::invalidateDeck(const QString& deckID) {
+    std::lock_guard lock(mutex);
+    decks.erase(deckID);
+}
+
+void SessionContext::clear() {
+    std::lock_guard lock(mutex);
+    userID.clear();
+    decks.clear();
+}
@@ -0,0 +1,88 @@
+#include <algorithm>
+
+#include <QThread>
+
+#include "Backend/Utilities/WorkerPool.hpp"
+
+WorkerPool::WorkerPool(const int threads) {
+    const int total = threads > 0 ? threads : std::max(1, QThread::idealThreadCount());
+
+    // Worker 0 is whoever calls run()
+    for (int worker = 1; worker < total; ++worker) {
+        QThread* thread = QThread::create([this, worker] { loop(worker); });
+        thread->start();
+        this->threads.push_back(thread);
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+
+    for (QThread* thread : threads) {
+        thread->wait();
+        delete thread;
+    }
+}
+
+int WorkerPool::size() const {
+    return static_cast<int>(threads.size()) + 1;
+}
+
+size_t WorkerPool::chunks(const size_t count, const size_t grain) {
+    return (count + grain - 1) / grain;
+}
+
+void WorkerPool::run(const size_t count, const size_t grain, const Task& task) {
+    if (count == 0) return;
+
+    {
+        std::lock_guard lock(mutex);
+        this->task = &task;
+        this->count = count;
+        this->grain = std::max<size_t>(1, grain);
+        this->cursor = 0;
+        this->busy = static_cast<int>(threads.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    // The task must outlive every worker still finishing its last chunk
+    std::unique_lock lock(mutex);
+    done.wait(lock, [this] { return busy == 0; });
+    this->task = nullptr;
+}
+
+void WorkerPool::work(const int worker) {
+    const size_t total = chunks(count, grain);
+    for (size_t chunk = cursor.fetch_add(1); chunk < total; chunk = cursor.fetch_add(1)) {
+        const size_t begin = chunk * grain;
+        (*task)(worker, begin, std::min(begin + grain, count));
+    }
+}
+
+void WorkerPool::loop(const int worker) {
+    quint64 seen = 0;
+
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard lock(mutex);
+            --busy;
+        }
+        done.notify_one();
+    }
+}
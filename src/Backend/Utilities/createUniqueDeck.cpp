@@ -6,6 +6,7 @@
 
 #include "Backend/Database/setup.hpp"
 #include "Backend/Utilities/generateID.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
 #include "Backend/Classes/Stats/DeckStats.hpp"
 
 QString createUniqueDeck(const QString& name, DeckStats& stats) {
@@ -21,7 +22,7 @@ QString createUniqueDeck(const QString& name, DeckStats& stats) {
         qDebug() << "[Debug - Deck] Generated ID:" << deckId << "for name" << name;
 
         // Insert the user into the Users table
-        query.prepare(QStringLiteral("INSERT INTO Decks (id, name) VALUES (?, ?);"));
+        query.prepare(QStringLiteral("INSERT INTO Decks (uid, name) VALUES (?, ?);"));
         query.addBindValue(deckId);
         query.addBindValue(name);
 
@@ -36,9 +37,13 @@ QString createUniqueDeck(const QString& name, DeckStats& stats) {
         } else idExists = false;
     } while (idExists);
 
+    // Integer key of the new row, used for the links below
+    const qint64 deckKey = query.lastInsertId().toLongLong();
+
     // Link the user to the default deck
-    query.prepare(QStringLiteral("INSERT INTO UsersDecks (user_id, deck_id) VALUES ((SELECT id FROM SavedUser), ?);"));
-    query.addBindValue(deckId);
+    query.prepare(QStringLiteral("INSERT INTO UsersDecks (user_id, deck_id) VALUES ((SELECT id FROM Users WHERE uid = ?), ?);"));
+    query.addBindValue(SessionContext::getUserID());
+    query.addBindValue(deckKey);
 
     if (!query.exec()) {
         qDebug() << "[DB] Could not link user to deck:" << query.lastError().text();
@@ -47,7 +52,7 @@ QString createUniqueDeck(const QString& name, DeckStats& stats) {
 
     // Create deck settings
     query.prepare(QStringLiteral("INSERT INTO DeckSettings (id) VALUES (?)"));
-    query.addBindValue(deckId);
+    query.addBindValue(deckKey);
 
     if (!query.exec()) {
         qDebug() << "[DB] Failed to create deck settings:" << query.lastError().text();
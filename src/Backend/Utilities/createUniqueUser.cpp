@@ -23,7 +23,7 @@ QString createUniqueUser(const QString& username, UserStats& stats) {
         qDebug() << "[Debug - Deck] Generated ID:" << userId << "for name" << username;
 
         // Insert the user into the Users table
-        query.prepare(QStringLiteral("INSERT INTO Users (id, username) VALUES (?, ?);"));
+        query.prepare(QStringLiteral("INSERT INTO Users (uid, username) VALUES (?, ?);"));
         query.addBindValue(userId);
         query.addBindValue(username);
 
@@ -1,6 +1,8 @@
 #include <QProcess>
 
 #include "Backend/Database/setup.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Frontend/mainwindow.h"
 #include "Frontend/Dialogs/preferencesdialog.h"
 #include "Dialogs/ui_preferencesdialog.h"
 
@@ -18,6 +20,10 @@ PreferencesDialog::~PreferencesDialog() {
 }
 
 void PreferencesDialog::on_pushButton_clicked() {
+    // Nothing may write while the tables are dropped
+    if (auto* window = qobject_cast<MainWindow*>(parentWidget())) window->waitForOptimizer();
+    ReviewCommitter::getInstance()->stop();
+
     Database* db = Database::getInstance();
     db->reset();
 
@@ -1,5 +1,10 @@
 #include "Frontend/Dialogs/statsdialog.h"
+#include <algorithm>
+#include <numeric>
+
 #include "Backend/Classes/User.hpp"
+#include "Backend/Classes/StatsService.hpp"
+#include "Frontend/statsnotifier.h"
 #include "Dialogs/ui_statsdialog.h"
 
 StatsDialog::StatsDialog(QWidget *parent)
@@ -15,10 +20,24 @@ StatsDialog::StatsDialog(QWidget *parent)
         return;
     }
 
-    // Directly get stats from the user object
-    UserStats stats = user.getTotalUserStats();
-    populateUserData(stats);
-    populateDeckData();
+    // Numbers shared with the main window, kept current while the dialog is open
+    const QString userID = user.getID();
+    populateUserData(StatsService::userTotal(userID));
+    populateDeckData(userID);
+    populateForecast(user);
+    populateHeatmap(userID);
+    populateAnswerTimes(user);
+
+    connect(StatsNotifier::instance(), &StatsNotifier::userStatsChanged, this, [this, userID]() {
+        populateUserData(StatsService::userTotal(userID));
+        showHeatmap(Heatmap::forUser(userID), ui->heatmapYearBox->currentData().toInt());
+
+        const QString deckID = ui->answerTimeDeckBox->currentData().toString();
+        showAnswerTimes(deckID.isEmpty() ? AnswerTimes::forUser(userID) : AnswerTimes::forDeck(userID, deckID));
+    });
+    connect(StatsNotifier::instance(), &StatsNotifier::deckStatsChanged, this, [this, userID]() {
+        populateDeckData(userID);
+    });
 }
 
 StatsDialog::~StatsDialog(){ delete ui; }
@@ -32,27 +51,105 @@ void StatsDialog::populateUserData(const UserStats& stats) {
     ui->TimeSpentCount->setText(formatDuration(stats.getTimeSpentSeconds()));
 }
 
-void StatsDialog::populateDeckData() {
-    User user;
-    if (!user.fetchSelected()) return;
-
+void StatsDialog::populateDeckData(const QString& userID) {
     ui->label_2->setText("Deck Stats (Total)");
 
-    std::vector<Deck> decks = user.listDecks();
-    int totalCardsAdded = 0;
-    int totalCardsSeen = 0;
-    qint64 totalTimeSpent = 0;
+    const DeckStats total = StatsService::deckTotal(userID);
+
+    ui->CardsAddedCount->setText(formatNumber(total.getCardsAdded()));
+    ui->CardsSeenCount_2->setText(formatNumber(total.getCardsSeen()));
+    ui->TimeSpentCount_3->setText(formatDuration(total.getTimeSpent()));
+}
+
+void StatsDialog::populateForecast(const User& user) {
+    const QString userID = user.getID();
+
+    // An empty deck ID stands for every deck
+    ui->forecastDeckBox->addItem("All Decks", QString());
+    for (const Deck& deck : user.listDecks()) {
+        ui->forecastDeckBox->addItem(deck.getName(), deck.getID());
+    }
+
+    connect(ui->forecastDeckBox, &QComboBox::currentIndexChanged, this, [this, userID](const int index) {
+        const QString deckID = ui->forecastDeckBox->itemData(index).toString();
+        showForecast(deckID.isEmpty() ? Forecast::forUser(userID) : Forecast::forDeck(userID, deckID));
+    });
+
+    showForecast(Forecast::forUser(userID));
+}
+
+void StatsDialog::showForecast(const Forecast::Histogram& days) {
+    const auto sum = [&days](const int count) {
+        return std::accumulate(days.begin(), days.begin() + count, 0);
+    };
 
-    for (const auto& deck : decks) {
-        DeckStats ds = deck.getTotalDeckStats();
-        totalCardsAdded += ds.getCardsAdded();
-        totalCardsSeen += ds.getCardsSeen();
-        totalTimeSpent += ds.getTimeSpent();
+    ui->ForecastTodayCount->setText(formatNumber(days[0]));
+    ui->ForecastTomorrowCount->setText(formatNumber(days[1]));
+    ui->ForecastWeekCount->setText(formatNumber(sum(7)));
+    ui->ForecastMonthCount->setText(formatNumber(sum(30)));
+    ui->ForecastYearCount->setText(formatNumber(sum(Forecast::DAYS)));
+}
+
+void StatsDialog::populateHeatmap(const QString& userID) {
+    const Heatmap::Snapshot snapshot = Heatmap::forUser(userID);
+    const int thisYear = QDate::currentDate().year();
+    const int firstYear = snapshot.isEmpty() ? thisYear : std::min(thisYear, Heatmap::dateOf(snapshot.first_day).year());
+
+    // Latest year first
+    for (int year = thisYear; year >= firstYear; --year) {
+        ui->heatmapYearBox->addItem(QString::number(year), year);
     }
 
-    ui->CardsAddedCount->setText(formatNumber(totalCardsAdded));
-    ui->CardsSeenCount_2->setText(formatNumber(totalCardsSeen));
-    ui->TimeSpentCount_3->setText(formatDuration(totalTimeSpent));
+    connect(ui->heatmapYearBox, &QComboBox::currentIndexChanged, this, [this, userID](const int index) {
+        showHeatmap(Heatmap::forUser(userID), ui->heatmapYearBox->itemData(index).toInt());
+    });
+
+    showHeatmap(snapshot, thisYear);
+}
+
+void StatsDialog::showHeatmap(const Heatmap::Snapshot& snapshot, const int year) {
+    ui->heatmapWidget->setHeatmap(snapshot, year);
+
+    int reviews = 0;
+    int days = 0;
+    qint64 durationMs = 0;
+    for (QDate date(year, 1, 1); date.year() == year; date = date.addDays(1)) {
+        const Heatmap::Day day = snapshot.at(Heatmap::epochDay(date));
+        reviews += static_cast<int>(day.reviews);
+        days += day.reviews > 0;
+        durationMs += day.duration_ms;
+    }
+
+    if (reviews == 0) {
+        ui->heatmapSummary->setText("No reviews");
+        return;
+    }
+    ui->heatmapSummary->setText(QString("%1 reviews on %2 days, %3")
+        .arg(formatNumber(reviews), formatNumber(days), formatDuration(durationMs / 1000)));
+}
+
+void StatsDialog::populateAnswerTimes(const User& user) {
+    const QString userID = user.getID();
+
+    // An empty deck ID stands for every deck
+    ui->answerTimeDeckBox->addItem("All Decks", QString());
+    for (const Deck& deck : user.listDecks()) {
+        ui->answerTimeDeckBox->addItem(deck.getName(), deck.getID());
+    }
+
+    connect(ui->answerTimeDeckBox, &QComboBox::currentIndexChanged, this, [this, userID](const int index) {
+        const QString deckID = ui->answerTimeDeckBox->itemData(index).toString();
+        showAnswerTimes(deckID.isEmpty() ? AnswerTimes::forUser(userID) : AnswerTimes::forDeck(userID, deckID));
+    });
+
+    showAnswerTimes(AnswerTimes::forUser(userID));
+}
+
+void StatsDialog::showAnswerTimes(const AnswerTimes::Histogram& histogram) {
+    ui->AnswerTimeMedianCount->setText(formatAnswerTime(histogram.percentile(0.5)));
+    ui->AnswerTime90Count->setText(formatAnswerTime(histogram.percentile(0.9)));
+    ui->AnswerTime99Count->setText(formatAnswerTime(histogram.percentile(0.99)));
+    ui->AnswerTimeTotalCount->setText(QLocale(QLocale::English).toString(histogram.total()));
 }
 
 QString StatsDialog::formatDuration(qint64 seconds) {
@@ -69,6 +166,12 @@ QString StatsDialog::formatDuration(qint64 seconds) {
     return QString("%1m %2s").arg(remainingMinutes).arg(remainingSeconds);
 }
 
+QString StatsDialog::formatAnswerTime(qint64 milliseconds) {
+    if (milliseconds < 1000) return QString("%1 ms").arg(milliseconds);
+    if (milliseconds < 60 * 1000) return QString("%1s").arg(milliseconds / 1000.0, 0, 'f', 1);
+    return formatDuration(milliseconds / 1000);
+}
+
 QString StatsDialog::formatNumber(int number) {
     return QLocale(QLocale::English).toString(number);
 }
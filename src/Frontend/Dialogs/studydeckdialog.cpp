@@ -12,6 +12,7 @@ StudyDeckDialog::StudyDeckDialog(MainWindow *parent)
     ui->setupUi(this);
 
     setWindowTitle("Study Deck");
+    ui->listWidget->setSelectionMode(QAbstractItemView::ExtendedSelection);
 
     User user;
     const bool user_status = user.fetchSelected();
@@ -26,6 +27,11 @@ StudyDeckDialog::StudyDeckDialog(MainWindow *parent)
         return;
     }
 
+    // Studies every deck in one session
+    QListWidgetItem* allItem = new QListWidgetItem("All Decks");
+    allItem->setData(Qt::UserRole, QString());
+    ui->listWidget->addItem(allItem);
+
     for (const Deck& deck : decks) {
         QListWidgetItem* item = new QListWidgetItem(deck.getName());
         item->setData(Qt::UserRole, deck.getID());
@@ -38,14 +44,23 @@ StudyDeckDialog::~StudyDeckDialog() {
 }
 
 void StudyDeckDialog::on_buttonBox_accepted() {
-    QListWidgetItem* selectedItem = ui->listWidget->currentItem();
-    if (!selectedItem) {
+    const QList<QListWidgetItem*> selectedItems = ui->listWidget->selectedItems();
+    if (selectedItems.isEmpty()) {
         showStyledMessageBox("No deck selected.", "You did not select a deck to study.", QMessageBox::Warning);
         return;
     }
 
-    QString deckID = selectedItem->data(Qt::UserRole).toString();
-    emit studySessionRequested(deckID);
+    QStringList deckIDs;
+    for (const QListWidgetItem* item : selectedItems) {
+        const QString deckID = item->data(Qt::UserRole).toString();
+        // "All Decks" wins over any other selection
+        if (deckID.isEmpty()) {
+            deckIDs.clear();
+            break;
+        }
+        deckIDs << deckID;
+    }
+    emit studySessionRequested(deckIDs);
 
     accept();
 }
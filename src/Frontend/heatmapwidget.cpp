@@ -0,0 +1,121 @@
+#include <algorithm>
+
+#include <QHelpEvent>
+#include <QLocale>
+#include <QPainter>
+#include <QToolTip>
+
+#include "Frontend/heatmapwidget.h"
+
+namespace {
+    constexpr int WEEKS = 54; // A leap year starting on Sunday spans 54 columns
+    constexpr int GAP = 2;
+    constexpr int HEADER = 14; // Month names
+    constexpr int SHADES = 4;
+
+    const QColor EMPTY(0x2b, 0x2a, 0x33);
+    const QColor ACCENT(0x04, 0xb9, 0x7f);
+}
+
+HeatmapWidget::HeatmapWidget(QWidget *parent)
+    : QWidget(parent), year(QDate::currentDate().year()) {
+    setMouseTracking(true);
+}
+
+void HeatmapWidget::setHeatmap(const Heatmap::Snapshot& snapshot, const int year) {
+    this->snapshot = snapshot;
+    this->year = year;
+
+    maxReviews = 0;
+    for (QDate date(year, 1, 1); date.year() == year; date = date.addDays(1)) {
+        maxReviews = std::max(maxReviews, snapshot.at(Heatmap::epochDay(date)).reviews);
+    }
+    update();
+}
+
+QSize HeatmapWidget::sizeHint() const {
+    return { WEEKS * 10, HEADER + 7 * 10 };
+}
+
+QSize HeatmapWidget::minimumSizeHint() const {
+    return { WEEKS * 6, HEADER + 7 * 6 };
+}
+
+int HeatmapWidget::cellSize() const {
+    return std::max(3, std::min(width() / WEEKS, (height() - HEADER) / 7));
+}
+
+QPoint HeatmapWidget::cellOf(const QDate& date) const {
+    const int offset = QDate(year, 1, 1).dayOfWeek() - 1;
+    const int index = date.dayOfYear() - 1 + offset;
+    return { index / 7, index % 7 };
+}
+
+QRect HeatmapWidget::cellRect(const QDate& date) const {
+    const int size = cellSize();
+    const QPoint cell = cellOf(date);
+    return { cell.x() * size, HEADER + cell.y() * size, size - GAP, size - GAP };
+}
+
+QDate HeatmapWidget::dateAt(const QPoint& pos) const {
+    const int size = cellSize();
+    if (pos.x() < 0 || pos.y() < HEADER) return {};
+
+    const int week = pos.x() / size;
+    const int weekday = (pos.y() - HEADER) / size;
+    if (weekday >= 7 || pos.x() % size >= size - GAP || (pos.y() - HEADER) % size >= size - GAP) return {};
+
+    const QDate first(year, 1, 1);
+    const QDate date = first.addDays(week * 7 + weekday - (first.dayOfWeek() - 1));
+    return date.year() == year ? date : QDate();
+}
+
+void HeatmapWidget::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.setPen(Qt::NoPen);
+
+    for (QDate date(year, 1, 1); date.year() == year; date = date.addDays(1)) {
+        const quint32 reviews = snapshot.at(Heatmap::epochDay(date)).reviews;
+
+        QColor color = EMPTY;
+        if (reviews > 0) {
+            // Shades by quarters of the busiest day
+            const int shade = static_cast<int>((static_cast<quint64>(reviews) * SHADES + maxReviews - 1) / maxReviews);
+            color = ACCENT;
+            color.setAlpha(255 * shade / SHADES);
+        }
+        painter.fillRect(cellRect(date), color);
+    }
+
+    QFont font = painter.font();
+    font.setPixelSize(HEADER - 4);
+    painter.setFont(font);
+    painter.setPen(palette().color(QPalette::WindowText));
+
+    const QLocale locale(QLocale::English);
+    for (int month = 1; month <= 12; ++month) {
+        const QDate first(year, month, 1);
+        painter.drawText(cellOf(first).x() * cellSize(), HEADER - 4, locale.monthName(month, QLocale::ShortFormat));
+    }
+}
+
+bool HeatmapWidget::event(QEvent *event) {
+    if (event->type() != QEvent::ToolTip) return QWidget::event(event);
+
+    const auto *help = static_cast<QHelpEvent *>(event);
+    const QDate date = dateAt(help->pos());
+    if (!date.isValid()) {
+        QToolTip::hideText();
+        event->ignore();
+        return true;
+    }
+
+    const Heatmap::Day day = snapshot.at(Heatmap::epochDay(date));
+    const QLocale locale(QLocale::English);
+    QToolTip::showText(help->globalPos(), QString("%1\n%2 reviews, %3 min")
+        .arg(locale.toString(date, "ddd, d MMM yyyy"), locale.toString(day.reviews),
+             locale.toString(day.duration_ms / 60000)));
+    return true;
+}
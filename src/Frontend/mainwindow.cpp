@@ -1,12 +1,18 @@
+#include <algorithm>
+#include <memory>
+
 #include <QSqlQuery>
 #include <QTableWidget>
 #include <QIcon>
 #include <QTimer>
+#include <QDateTime>
 #include <QSize>
 #include <QStyle>
 #include <QHBoxLayout>
 #include <QMenu>
 #include <QAction>
+#include <QActionGroup>
+#include <QThread>
 #include <QScrollBar>
 #include <QCursor>
 #include <QSoundEffect>
@@ -14,7 +20,13 @@
 #include "Backend/Utilities/Logger.hpp"
 #include "Backend/Utilities/DiscordManager.hpp"
 #include "Backend/Classes/User.hpp"
+#include "Backend/Classes/StatsService.hpp"
+#include "Backend/Classes/Reschedule.hpp"
+#include "Backend/Classes/Algorithms/FSRSOptimizer.hpp"
+#include "Backend/Classes/Algorithms/Registry.hpp"
 #include "Backend/Database/setup.hpp"
+#include "Backend/Database/committer.hpp"
+#include "Backend/Utilities/SessionContext.hpp"
 #include "Frontend/mainwindow.h"
 #include "Frontend/Dialogs/preferencesdialog.h"
 #include "Frontend/Dialogs/statsdialog.h"
@@ -22,6 +34,7 @@
 #include "Frontend/invalidinputbox.h"
 #include "Frontend/selectuser.h"
 #include "Frontend/hoverabletablewidget.h"
+#include "Frontend/statsnotifier.h"
 #include "Frontend/Dialogs/addcarddialog.h"
 #include "Frontend/Dialogs/confirmationdialog.h"
 #include "Frontend/Dialogs/customdialog.h"
@@ -41,6 +54,12 @@ MainWindow::MainWindow(QWidget *parent)
     popSound->setSource(QUrl("qrc:/assets/sounds/pop.wav"));
     popSound->setVolume(0.5f);
 
+    // Shows the next card once the earliest learning step is over
+    learningTimer = new QTimer(this);
+    learningTimer->setSingleShot(true);
+    learningTimer->setTimerType(Qt::PreciseTimer);
+    connect(learningTimer, &QTimer::timeout, this, &MainWindow::proceedToNextCard);
+
     // Make sure unwanted elements are hidden
     ui->scrollArea->setVisible(true);
     ui->AddCardButton->setVisible(false);
@@ -56,10 +75,16 @@ MainWindow::MainWindow(QWidget *parent)
     connect(tableWidget, &HoverableTableWidget::rowHovered, this, &MainWindow::onRowHovered);
     connect(tableWidget, &HoverableTableWidget::rowLeft, this, &MainWindow::onRowLeft);
 
+    // Card counts follow answers, added cards and deleted ones
+    connect(StatsNotifier::instance(), &StatsNotifier::deckCountsChanged, this, &MainWindow::refreshDeckCounts);
+
     // Once DB is initialized, fetch the current user
     auto db = Database::getInstance("app_data.db");
     if(!db->getDB().isOpen()) db->initialize();
 
+    // Answers are saved in the background from here on
+    ReviewCommitter::getInstance()->start();
+
     User user;
     const bool status = user.fetchSelected();
     if(!status){
@@ -80,7 +105,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     user.updateLaunchStats();
 
-    DiscordManager::updatePresence("Browsing Decks", "", "browse");
+    showBrowsingPresence();
     populateTableWidget(user.listDecks());
 
     // Pre-initialize heavy dialogs in the background to make them instant on first click
@@ -117,8 +142,14 @@ HoverableTableWidget* MainWindow::get_tableWidget() {
 }
 
 void MainWindow::populateTableWidget(const std::vector<Deck>& decks) {
+    // Counts of every deck in one read
+    const std::unordered_map<QString, DeckCounts> counts = StatsService::counts(SessionContext::getUserID());
+
     ui->CardList->setRowCount(decks.size());
-    for(int row = 0; row < decks.size(); row++) insertTableRow(decks[row], row, false);
+    for(int row = 0; row < decks.size(); row++) {
+        const auto it = counts.find(decks[row].getID());
+        insertTableRow(decks[row], row, false, it != counts.end() ? it->second : DeckCounts{});
+    }
 
     QTimer::singleShot(0, this, [this]() {
         adjustTableColumnWidths();
@@ -272,6 +303,61 @@ void MainWindow::showDeckSettings(const Deck& deck, const int row) {
     });
     contextMenu.addAction(action2);
 
+    const QString deckID = deck.getID();
+
+    // Scheduling algorithm of the deck, the current one is checked
+    QMenu* algorithmMenu = contextMenu.addMenu("Algorithm");
+    auto *algorithmGroup = new QActionGroup(algorithmMenu);
+    const QString currentAlgorithm = deck.fetchAlgorithm();
+
+    for (size_t i = 0; i < Algorithms::COUNT; ++i) {
+        const QString name = Algorithms::name(static_cast<AlgorithmID>(i));
+        QAction* algorithmAction = algorithmMenu->addAction(name);
+        algorithmAction->setCheckable(true);
+        algorithmAction->setChecked(name == currentAlgorithm);
+        algorithmGroup->addAction(algorithmAction);
+
+        connect(algorithmAction, &QAction::triggered, this, [this, tableWidget, deckID, name]() {
+            tableWidget->setContextMenuActive(false);
+            if (!Deck(deckID).setAlgorithm(name)) {
+                this->statusBar()->showMessage("Error: Could not change the deck algorithm.");
+                return;
+            }
+            this->statusBar()->showMessage("Deck now scheduled with " + name + ".");
+        });
+    }
+
+    // Bulk rescheduling, days are asked for where the operation needs them
+    contextMenu.addSeparator();
+
+    auto *postponeAction = new QAction("Postpone Overdue", this);
+    connect(postponeAction, &QAction::triggered, this, [this, tableWidget, row, deckID]() {
+        tableWidget->setContextMenuActive(false);
+        if (const std::optional<int> days = askForDays("Postpone Overdue Cards", "Postpone overdue cards by how many days?")) {
+            reportReschedule(Reschedule::postponeOverdue(deckID, *days), row, deckID);
+        }
+    });
+    contextMenu.addAction(postponeAction);
+
+    auto *spreadAction = new QAction("Spread Overdue", this);
+    connect(spreadAction, &QAction::triggered, this, [this, tableWidget, row, deckID]() {
+        tableWidget->setContextMenuActive(false);
+        if (const std::optional<int> days = askForDays("Spread Overdue Cards", "Spread overdue cards over how many days?")) {
+            reportReschedule(Reschedule::spreadOverdue(deckID, *days), row, deckID);
+        }
+    });
+    contextMenu.addAction(spreadAction);
+
+    auto *resetAction = new QAction("Reset Progress", this);
+    connect(resetAction, &QAction::triggered, this, [this, tableWidget, row, deckID]() {
+        tableWidget->setContextMenuActive(false);
+        ConfirmationDialog* resetDialog = new ConfirmationDialog("reset every card of this deck to New", this);
+        if (resetDialog->exec() == QDialog::Accepted) {
+            reportReschedule(Reschedule::resetDeck(deckID), row, deckID);
+        }
+    });
+    contextMenu.addAction(resetAction);
+
     // Connect the aboutToHide signal to reset the flag
     connect(&contextMenu, &QMenu::aboutToHide, this, [this, tableWidget, row]() {
         if (row != -1) {
@@ -285,6 +371,58 @@ void MainWindow::showDeckSettings(const Deck& deck, const int row) {
     contextMenu.exec(QCursor::pos());
 }
 
+std::optional<int> MainWindow::askForDays(const QString& title, const QString& message) {
+    CustomDialog dialog(this);
+    dialog.setWindowTitleText(title);
+    dialog.setMessageText(message);
+    if (dialog.exec() != QDialog::Accepted) return std::nullopt;
+
+    bool valid = false;
+    const int days = dialog.getEnteredText().toInt(&valid);
+    if (!valid || days <= 0) {
+        this->statusBar()->showMessage("Error: Enter a number of days greater than zero.");
+        return std::nullopt;
+    }
+    return days;
+}
+
+void MainWindow::reportReschedule(const int changed, const int row, const QString& deckID) {
+    if (changed < 0) {
+        this->statusBar()->showMessage("Error: Could not reschedule the deck.");
+        return;
+    }
+
+    this->statusBar()->showMessage(QString("%1 cards rescheduled.").arg(changed));
+    refreshTableCounts(row, deckID);
+}
+
+void MainWindow::refreshTableCounts(const int row, const QString& deckID) {
+    const DeckCounts counts = StatsService::counts(SessionContext::getUserID(), deckID);
+    const int values[] = { counts.new_cards, counts.due_reviews, counts.learning, counts.total };
+
+    for (int column = 1; column <= 4; ++column) {
+        if (QTableWidgetItem* item = ui->CardList->item(row, column)) item->setText(QString::number(values[column - 1]));
+    }
+}
+
+void MainWindow::refreshDeckCounts(const QString& deckID) {
+    // The session keeps its own counts, the table is refreshed when it ends
+    if (currentSession.isActive()) return;
+
+    for (int row = 0; row < ui->CardList->rowCount(); ++row) {
+        const QTableWidgetItem* item = ui->CardList->item(row, 0);
+        if (!item) continue;
+
+        const QString rowDeckID = item->data(Qt::UserRole).toString();
+        if (deckID.isEmpty() || rowDeckID == deckID) refreshTableCounts(row, rowDeckID);
+    }
+}
+
+void MainWindow::showBrowsingPresence() {
+    const UserStats today = StatsService::userToday(SessionContext::getUserID());
+    DiscordManager::updatePresence("Browsing Decks", QString("%1 cards reviewed today").arg(today.getCardsSeen()), "browse");
+}
+
 void MainWindow::onRowHovered(int row) { setButtonVisibility(row, true); }
 
 void MainWindow::onRowLeft(int row) { setButtonVisibility(row, false); }
@@ -322,7 +460,7 @@ void MainWindow::on_CreateDeckButton_clicked() {
 }
 
 void MainWindow::on_DecksButton_clicked() {
-    DiscordManager::updatePresence("Browsing Decks", "", "browse");
+    showBrowsingPresence();
 
     if(!ui->scrollArea->isVisible()){
         ui->study->setVisible(false);
@@ -394,7 +532,8 @@ void MainWindow::showDeckInfo(const Deck& deck) {
     ui->SetDescriptionButton->setVisible(true);
     ui->AddCardButton->setVisible(true);
 
-    if(deck.getCardCount() == 0) ui->StudyButton->setVisible(false);
+    const DeckCounts counts = StatsService::counts(SessionContext::getUserID(), deck.getID());
+    if(counts.total == 0) ui->StudyButton->setVisible(false);
 
     // Change visible widget
     ui->scrollArea->setVisible(false);
@@ -411,26 +550,18 @@ void MainWindow::showDeckInfo(const Deck& deck) {
         ui->Description->setText(deckDescription);
     } else ui->scrollArea_2->setVisible(false);
 
-    const std::vector<int> card_count = deck.getCardInformation();
-    if(card_count.empty()){
-        this->statusBar()->showMessage("Error: Could not retrieve card counts");
-        return;
-    }
-
-    if(!card_count.empty()){
-        ui->UnseenCount->setText(QString::number(card_count[0]));
-        ui->PendingCount->setText(QString::number(card_count[1]));
-        ui->ReviewCount->setText(QString::number(card_count[2]));
+    ui->UnseenCount->setText(QString::number(counts.new_cards));
+    ui->PendingCount->setText(QString::number(counts.learning));
+    ui->ReviewCount->setText(QString::number(counts.due_reviews));
 
-        // Hide study button if no cards are available within limits
-        if (card_count[0] == 0 && card_count[1] == 0 && card_count[2] == 0) {
-            ui->StudyButton->setVisible(false);
-        } else {
-            ui->StudyButton->setVisible(true);
-        }
+    // Hide study button if no cards are available within limits
+    if (counts.new_cards == 0 && counts.learning == 0 && counts.due_reviews == 0) {
+        ui->StudyButton->setVisible(false);
+    } else {
+        ui->StudyButton->setVisible(true);
     }
 
-    ui->CardCount->setText("Total Cards: " + QString::number(deck.getCardCount()));
+    ui->CardCount->setText("Total Cards: " + QString::number(counts.total));
 
     ui->Description->adjustSize();
     // ui->UnseenCount->adjustSize();
@@ -438,7 +569,7 @@ void MainWindow::showDeckInfo(const Deck& deck) {
     // ui->PendingCount->adjustSize();
 }
 
-void MainWindow::insertTableRow(const Deck& deck, const int& row, const bool& insert_default_values){
+void MainWindow::insertTableRow(const Deck& deck, const int& row, const bool& insert_default_values, const DeckCounts& counts){
     QFont font;
     font.setPointSize(12);
 
@@ -474,35 +605,26 @@ void MainWindow::insertTableRow(const Deck& deck, const int& row, const bool& in
     nameItem->setData(Qt::UserRole, QVariant(deck.getID()));
     ui->CardList->setItem(row, 0, nameItem);
 
-    std::vector<int> card_count;
-    if(!insert_default_values){
-        card_count = deck.getCardInformation();
-        if(card_count.empty()){
-            this->statusBar()->showMessage("Error: Card Counts could not be loaded.");
-            return;
-        }
-    }
-
     // Set New, Review, and Pending values
-    auto *newItem = new QTableWidgetItem(!insert_default_values ? QString::number(card_count[0]) : "0");
+    auto *newItem = new QTableWidgetItem(!insert_default_values ? QString::number(counts.new_cards) : "0");
     newItem->setFont(font);
     newItem->setTextAlignment(Qt::AlignCenter);
     newItem->setFlags(newItem->flags() & ~Qt::ItemIsEditable); // Make non-editable
     ui->CardList->setItem(row, 1, newItem);
 
-    auto *reviewItem = new QTableWidgetItem(!insert_default_values ? QString::number(card_count[2]) : "0");
+    auto *reviewItem = new QTableWidgetItem(!insert_default_values ? QString::number(counts.due_reviews) : "0");
     reviewItem->setFont(font);
     reviewItem->setTextAlignment(Qt::AlignCenter);
     reviewItem->setFlags(reviewItem->flags() & ~Qt::ItemIsEditable); // Make non-editable
     ui->CardList->setItem(row, 2, reviewItem);
 
-    auto *learnItem = new QTableWidgetItem(!insert_default_values ? QString::number(card_count[1]) : "0");
+    auto *learnItem = new QTableWidgetItem(!insert_default_values ? QString::number(counts.learning) : "0");
     learnItem->setFont(font);
     learnItem->setTextAlignment(Qt::AlignCenter);
     learnItem->setFlags(learnItem->flags() & ~Qt::ItemIsEditable); // Make non-editable
     ui->CardList->setItem(row, 3, learnItem);
 
-    auto *totalItem = new QTableWidgetItem(!insert_default_values ? QString::number(deck.getCardCount()) : "0");
+    auto *totalItem = new QTableWidgetItem(!insert_default_values ? QString::number(counts.total) : "0");
     totalItem->setFont(font);
     totalItem->setTextAlignment(Qt::AlignCenter);
     totalItem->setFlags(totalItem->flags() & ~Qt::ItemIsEditable); // Make non-editable
@@ -579,12 +701,52 @@ void MainWindow::on_actionStudy_Deck_triggered() {
     delete dialog;
 }
 
-void MainWindow::startStudySession(const QString& deckID) {
-    this->currentDeckID = deckID;
-    this->currentDeckObj = Deck(deckID);
+// Fits the FSRS weights to the review history on a worker thread, the window stays responsive
+void MainWindow::on_actionOptimize_FSRS_triggered() {
+    const QString userID = SessionContext::getUserID();
+    if (userID.isEmpty()) return;
 
-    if (currentDeckObj.study()) {
-        Logger::info("Study session started", QString("DeckID: %1").arg(deckID));
+    ui->actionOptimize_FSRS->setEnabled(false);
+    statusBar()->showMessage("Fitting FSRS weights to your review history...");
+
+    auto result = std::make_shared<std::optional<FSRSOptimizer::Result>>();
+    QThread* worker = QThread::create([userID, result] { *result = FSRSOptimizer::optimize(userID); });
+    optimizer = worker;
+
+    connect(worker, &QThread::finished, this, [this, worker, result]() {
+        worker->deleteLater();
+        ui->actionOptimize_FSRS->setEnabled(true);
+
+        if (!*result) {
+            statusBar()->showMessage("FSRS weights kept: not enough reviews yet, or the history could not be read.");
+            return;
+        }
+
+        const FSRSOptimizer::Result& fitted = **result;
+        const QString summary = QString("%1 reviews in %2 ms, log loss %3")
+            .arg(QString::number(fitted.reviews), QString::number(fitted.elapsed_ms), QString::number(fitted.log_loss_after, 'f', 4));
+        statusBar()->showMessage(fitted.saved ? "FSRS weights updated (" + summary + ")."
+                                              : "FSRS weights kept, the current ones fit better (" + summary + ").");
+    });
+
+    worker->start();
+}
+
+void MainWindow::waitForOptimizer() {
+    if (!optimizer || !optimizer->isRunning()) return;
+
+    // The fit reads and writes the database, it cannot be cut short
+    Logger::info("Waiting for the FSRS fit to finish", "Main");
+    optimizer->wait();
+}
+
+// An empty list studies every deck of the user
+void MainWindow::startStudySession(const QStringList& deckIDs) {
+    this->currentDeckID = deckIDs.size() == 1 ? deckIDs.first() : QString();
+    this->currentSession = StudySession(std::vector<QString>(deckIDs.begin(), deckIDs.end()));
+
+    if (currentSession.start()) {
+        Logger::info("Study session started", QString("Decks: %1").arg(deckIDs.isEmpty() ? QString("All") : deckIDs.join(", ")));
 
         ui->deckWidget->setVisible(false);
         ui->scrollArea->setVisible(false);
@@ -603,8 +765,8 @@ void MainWindow::startStudySession(const QString& deckID) {
 
         proceedToNextCard();
     } else {
-        Logger::info("No cards due for study in deck: " + deckID, "Main");
-        showStyledMessageBox("MindLeap", "No cards are currently due for study in this deck.", QMessageBox::Information);
+        Logger::info("No cards due for study in the selected decks", "Main");
+        showStyledMessageBox("MindLeap", "No cards are currently due for study in the selected decks.", QMessageBox::Information);
         statusBar()->showMessage("No cards due for study.");
     }
 }
@@ -667,11 +829,11 @@ void MainWindow::on_StudyButton_clicked() {
     const QString deckID = ui->Name->property("deckID").toString();
     
     this->currentDeckID = deckID;
-    this->currentDeckObj = Deck(deckID);
+    this->currentSession = StudySession({ deckID });
     
-    if (currentDeckObj.study()) {
+    if (currentSession.start()) {
         Logger::info("Study session started", QString("DeckID: %1").arg(deckID));
-        DiscordManager::updatePresence("Studying", currentDeckObj.getName(), "study");
+        DiscordManager::updatePresence("Studying", ui->Name->text(), "study");
 
         // Only hide elements if we actually have cards to study
         ui->deckWidget->setVisible(false);
@@ -694,20 +856,42 @@ void MainWindow::on_StudyButton_clicked() {
 }
 
 void MainWindow::proceedToNextCard(){
+    learningTimer->stop();
+    if (!currentSession.isActive()) return;
+
     // Get Next Card
-    this->currentCard = currentDeckObj.getNextCard();
+    this->currentCard = currentSession.getNextCard();
+
+    // Nothing else to study, wait for the earliest learning card
+    if (this->currentCard.isEmpty()) {
+        if (const std::optional<qint64> due = currentSession.getNextLearningDue()) {
+            ui->GetAnswerButton->setVisible(false);
+            ui->AgainButton->setVisible(false);
+            ui->HardButton->setVisible(false);
+            ui->GoodButton->setVisible(false);
+            ui->EasyButton->setVisible(false);
+
+            const QDateTime dueAt = QDateTime::fromSecsSinceEpoch(*due);
+            ui->cardQuestion->setText("Learning cards are shown again at " + dueAt.toString("HH:mm:ss"));
+            ui->cardAnswer->setVisible(false);
+
+            learningTimer->start(static_cast<int>(std::max<qint64>(0, QDateTime::currentDateTime().msecsTo(dueAt))));
+            return;
+        }
+    }
 
     if(this->currentCard.isEmpty()){
         ui->study->setVisible(false);
         ui->EndStudyButton->setVisible(false);
         ui->studyFinished->setVisible(true);
-        DiscordManager::updatePresence("Browsing Decks", "", "browse");
+        showBrowsingPresence();
 
-        if(!currentDeckObj.endStudy()){
+        if(!currentSession.end()){
             Logger::error("Could not end studying session", "Main");
         }
 
         this->currentDeckID.clear();
+        refreshDeckCounts(QString());
         return;
     }
 
@@ -727,7 +911,7 @@ void MainWindow::proceedToNextCard(){
     ui->cardAnswer->setVisible(false);
 
     // Update counters
-    const std::vector counters = currentDeckObj.getCardInformation();
+    const std::vector counters = currentSession.getCardInformation();
     if (!counters.empty()) {
         ui->UnseenCardCount->setText(QString::number(counters[0]));
         ui->PendingCardCount->setText(QString::number(counters[1]));
@@ -796,7 +980,7 @@ void MainWindow::onButtonOptionSelected(QPushButton* button) {
     else if (buttonText == "Easy") button_id = 4;
 
     // Process the card response
-    if (!currentDeckObj.processCardResponse(this->currentCard, button_id)) {
+    if (!currentSession.processCardResponse(this->currentCard, button_id)) {
         Logger::error("Card response could not be updated", "Main");
     }
 
@@ -821,16 +1005,19 @@ void MainWindow::on_StatsButton_clicked(){
 }
 
 void MainWindow::on_EndStudyButton_clicked() {
+    learningTimer->stop();
+
     ui->study->setVisible(false);
     ui->EndStudyButton->setVisible(false);
 
     ui->studyFinished->setVisible(true);
 
-    if(!currentDeckObj.endStudy()){
+    if(!currentSession.end()){
         this->statusBar()->showMessage("Error: Could not end studying session.");
         return;
     }
 
     this->currentDeckID.clear();
+    refreshDeckCounts(QString());
 }
 
@@ -0,0 +1,25 @@
+#include <QCoreApplication>
+
+#include "Frontend/statsnotifier.h"
+
+StatsNotifier::StatsNotifier(QObject *parent) : QObject(parent) {
+    StatsService::setListener(this);
+}
+
+StatsNotifier::~StatsNotifier() {
+    StatsService::setListener(nullptr);
+}
+
+StatsNotifier* StatsNotifier::instance() {
+    // Deleted with the application
+    static StatsNotifier* notifier = new StatsNotifier(QCoreApplication::instance());
+    return notifier;
+}
+
+void StatsNotifier::statsChanged(const StatsChange change, const QString& deckID) {
+    switch (change) {
+        case StatsChange::User: emit userStatsChanged(); break;
+        case StatsChange::Deck: emit deckStatsChanged(deckID); break;
+        case StatsChange::Counts: emit deckCountsChanged(deckID); break;
+    }
+}
@@ -1,6 +1,8 @@
 #include <QApplication>
 #include "Frontend/mainwindow.h"
 #include "Backend/Utilities/DiscordManager.hpp"
+#include "Backend/Classes/AnswerTimes.hpp"
+#include "Backend/Database/committer.hpp"
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
@@ -13,7 +15,15 @@ int main(int argc, char *argv[]) {
     mainWindow.show();
 
     int result = app.exec();
-    
+
+    // Nothing may use the database after it is closed
+    mainWindow.waitForOptimizer();
+
+    // Save the answers still in the queue
+    ReviewCommitter::getInstance()->stop();
+    // and the times of a session left open
+    AnswerTimes::save();
+
     DiscordManager::shutdown();
     return result;
 }
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include <catch2/catch_all.hpp>
+
+#include <climits>
+#include <random>
+#include <vector>
+
+#include "Backend/Classes/Algorithms/Registry.hpp"
+
+namespace {
+    constexpr AlgorithmID ALGORITHMS[] = { AlgorithmID::SM2, AlgorithmID::Leitner };
+
+    // Same deterministic collection for both paths
+    void fillBatch(StateBatch& batch, std::vector<quint8>& buttons, const size_t count) {
+        std::mt19937 random(42);
+        std::uniform_int_distribution<int> interval(0, 400);
+        std::uniform_int_distribution<int> ease(130, 320);
+        std::uniform_int_distribution<int> repetitions(0, 12);
+        std::uniform_int_distribution<int> button(0, 5); // 0 and 5 are invalid, state is kept
+
+        batch.resize(count);
+        buttons.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            batch.interval[i] = interval(random);
+            batch.ease_factor[i] = static_cast<float>(ease(random)) / 100.0f;
+            batch.repetitions[i] = repetitions(random);
+            buttons[i] = static_cast<quint8>(button(random));
+        }
+    }
+
+    CardState stateAt(const StateBatch& batch, const size_t i) {
+        CardState state;
+        state.interval = batch.interval[i];
+        state.ease_factor = batch.ease_factor[i];
+        state.repetitions = static_cast<quint16>(batch.repetitions[i]);
+        return state;
+    }
+}
+
+TEST_CASE("Batch scheduling matches answering card by card", "[algorithm]") {
+    for (const AlgorithmID id : ALGORITHMS) {
+        StateBatch batch;
+        std::vector<quint8> buttons;
+        fillBatch(batch, buttons, 4096);
+
+        // New cards take the first-answer paths
+        for (size_t i = 0; i < 64; ++i) {
+            batch.interval[i] = 0;
+            batch.repetitions[i] = 0;
+        }
+
+        const StateBatch before = batch;
+        Algorithms::calculateBatch(id, batch, buttons);
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            CardState state = stateAt(before, i);
+            if (buttons[i] >= 1 && buttons[i] <= 4) Algorithms::calculateInterval(id, state, buttons[i]);
+
+            INFO("card " << i << ", button " << int(buttons[i]));
+            REQUIRE(batch.interval[i] == state.interval);
+            REQUIRE(batch.ease_factor[i] == state.ease_factor);
+            REQUIRE(batch.repetitions[i] == state.repetitions);
+        }
+    }
+}
+
+TEST_CASE("Batch scheduling caps intervals that would overflow an int", "[algorithm]") {
+    // Grown past INT_MAX by the Good and Easy factors of both algorithms
+    constexpr int LONG_INTERVAL = INT_MAX / 3;
+
+    for (const AlgorithmID id : ALGORITHMS) {
+        StateBatch batch;
+        batch.resize(4);
+        const std::vector<quint8> buttons = { 1, 2, 3, 4 };
+        for (size_t i = 0; i < batch.size(); ++i) {
+            batch.interval[i] = LONG_INTERVAL;
+            batch.ease_factor[i] = 2.5f;
+            batch.repetitions[i] = 5;
+        }
+
+        const StateBatch before = batch;
+        Algorithms::calculateBatch(id, batch, buttons);
+
+        for (size_t i = 0; i < batch.size(); ++i) {
+            CardState state = stateAt(before, i);
+            Algorithms::calculateInterval(id, state, buttons[i]);
+
+            INFO(Algorithms::name(id).toStdString() << ", button " << int(buttons[i]));
+            REQUIRE(batch.interval[i] == state.interval);
+            REQUIRE(batch.interval[i] >= 0);
+            REQUIRE(batch.interval[i] <= MAX_INTERVAL);
+            REQUIRE(batch.ease_factor[i] == state.ease_factor);
+            REQUIRE(batch.repetitions[i] == state.repetitions);
+        }
+
+        REQUIRE(batch.interval[2] == MAX_INTERVAL);
+        REQUIRE(batch.interval[3] == MAX_INTERVAL);
+    }
+}
+
+// Run with: MindLeap_tests "[benchmark]"
+TEST_CASE("Batch scheduling on 1M cards", "[.][benchmark][algorithm]") {
+    constexpr size_t COLLECTION_SIZE = 1000000;
+
+    StateBatch collection;
+    std::vector<quint8> buttons;
+    fillBatch(collection, buttons, COLLECTION_SIZE);
+    for (quint8& button : buttons) button = button % 4 + 1;
+
+    for (const AlgorithmID id : ALGORITHMS) {
+        const QString name = Algorithms::name(id);
+
+        BENCHMARK((name + ", card by card").toStdString()) {
+            int total = 0;
+            for (size_t i = 0; i < COLLECTION_SIZE; ++i) {
+                CardState state = stateAt(collection, i);
+                Algorithms::calculateInterval(id, state, buttons[i]);
+                total += state.interval;
+            }
+            return total;
+        };
+
+        BENCHMARK((name + ", batch").toStdString()) {
+            StateBatch batch = collection;
+            Algorithms::calculateBatch(id, batch, buttons);
+            return batch.interval.back();
+        };
+    }
+}
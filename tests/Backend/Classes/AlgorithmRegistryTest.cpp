@@ -0,0 +1,46 @@
+#include <catch2/catch_all.hpp>
+
+#include "Backend/Classes/Algorithms/Registry.hpp"
+
+TEST_CASE("Algorithm names map to their registry entries", "[algorithm]") {
+    REQUIRE(Algorithms::fromName("SM2") == AlgorithmID::SM2);
+    REQUIRE(Algorithms::fromName("sm2") == AlgorithmID::SM2);
+    REQUIRE(Algorithms::fromName("leitner") == AlgorithmID::Leitner);
+    REQUIRE(Algorithms::fromName("fsrs") == AlgorithmID::FSRS);
+    REQUIRE_FALSE(Algorithms::fromName("FSRS-0").has_value());
+
+    for (const AlgorithmID id : { AlgorithmID::SM2, AlgorithmID::Leitner, AlgorithmID::FSRS }) {
+        REQUIRE(Algorithms::fromName(Algorithms::name(id)) == id);
+        REQUIRE(std::visit([](const auto& algorithm) { return std::decay_t<decltype(algorithm)>::ID; }, Algorithms::get(id)) == id);
+    }
+}
+
+TEST_CASE("Algorithms only change the state they declare", "[algorithm]") {
+    for (const AlgorithmID id : { AlgorithmID::SM2, AlgorithmID::Leitner, AlgorithmID::FSRS }) {
+        for (int button = 1; button <= 4; ++button) {
+            CardState state;
+            state.card_id = 7;
+            state.due = 1000;
+            state.last_seen = 500;
+            state.interval = 10;
+            state.ease_factor = 2.0f;
+            state.repetitions = 3;
+            state.lapses = 1;
+
+            Algorithms::calculateInterval(id, state, button, { 900, QString() });
+
+            const unsigned declared = Algorithms::changes(id);
+            if (!(declared & StateField::Interval)) REQUIRE(state.interval == 10);
+            if (!(declared & StateField::EaseFactor)) REQUIRE(state.ease_factor == 2.0f);
+            if (!(declared & StateField::Repetitions)) REQUIRE(state.repetitions == 3);
+            if (!(declared & StateField::Stability)) REQUIRE(state.stability == 0.0f);
+            if (!(declared & StateField::Difficulty)) REQUIRE(state.difficulty == 0.0f);
+
+            // Identity, timing and lapses belong to the answer path
+            REQUIRE(state.card_id == 7);
+            REQUIRE(state.due == 1000);
+            REQUIRE(state.last_seen == 500);
+            REQUIRE(state.lapses == 1);
+        }
+    }
+}
@@ -0,0 +1,91 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdlib>
+
+#include "Backend/Classes/AnswerTimes.hpp"
+#include "Backend/Database/statements.hpp"
+#include "TestDatabase.hpp"
+
+using namespace TestDatabase;
+using Histogram = AnswerTimes::Histogram;
+
+TEST_CASE("Answer time buckets hold the times they count", "[answertimes]") {
+    int previous = 0;
+    for (qint64 ms = 0; ms <= Histogram::MAX_MS; ms += ms < 4096 ? 1 : 97) {
+        const int index = Histogram::indexOf(ms);
+        REQUIRE(index >= previous);
+        REQUIRE(index < Histogram::BUCKETS);
+        REQUIRE(Histogram::lowestOf(index) <= ms);
+        REQUIRE(ms < Histogram::lowestOf(index) + Histogram::widthOf(index));
+        previous = index;
+    }
+
+    // Exact below 128 ms, within 1/64 above
+    REQUIRE(Histogram::widthOf(Histogram::indexOf(127)) == 1);
+    REQUIRE(Histogram::widthOf(Histogram::indexOf(128)) == 2);
+    REQUIRE(Histogram::widthOf(Histogram::indexOf(60000)) * 64 <= 60000);
+
+    // Out of range times are clamped
+    REQUIRE(Histogram::indexOf(-5) == 0);
+    REQUIRE(Histogram::indexOf(24 * Histogram::MAX_MS) == Histogram::indexOf(Histogram::MAX_MS));
+}
+
+TEST_CASE("Answer time percentiles", "[answertimes]") {
+    Histogram histogram;
+    REQUIRE(histogram.percentile(0.5) == 0);
+
+    for (qint64 ms = 1; ms <= 100; ++ms) histogram.record(ms * 100);
+    REQUIRE(histogram.total() == 100);
+
+    const auto near = [](const qint64 value, const qint64 expected) {
+        return std::abs(value - expected) * 64 <= expected;
+    };
+    REQUIRE(near(histogram.percentile(0.5), 5000));
+    REQUIRE(near(histogram.percentile(0.9), 9000));
+    REQUIRE(near(histogram.percentile(0.99), 9900));
+    REQUIRE(near(histogram.percentile(1.0), 10000));
+
+    Histogram fast;
+    fast.record(50, 300);
+    histogram.add(fast);
+    REQUIRE(histogram.total() == 400);
+    REQUIRE(histogram.percentile(0.5) == 50);
+}
+
+TEST_CASE("Answer time histograms survive a round trip through the database", "[answertimes]") {
+    Histogram histogram;
+    histogram.record(0);
+    histogram.record(850, 3);
+    histogram.record(12345, 200);
+    histogram.record(Histogram::MAX_MS);
+
+    const QByteArray data = histogram.encode();
+    REQUIRE(data.size() < 16);
+
+    {
+        const Connection connection("answer_times_test");
+        const QSqlDatabase& db = connection.get();
+        createUser(db, 1);
+
+        // Written twice, the second one replaces the first
+        for (const QByteArray& blob : { Histogram().encode(), data }) {
+            run(db, UPSERT_ANSWER_TIMES, { USER, deckID(1), blob });
+        }
+
+        QSqlQuery query = run(db, SELECT_ANSWER_TIMES, { USER });
+        REQUIRE(query.next());
+        REQUIRE(query.value(0).toString() == deckID(1));
+
+        const std::optional<Histogram> read = Histogram::decode(query.value(1).toByteArray());
+        REQUIRE(read);
+        REQUIRE(read->total() == histogram.total());
+        REQUIRE(read->encode() == data);
+        REQUIRE_FALSE(query.next());
+    }
+
+    // Anything else is refused
+    REQUIRE_FALSE(Histogram::decode(QByteArray()));
+    REQUIRE_FALSE(Histogram::decode(QByteArray("\x02\x00\x01", 3)));
+    REQUIRE_FALSE(Histogram::decode(QByteArray("\x01\x80", 2)));
+    REQUIRE_FALSE(Histogram::decode(QByteArray("\x01\xff\x7f\x01", 4)));
+}
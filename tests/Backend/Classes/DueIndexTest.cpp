@@ -0,0 +1,37 @@
+#include <catch2/catch_all.hpp>
+
+#include "Backend/Classes/DueIndex.hpp"
+
+TEST_CASE("Due index counts and limits follow the answers", "[study]") {
+    constexpr qint64 now = 1000000;
+
+    DueIndex index;
+    index.setLimits(2, 10, 1, 0);
+    index.add("00000001", CardType::New, std::nullopt, now);
+    index.add("00000002", CardType::New, std::nullopt, now);
+    index.add("00000003", CardType::Learning, now, now);
+    index.add("00000004", CardType::Review, now - 10, now);
+    index.add("00000005", CardType::Review, now + 60, now);
+    index.finish();
+
+    // One new card was already studied today
+    DueIndex::Counts counts = index.counts(now);
+    REQUIRE(counts.available_new == 1);
+    REQUIRE(counts.learning == 1);
+    REQUIRE(counts.due_reviews == 1);
+
+    // The second review becomes due with the clock
+    REQUIRE(index.counts(now + 60).due_reviews == 2);
+
+    index.answered("00000001", CardType::New, CardType::Learning);
+    index.answered("00000004", CardType::Review, CardType::Review);
+
+    counts = index.counts(now + 60);
+    REQUIRE(counts.available_new == 0);
+    REQUIRE(counts.learning == 2);
+    REQUIRE(counts.due_reviews == 1);
+    REQUIRE_FALSE(index.canStudy(CardType::New));
+    REQUIRE(index.canStudy(CardType::Review));
+    REQUIRE(index.isScheduled("00000001"));
+    REQUIRE_FALSE(index.isScheduled("00000002"));
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch_all.hpp>
+
+#include <random>
+
+#include "Backend/Classes/Algorithms/FSRSOptimizer.hpp"
+
+namespace {
+    constexpr qint64 DAY_MS = 86400000;
+
+    // Answers drawn from the model itself with the given weights, each card reviewed on its schedule
+    FSRSOptimizer::History simulate(const FSRSAlgorithm::Weights& truth, const int cards, const int answersPerCard) {
+        FSRSOptimizer::History history;
+        std::mt19937 random(7);
+        std::uniform_real_distribution<double> chance(0.0, 1.0);
+
+        for (int card = 0; card < cards; ++card) {
+            qint64 time = 0;
+            int button = static_cast<int>(random() % 4) + 1;
+            history.add(card, time, button);
+            FSRSAlgorithm::Memory<double> memory = FSRSAlgorithm::first<double>(truth, button);
+
+            for (int answer = 1; answer < answersPerCard; ++answer) {
+                const int interval = button == 1 ? 1 : FSRSAlgorithm::intervalFor(memory.stability);
+                time += static_cast<qint64>(interval * (0.8 + 0.4 * chance(random)) * DAY_MS);
+
+                const bool recalled = chance(random) < FSRSAlgorithm::retrievability(interval, memory.stability);
+                button = !recalled ? 1 : chance(random) < 0.15 ? 2 : chance(random) < 0.85 ? 3 : 4;
+
+                // The model sees the elapsed time the way the optimizer reads it back
+                history.add(card, time, button);
+                memory = FSRSAlgorithm::next(truth, memory, history.elapsed_days.back(), button);
+            }
+        }
+        return history;
+    }
+
+    FSRSAlgorithm::Weights shiftedWeights() {
+        FSRSAlgorithm::Weights weights = FSRSAlgorithm::DEFAULT_WEIGHTS;
+        weights[2] = 6.0;
+        weights[4] = 6.5;
+        weights[8] = 1.2;
+        weights[11] = 1.5;
+        return weights;
+    }
+}
+
+TEST_CASE("FSRS schedules from stability and difficulty", "[algorithm][fsrs]") {
+    const FSRSAlgorithm::Weights& w = FSRSAlgorithm::DEFAULT_WEIGHTS;
+
+    // At 90% desired retention the interval is the stability
+    REQUIRE(FSRSAlgorithm::retrievability(10.0, 10.0) == Catch::Approx(0.9));
+    REQUIRE(FSRSAlgorithm::intervalFor(10.0) == 10);
+    REQUIRE(FSRSAlgorithm::intervalFor(0.2) == 1);
+
+    FSRSAlgorithm algorithm;
+    CardState state;
+    algorithm.calculateInterval(state, 3, {});
+    REQUIRE(state.stability == Catch::Approx(w[2]));
+    REQUIRE(state.difficulty == Catch::Approx(w[4]));
+    REQUIRE(state.interval == FSRSAlgorithm::intervalFor(w[2]));
+    REQUIRE(state.repetitions == 1);
+
+    // Recalled late the card gets more stable, forgotten it gets less stable and harder
+    const FSRSAlgorithm::Memory<double> memory = { 10.0, 5.0 };
+    const auto good = FSRSAlgorithm::next(w, memory, 10.0, 3);
+    const auto again = FSRSAlgorithm::next(w, memory, 10.0, 1);
+    REQUIRE(good.stability > 10.0);
+    REQUIRE(again.stability < 10.0);
+    REQUIRE(again.difficulty > good.difficulty);
+
+    // Batch answers follow the same model
+    StateBatch batch;
+    batch.resize(2);
+    batch.stability = { 10.0f, 0.0f };
+    batch.difficulty = { 5.0f, 0.0f };
+    batch.interval = { 10, 0 };
+    batch.elapsed_days = { 10.0f, 0.0f };
+    const std::vector<quint8> buttons = { 1, 4 };
+    FSRSAlgorithm(w).calculateBatch(batch, buttons);
+
+    REQUIRE(batch.stability[0] == static_cast<float>(again.stability));
+    REQUIRE(batch.interval[0] == 0);
+    REQUIRE(batch.stability[1] == static_cast<float>(w[3]));
+    REQUIRE(batch.interval[1] == FSRSAlgorithm::intervalFor(static_cast<float>(w[3])));
+}
+
+TEST_CASE("FSRS follows the published FSRS-4.5 formulas", "[algorithm][fsrs]") {
+    const FSRSAlgorithm::Weights& w = FSRSAlgorithm::DEFAULT_WEIGHTS;
+
+    // First Good, then answered three days later. Reference values worked out from the FSRS-4.5
+    // formulas with the default weights, difficulty reverts towards D0(3) = w[4]
+    const auto first = FSRSAlgorithm::first<double>(w, 3);
+    REQUIRE(FSRSAlgorithm::retrievability(3.0, first.stability) == Catch::Approx(0.9169113).epsilon(1e-6));
+
+    const auto good = FSRSAlgorithm::next(w, first, 3.0, 3);
+    REQUIRE(good.stability == Catch::Approx(12.2623506).epsilon(1e-6));
+    REQUIRE(good.difficulty == Catch::Approx(5.1618).epsilon(1e-6));
+
+    const auto again = FSRSAlgorithm::next(w, first, 3.0, 1);
+    REQUIRE(again.stability == Catch::Approx(1.3809605).epsilon(1e-6));
+    REQUIRE(again.difficulty == Catch::Approx(6.9011550).epsilon(1e-6));
+
+    const auto easy = FSRSAlgorithm::next(w, first, 3.0, 4);
+    REQUIRE(easy.difficulty == Catch::Approx(4.2921225).epsilon(1e-6));
+
+    // Forgetting a barely learned card a month later still takes the formula's stability,
+    // above the previous one
+    const auto lapse = FSRSAlgorithm::next(w, FSRSAlgorithm::Memory<double>{ 0.5, 1.0 }, 30.0, 1);
+    REQUIRE(lapse.stability == Catch::Approx(0.9629565).epsilon(1e-6));
+}
+
+TEST_CASE("FSRS weights round-trip through their stored text", "[algorithm][fsrs]") {
+    const std::optional<FSRSAlgorithm::Weights> parsed = FSRSAlgorithm::fromText(FSRSAlgorithm::toText(shiftedWeights()));
+    REQUIRE(parsed.has_value());
+    REQUIRE(*parsed == shiftedWeights());
+
+    REQUIRE_FALSE(FSRSAlgorithm::fromText("1 2 3").has_value());
+}
+
+TEST_CASE("FSRS optimizer fits the weights a history was drawn from", "[algorithm][fsrs]") {
+    const FSRSAlgorithm::Weights truth = shiftedWeights();
+    const FSRSOptimizer::History history = simulate(truth, 2000, 10);
+    REQUIRE(history.cards() == 2000);
+    REQUIRE(history.reviews() == 20000);
+
+    const FSRSOptimizer::Result single = FSRSOptimizer::fit(history, 1);
+    const FSRSOptimizer::Result parallel = FSRSOptimizer::fit(history, 4);
+
+    // Chunk results are added in order, the thread count does not change a single bit
+    REQUIRE(single.weights == parallel.weights);
+    REQUIRE(single.log_loss_after == parallel.log_loss_after);
+
+    REQUIRE(single.log_loss_after < single.log_loss_before);
+    REQUIRE(single.log_loss_after < FSRSOptimizer::logLoss(history, truth, 1) + 0.005);
+}
+
+// Run with: MindLeap_tests "[benchmark]"
+TEST_CASE("FSRS optimizer on 1M reviews", "[.][benchmark][fsrs]") {
+    const FSRSOptimizer::History history = simulate(shiftedWeights(), 100000, 10);
+
+    BENCHMARK("fit, 1M reviews, every core") {
+        return FSRSOptimizer::fit(history).log_loss_after;
+    };
+}
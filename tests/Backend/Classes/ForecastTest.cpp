@@ -0,0 +1,70 @@
+#include <catch2/catch_all.hpp>
+
+#include <numeric>
+
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Database/statements.hpp"
+#include "TestDatabase.hpp"
+
+using namespace TestDatabase;
+
+namespace {
+    constexpr qint64 DAY = 86400;
+    constexpr qint64 DAY_START = 1700000000;
+
+    Forecast::Snapshot buildForecast(const QSqlDatabase& db) {
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        REQUIRE(query.prepare(SELECT_FORECAST_STATE));
+        query.bindValue(0, USER);
+        query.bindValue(1, DAY_START + Forecast::DAYS * DAY);
+        REQUIRE(query.exec());
+        return Forecast::build(query, DAY_START);
+    }
+}
+
+TEST_CASE("Forecast counts every scheduled card on its due day", "[forecast]") {
+    const Connection connection("forecast_test");
+    const QSqlDatabase& db = connection.get();
+    createUser(db, 2);
+
+    Cards cards(db);
+    cards.add(1, 1, DAY_START - 3 * DAY); // Overdue
+    cards.add(2, 1, DAY_START + DAY + 60);
+    cards.add(3, 2, DAY_START + DAY + 120);
+    cards.add(4, 2, DAY_START + 400 * DAY); // Past the last day
+    cards.add(5, 2, std::nullopt);          // Never answered
+
+    // Card 2 is in both decks
+    cards.link(2, 2);
+
+    const Forecast::Snapshot snapshot = buildForecast(db);
+    REQUIRE(snapshot.total[0] == 1);
+    REQUIRE(snapshot.total[1] == 2);
+    REQUIRE(std::accumulate(snapshot.total.begin(), snapshot.total.end(), 0) == 3);
+
+    REQUIRE(snapshot.decks.at(deckID(1))[0] == 1);
+    REQUIRE(snapshot.decks.at(deckID(1))[1] == 1);
+    REQUIRE(snapshot.decks.at(deckID(2))[1] == 2);
+
+    REQUIRE(Forecast::dayIndex(DAY_START - 1, DAY_START) == 0);
+    REQUIRE(Forecast::dayIndex(DAY_START + Forecast::DAYS * DAY, DAY_START) == -1);
+}
+
+// Run with: MindLeap_tests "[benchmark]"
+TEST_CASE("Forecast build on 100k scheduled cards", "[.][benchmark][forecast]") {
+    constexpr int COLLECTION_SIZE = 100000;
+    constexpr int DECKS = 20;
+    const Connection connection("forecast_bench");
+    QSqlDatabase db = connection.get();
+    createUser(db, DECKS);
+
+    db.transaction();
+    Cards cards(db);
+    for (int i = 1; i <= COLLECTION_SIZE; ++i) cards.add(i, i % DECKS + 1, DAY_START + (i % 500) * DAY);
+    db.commit();
+
+    BENCHMARK("forecast, 100k cards") {
+        return buildForecast(db).total[0];
+    };
+}
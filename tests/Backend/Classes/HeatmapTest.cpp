@@ -0,0 +1,119 @@
+#include <catch2/catch_all.hpp>
+
+#include <QDateTime>
+#include <QTimeZone>
+
+#include "Backend/Classes/Heatmap.hpp"
+#include "Backend/Database/statements.hpp"
+#include "TestDatabase.hpp"
+
+using namespace TestDatabase;
+
+namespace {
+    constexpr qint64 HOUR_MS = 3600 * 1000;
+
+    // User 1 with one card to answer
+    void createAnswerer(const QSqlDatabase& db) {
+        createUser(db, 1);
+        Cards(db).add(1, 1, std::nullopt, "New");
+    }
+
+    // Answer at the given time of the UTC day, the day the UserStats rows are dated with
+    void addReview(QSqlQuery& review, const QDate& date, const qint64 offsetMs, const qint64 durationMs) {
+        review.bindValue(0, date.startOfDay(QTimeZone::utc()).toMSecsSinceEpoch() + offsetMs);
+        review.bindValue(1, durationMs);
+        REQUIRE(review.exec());
+    }
+
+    Heatmap::Snapshot buildHeatmap(const QSqlDatabase& db) {
+        QSqlQuery earlierDays(db), reviews(db);
+        earlierDays.setForwardOnly(true);
+        reviews.setForwardOnly(true);
+        REQUIRE(earlierDays.prepare(SELECT_HEATMAP_EARLIER_DAYS));
+        REQUIRE(reviews.prepare(SELECT_HEATMAP_REVIEWS));
+        earlierDays.bindValue(0, USER);
+        earlierDays.bindValue(1, USER);
+        reviews.bindValue(0, USER);
+        REQUIRE(earlierDays.exec());
+        REQUIRE(reviews.exec());
+        return Heatmap::build(earlierDays, reviews);
+    }
+}
+
+TEST_CASE("Heatmap puts every answer on the day of its stats row", "[heatmap]") {
+    const Connection connection("heatmap_test");
+    const QSqlDatabase& db = connection.get();
+    createAnswerer(db);
+
+    const QDate first(2024, 3, 1);
+    QSqlQuery query(db);
+    // Daily totals from before the review log, the last one overlaps it and is left out
+    REQUIRE(query.exec("INSERT INTO UserStats (id, date, cards_seen, time_spent_seconds) VALUES (1, '2024-02-27', 12, 60)"));
+    REQUIRE(query.exec("INSERT INTO UserStats (id, date, cards_seen, time_spent_seconds) VALUES (1, '2024-03-01', 40, 0)"));
+
+    QSqlQuery review(db);
+    review.prepare("INSERT INTO ReviewLog (card_id, user_id, reviewed_at, card_type, button, interval_before, "
+                   "interval_after, ease, duration_ms) VALUES (1, 1, ?, 0, 3, 0, 1, 2500, ?)");
+    addReview(review, first, 12 * HOUR_MS, 4000);
+    addReview(review, first, 23 * HOUR_MS, 1500);
+    addReview(review, first.addDays(1), 0, 2500); // Midnight starts the next day
+    addReview(review, first.addDays(5), 8 * HOUR_MS, 90000);
+
+    const Heatmap::Snapshot snapshot = buildHeatmap(db);
+    REQUIRE(snapshot.first_day == Heatmap::epochDay(QDate(2024, 2, 27)));
+    REQUIRE(snapshot.days.size() == 9);
+
+    REQUIRE(snapshot.at(Heatmap::epochDay(QDate(2024, 2, 27))).reviews == 12);
+    REQUIRE(snapshot.at(Heatmap::epochDay(QDate(2024, 2, 27))).duration_ms == 60000);
+    REQUIRE(snapshot.at(Heatmap::epochDay(QDate(2024, 2, 28))).reviews == 0);
+    REQUIRE(snapshot.at(Heatmap::epochDay(first)).reviews == 2);
+    REQUIRE(snapshot.at(Heatmap::epochDay(first)).duration_ms == 5500);
+    REQUIRE(snapshot.at(Heatmap::epochDay(first.addDays(1))).reviews == 1);
+    REQUIRE(snapshot.at(Heatmap::epochDay(first.addDays(5))).duration_ms == 90000);
+    REQUIRE(snapshot.at(Heatmap::epochDay(first.addDays(6))).reviews == 0); // Past the end
+
+    REQUIRE(Heatmap::dateOf(Heatmap::epochDay(first)) == first);
+    REQUIRE(Heatmap::epochDayOf(first.startOfDay(QTimeZone::utc()).toMSecsSinceEpoch() - 1) == Heatmap::epochDay(first) - 1);
+    REQUIRE(Heatmap::epochDayOf(-1) == -1);
+    REQUIRE(Heatmap::epochDay(QDate(1970, 1, 2)) == 1);
+}
+
+TEST_CASE("Heatmap grows with new answers", "[heatmap]") {
+    Heatmap::Snapshot snapshot;
+    Heatmap::add(snapshot, 100, 1, 2000);
+    REQUIRE(snapshot.first_day == 100);
+    REQUIRE(snapshot.days.size() == 1);
+
+    Heatmap::add(snapshot, 130, 1, 3000);
+    Heatmap::add(snapshot, 130, 1, 3000);
+    REQUIRE(snapshot.days.size() == 31);
+    REQUIRE(snapshot.at(130).reviews == 2);
+    REQUIRE(snapshot.at(130).duration_ms == 6000);
+
+    // A clock set back counts on the first day
+    Heatmap::add(snapshot, 90, 1, 1000);
+    REQUIRE(snapshot.at(100).reviews == 2);
+}
+
+// Run with: MindLeap_tests "[benchmark]"
+TEST_CASE("Heatmap build on 200k answers", "[.][benchmark][heatmap]") {
+    constexpr int ANSWERS = 200000;
+    const Connection connection("heatmap_bench");
+    QSqlDatabase db = connection.get();
+    createAnswerer(db);
+
+    // About three years, 180 answers a day
+    const QDate first(2022, 1, 1);
+    db.transaction();
+    QSqlQuery review(db);
+    review.prepare("INSERT INTO ReviewLog (card_id, user_id, reviewed_at, card_type, button, interval_before, "
+                   "interval_after, ease, duration_ms) VALUES (1, 1, ?, 0, 3, 0, 1, 2500, ?)");
+    for (int i = 0; i < ANSWERS; ++i) {
+        addReview(review, first.addDays(i / 180), (i % 180) * 60000, 5000);
+    }
+    db.commit();
+
+    BENCHMARK("heatmap, 200k answers") {
+        return buildHeatmap(db).days.size();
+    };
+}
@@ -0,0 +1,135 @@
+#include <catch2/catch_all.hpp>
+
+#include <QDateTime>
+
+#include "Backend/Classes/Forecast.hpp"
+#include "Backend/Classes/Reschedule.hpp"
+#include "Backend/Classes/StatsService.hpp"
+#include "TestDatabase.hpp"
+
+using namespace TestDatabase;
+
+namespace {
+    constexpr qint64 DAY = 86400;
+
+    // Cards 1 to 10 in deck 1 and 11 in deck 2, all reviewed. Cards 1 to 8 are overdue by
+    // as many days, 9 and 10 due in one and two days, 11 overdue by one. User 2 only has
+    // card 1, overdue too.
+    qint64 fill(const QSqlDatabase& db) {
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        createUser(db, 2);
+
+        Cards cards(db);
+        for (int card = 1; card <= 8; ++card) cards.add(card, 1, now - card * DAY);
+        cards.add(9, 1, now + DAY);
+        cards.add(10, 1, now + 2 * DAY);
+        cards.add(11, 2, now - DAY);
+
+        run(db, "INSERT INTO Users (id, uid, username) VALUES (2, 'u0000002', 'Other')");
+        run(db, "INSERT INTO CardState (user_id, card_id, interval, due) VALUES (2, 1, 3, ?)", { now - DAY });
+        return now;
+    }
+
+    std::optional<qint64> dueOf(const QSqlDatabase& db, const int user, const int card) {
+        QSqlQuery query = run(db, "SELECT due FROM CardState WHERE user_id = ? AND card_id = ?", { user, card });
+        if (!query.next()) return std::nullopt;
+        return query.value(0).toLongLong();
+    }
+
+    QString typeOf(const QSqlDatabase& db, const int card) {
+        QSqlQuery query = run(db, "SELECT type FROM Cards WHERE id = ?", { card });
+        REQUIRE(query.next());
+        return query.value(0).toString();
+    }
+
+    // Cards the counts and the forecast of deck 1 show as due today
+    void requireDueToday(const int count) {
+        REQUIRE(StatsService::counts(USER, deckID(1)).due_reviews == count);
+        REQUIRE(Forecast::forDeck(USER, deckID(1))[0] == count);
+    }
+}
+
+TEST_CASE("Postponing moves only the overdue cards of the deck", "[reschedule]") {
+    const QSqlDatabase db = app();
+    const qint64 now = fill(db);
+    requireDueToday(8);
+
+    REQUIRE(Reschedule::postponeOverdue(deckID(1), 3) == 8);
+
+    for (int card = 1; card <= 8; ++card) REQUIRE(dueOf(db, 1, card) == now + (3 - card) * DAY);
+    REQUIRE(dueOf(db, 1, 9) == now + DAY);
+    REQUIRE(dueOf(db, 1, 10) == now + 2 * DAY);
+    // Another deck and another user
+    REQUIRE(dueOf(db, 1, 11) == now - DAY);
+    REQUIRE(dueOf(db, 2, 1) == now - DAY);
+
+    // Cards 3 to 8 are still due
+    requireDueToday(6);
+    REQUIRE(StatsService::counts(USER, deckID(2)).due_reviews == 1);
+}
+
+TEST_CASE("Spreading keeps the due order within the given days", "[reschedule]") {
+    const QSqlDatabase db = app();
+    const qint64 now = fill(db);
+    requireDueToday(8);
+
+    constexpr int DAYS = 3;
+    REQUIRE(Reschedule::spreadOverdue(deckID(1), DAYS) == 8);
+    const qint64 after = QDateTime::currentSecsSinceEpoch();
+
+    // The most overdue first, card 8 was due the earliest
+    const qint64 today = *dueOf(db, 1, 8);
+    REQUIRE(today >= now);
+    REQUIRE(today <= after);
+
+    qint64 previous = today;
+    for (int card = 8; card >= 1; --card) {
+        const qint64 due = *dueOf(db, 1, card);
+        REQUIRE(due >= previous);
+        REQUIRE(due < today + DAYS * DAY);
+        REQUIRE((due - today) % DAY == 0);
+        previous = due;
+    }
+    REQUIRE(dueOf(db, 1, 1) == today + (DAYS - 1) * DAY);
+
+    REQUIRE(dueOf(db, 1, 9) == now + DAY);
+    REQUIRE(dueOf(db, 1, 10) == now + 2 * DAY);
+    REQUIRE(dueOf(db, 1, 11) == now - DAY);
+    REQUIRE(dueOf(db, 2, 1) == now - DAY);
+
+    // A third of them, rounded up, stays on today
+    requireDueToday(3);
+}
+
+TEST_CASE("Forgetting resets only the selected cards", "[reschedule]") {
+    const QSqlDatabase db = app();
+    const qint64 now = fill(db);
+    requireDueToday(8);
+    REQUIRE(StatsService::counts(USER, deckID(1)).new_cards == 0);
+
+    REQUIRE(Reschedule::forget({ cardID(1), cardID(9) }) == 2);
+
+    for (const int card : { 1, 9 }) {
+        REQUIRE_FALSE(dueOf(db, 1, card).has_value());
+        REQUIRE(typeOf(db, card) == "New");
+    }
+    for (int card = 2; card <= 11; ++card) {
+        if (card == 9) continue;
+        REQUIRE(dueOf(db, 1, card).has_value());
+        REQUIRE(typeOf(db, card) == "Review");
+    }
+    // Another user's state of the same card stays
+    REQUIRE(dueOf(db, 2, 1) == now - DAY);
+
+    requireDueToday(7);
+    REQUIRE(StatsService::counts(USER, deckID(1)).new_cards == 2);
+
+    // The whole of deck 2
+    REQUIRE(StatsService::counts(USER, deckID(2)).due_reviews == 1);
+    REQUIRE(Reschedule::resetDeck(deckID(2)) == 1);
+    REQUIRE_FALSE(dueOf(db, 1, 11).has_value());
+    REQUIRE(typeOf(db, 11) == "New");
+    REQUIRE(StatsService::counts(USER, deckID(2)).due_reviews == 0);
+    REQUIRE(StatsService::counts(USER, deckID(2)).new_cards == 1);
+    REQUIRE(StatsService::counts(USER, deckID(1)).new_cards == 2);
+}
@@ -0,0 +1,90 @@
+#include <catch2/catch_all.hpp>
+
+#include "Backend/Classes/Simulator.hpp"
+
+namespace {
+    // Cards due over the coming weeks plus a backlog of new ones
+    Simulator::Collection mixedDeck(const int scheduled, const int fresh) {
+        Simulator::Collection collection;
+        for (int i = 0; i < scheduled; ++i) {
+            const int interval = 1 + i % 30;
+            collection.addScheduled(interval, 2.5f, 1 + i % 5, 0.0f, 0.0f, -interval + i % 7, i % 7);
+        }
+        for (int i = 0; i < fresh; ++i) collection.addNew();
+        return collection;
+    }
+}
+
+TEST_CASE("Simulator reports do not depend on the thread count", "[simulator]") {
+    const Simulator::Collection collection = mixedDeck(500, 300);
+    Simulator::Settings settings;
+    settings.days = 90;
+    settings.runs = 6;
+
+    for (const Algorithms::Any& algorithm : { Algorithms::Any(SM2Algorithm()), Algorithms::Any(FSRSAlgorithm()) }) {
+        const Simulator::Report single = Simulator::run(collection, algorithm, settings, 1);
+        const Simulator::Report parallel = Simulator::run(collection, algorithm, settings, 4);
+
+        REQUIRE(single.days.size() == 90);
+        REQUIRE(single.total_minutes == parallel.total_minutes);
+        REQUIRE(single.retention == parallel.retention);
+        for (int day = 0; day < settings.days; ++day) {
+            REQUIRE(single.days[day].reviews == parallel.days[day].reviews);
+            REQUIRE(single.days[day].minutes == parallel.days[day].minutes);
+        }
+    }
+}
+
+TEST_CASE("Simulator introduces new cards at the daily limit", "[simulator]") {
+    const Simulator::Collection collection = mixedDeck(0, 50);
+    Simulator::Settings settings;
+    settings.days = 5;
+    settings.runs = 2;
+
+    const Simulator::Report report = Simulator::run(collection, SM2Algorithm(), settings, 1);
+    REQUIRE(report.days[0].new_cards == 20);
+    REQUIRE(report.days[0].reviews == 0);
+    REQUIRE(report.days[1].new_cards == 20);
+    REQUIRE(report.days[2].new_cards == 10);
+    REQUIRE(report.days[3].new_cards == 0);
+    REQUIRE(report.days[0].minutes == Catch::Approx(20 * settings.new_seconds / 60.0));
+}
+
+TEST_CASE("Simulator holds a review limit back to the next day", "[simulator]") {
+    Simulator::Collection collection;
+    for (int i = 0; i < 30; ++i) collection.addScheduled(10, 2.5f, 3, 0.0f, 0.0f, -10, 0);
+
+    Simulator::Settings settings;
+    settings.days = 3;
+    settings.runs = 1;
+    settings.max_reviews_per_day = 12;
+
+    const Simulator::Report report = Simulator::run(collection, SM2Algorithm(), settings, 1);
+    REQUIRE(report.days[0].reviews == 12);
+    REQUIRE(report.days[1].reviews >= 12);
+    REQUIRE(report.days[2].reviews >= 6);
+}
+
+TEST_CASE("Simulator retention follows FSRS when its weights are the truth", "[simulator][fsrs]") {
+    const Simulator::Collection collection = mixedDeck(0, 2000);
+    Simulator::Settings settings;
+    settings.days = 200;
+    settings.runs = 4;
+    settings.new_cards_per_day = 40;
+
+    const Simulator::Report report = Simulator::run(collection, FSRSAlgorithm(settings.recall_weights), settings);
+    REQUIRE(report.retention == Catch::Approx(FSRSAlgorithm::DESIRED_RETENTION).margin(0.03));
+}
+
+// Run with: MindLeap_tests "[benchmark]"
+TEST_CASE("Simulator on 50k cards over a year", "[.][benchmark][simulator]") {
+    const Simulator::Collection collection = mixedDeck(40000, 10000);
+    const Simulator::Settings settings;
+
+    BENCHMARK("SM-2, 8 runs, every core") {
+        return Simulator::run(collection, SM2Algorithm(), settings).total_minutes;
+    };
+    BENCHMARK("FSRS, 8 runs, every core") {
+        return Simulator::run(collection, FSRSAlgorithm(settings.recall_weights), settings).total_minutes;
+    };
+}
@@ -0,0 +1,22 @@
+#include <catch2/catch_all.hpp>
+
+#include "Backend/Classes/User.hpp"
+#include "TestDatabase.hpp"
+
+using namespace TestDatabase;
+
+TEST_CASE("Users are listed in the order they were created", "[user]") {
+    const QSqlDatabase db = app();
+    // Public IDs are random, so they sort differently from the keys
+    run(db, "INSERT INTO Users (id, uid, username) VALUES (1, 'u00000ff', 'First')");
+    run(db, "INSERT INTO Users (id, uid, username) VALUES (2, 'u0000001', 'Second')");
+    run(db, "INSERT INTO Users (id, uid, username) VALUES (3, 'u00000aa', 'Third')");
+
+    const std::vector<User> users = User::listUsers();
+
+    REQUIRE(users.size() == 3);
+    REQUIRE(users[0].getID() == "u00000ff");
+    REQUIRE(users[1].getID() == "u0000001");
+    REQUIRE(users[2].getID() == "u00000aa");
+    REQUIRE(users[2].getUsername() == "Third");
+}
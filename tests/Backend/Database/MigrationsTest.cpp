@@ -0,0 +1,116 @@
+#include <catch2/catch_all.hpp>
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "Backend/Database/migrations.hpp"
+
+TEST_CASE("Migrations bring an empty database to the latest version", "[database]") {
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "migrations_test");
+        db.setDatabaseName(":memory:");
+        REQUIRE(db.open());
+
+        Migrator migrator(db);
+        REQUIRE(migrator.currentVersion() == 0);
+        REQUIRE(migrator.migrate());
+        REQUIRE(migrator.currentVersion() == Migrator::latestVersion());
+
+        // Second run is a no-op
+        REQUIRE(migrator.migrate());
+        REQUIRE(migrator.currentVersion() == Migrator::latestVersion());
+
+        QSqlQuery query(db);
+        REQUIRE(query.exec("SELECT COUNT(*) FROM sqlite_master WHERE type = 'table' AND name = 'Cards'"));
+        REQUIRE(query.next());
+        REQUIRE(query.value(0).toInt() == 1);
+    }
+    QSqlDatabase::removeDatabase("migrations_test");
+}
+
+TEST_CASE("A reset database migrates to the latest version again", "[database]") {
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "migrations_reset_test");
+        db.setDatabaseName(":memory:");
+        REQUIRE(db.open());
+
+        Migrator migrator(db);
+        REQUIRE(migrator.migrate());
+
+        QSqlQuery query(db);
+        REQUIRE(query.exec("INSERT INTO Users (id, uid, username) VALUES (1, 'u0000001', 'Test')"));
+        REQUIRE(query.exec("INSERT INTO FSRSWeights (user_id, weights, reviews, log_loss, fitted_at) VALUES (1, '', 0, 0, 0)"));
+
+        REQUIRE(migrator.dropAll());
+        REQUIRE(migrator.currentVersion() == 0);
+        REQUIRE(query.exec("SELECT COUNT(*) FROM sqlite_master WHERE name NOT LIKE 'sqlite_%'"));
+        REQUIRE(query.next());
+        REQUIRE(query.value(0).toInt() == 0);
+
+        // Every version runs again on the empty schema
+        REQUIRE(migrator.migrate());
+        REQUIRE(migrator.currentVersion() == Migrator::latestVersion());
+
+        REQUIRE(query.exec("SELECT COUNT(*) FROM Users"));
+        REQUIRE(query.next());
+        REQUIRE(query.value(0).toInt() == 0);
+    }
+    QSqlDatabase::removeDatabase("migrations_reset_test");
+}
+
+TEST_CASE("Migration versions are strictly increasing", "[database]") {
+    int previous = 0;
+    for (const Migration& migration : Migrator::migrations()) {
+        REQUIRE(migration.version > previous);
+        previous = migration.version;
+    }
+}
+
+TEST_CASE("Version 2 keeps rows and links when moving to integer keys", "[database]") {
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "migrations_v2_test");
+        db.setDatabaseName(":memory:");
+        REQUIRE(db.open());
+
+        // Build a version 1 collection by hand
+        QSqlQuery query(db);
+        for (const char* statement : Migrator::migrations().front().statements) {
+            REQUIRE(query.exec(QString::fromUtf8(statement)));
+        }
+        REQUIRE(query.exec("PRAGMA user_version = 1"));
+        REQUIRE(query.exec("INSERT INTO Users (id, username) VALUES ('a1b2c3d4', 'Default')"));
+        REQUIRE(query.exec("INSERT INTO SavedUser (id) VALUES ('a1b2c3d4')"));
+        REQUIRE(query.exec("INSERT INTO Decks (id, name) VALUES ('0000beef', 'Deck')"));
+        REQUIRE(query.exec("INSERT INTO Cards (id, question, answer) VALUES ('0000c0de', 'Q', 'A')"));
+        REQUIRE(query.exec("INSERT INTO DecksCards (deck_id, card_id) VALUES ('0000beef', '0000c0de')"));
+        REQUIRE(query.exec("INSERT INTO CardStats (id, user_id, date, interval) VALUES ('0000c0de', 'a1b2c3d4', DATE('now'), 4)"));
+        // Orphan left behind by a deleted deck
+        REQUIRE(query.exec("INSERT INTO DecksCards (deck_id, card_id) VALUES ('deadbeef', '0000c0de')"));
+
+        Migrator migrator(db);
+        REQUIRE(migrator.migrate());
+        REQUIRE(migrator.currentVersion() == Migrator::latestVersion());
+
+        REQUIRE(query.exec(R"(
+            SELECT c.uid, cs.interval FROM Cards c
+            INNER JOIN DecksCards dc ON c.id = dc.card_id
+            INNER JOIN CardStats cs ON c.id = cs.id
+            WHERE dc.deck_id = (SELECT id FROM Decks WHERE uid = '0000beef')
+              AND cs.user_id = (SELECT s.id FROM SavedUser s INNER JOIN Users u ON u.id = s.id WHERE u.uid = 'a1b2c3d4')
+        )"));
+        REQUIRE(query.next());
+        REQUIRE(query.value(0).toString() == "0000c0de");
+        REQUIRE(query.value(1).toInt() == 4);
+
+        REQUIRE(query.exec("SELECT COUNT(*) FROM DecksCards"));
+        REQUIRE(query.next());
+        REQUIRE(query.value(0).toInt() == 1);
+
+        // Version 4 seeds the scheduling state from the latest stats row
+        REQUIRE(query.exec("SELECT interval, due FROM CardState"));
+        REQUIRE(query.next());
+        REQUIRE(query.value(0).toInt() == 4);
+        REQUIRE(query.value(1).toLongLong() == 4 * 86400);
+    }
+    QSqlDatabase::removeDatabase("migrations_v2_test");
+}
@@ -0,0 +1,104 @@
+#include <catch2/catch_all.hpp>
+
+#include <QDateTime>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QTemporaryDir>
+
+#include "Backend/Database/profile.hpp"
+#include "Backend/Database/migrations.hpp"
+
+// Run with: MindLeap_tests "[benchmark]"
+// Measures the writes of one answer (CardStats, UserStats, DeckStats and the card type),
+// each in its own autocommit transaction like Deck::processCardResponse does.
+
+namespace {
+    constexpr int COLLECTION_SIZE = 100000;
+    // Integer keys, the user and the deck are the first rows of their tables
+    constexpr qint64 USER_ID = 1;
+    constexpr qint64 DECK_ID = 1;
+
+    qint64 cardID(const int index) {
+        return index + 1;
+    }
+
+    void createCollection(QSqlDatabase db) {
+        REQUIRE(Migrator(db).migrate());
+
+        db.transaction();
+        QSqlQuery query(db);
+        REQUIRE(query.exec(QString("INSERT INTO Users (id, uid, username) VALUES (%1, 'u0000001', 'Bench')").arg(USER_ID)));
+        REQUIRE(query.exec(QString("INSERT INTO Decks (id, uid, name) VALUES (%1, 'd0000001', 'Bench')").arg(DECK_ID)));
+        REQUIRE(query.exec(QString("INSERT INTO UserStats (id, date) VALUES (%1, DATE('now'))").arg(USER_ID)));
+        REQUIRE(query.exec(QString("INSERT INTO DeckStats (id, user_id, date) VALUES (%1, %2, DATE('now'))").arg(DECK_ID).arg(USER_ID)));
+
+        QSqlQuery card(db), link(db), stats(db);
+        card.prepare("INSERT INTO Cards (id, uid, question, answer, type) VALUES (?, ?, ?, ?, 'Review')");
+        link.prepare("INSERT INTO DecksCards (deck_id, card_id) VALUES (?, ?)");
+        stats.prepare("INSERT INTO CardStats (id, user_id, date, interval, repetitions, last_seen) VALUES (?, ?, DATE('now'), 3, 2, ?)");
+
+        const qint64 now = QDateTime::currentSecsSinceEpoch();
+        for (int i = 0; i < COLLECTION_SIZE; ++i) {
+            const qint64 id = cardID(i);
+            card.bindValue(0, id);
+            card.bindValue(1, QString("c%1").arg(i, 7, 10, QChar('0')));
+            card.bindValue(2, QString("Question %1").arg(i));
+            card.bindValue(3, QString("Answer %1").arg(i));
+            link.bindValue(0, DECK_ID);
+            link.bindValue(1, id);
+            stats.bindValue(0, id);
+            stats.bindValue(1, USER_ID);
+            stats.bindValue(2, now);
+            REQUIRE((card.exec() && link.exec() && stats.exec()));
+        }
+        db.commit();
+    }
+
+    void benchmarkProfile(const PerformanceProfile& profile, const QString& path) {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "bench_" + profile.name);
+        db.setDatabaseName(path);
+        REQUIRE(db.open());
+        REQUIRE(profile.apply(db));
+        createCollection(db);
+
+        {
+            QSqlQuery cardStats(db), userStats(db), deckStats(db), cardType(db);
+            cardStats.prepare("UPDATE CardStats SET interval = ?, ease_factor = ?, repetitions = repetitions + 1, "
+                              "last_seen = ?, times_seen = times_seen + 1 WHERE id = ? AND user_id = ? AND date = DATE('now')");
+            userStats.prepare("UPDATE UserStats SET cards_seen = cards_seen + 1, pressed_good = pressed_good + 1 "
+                              "WHERE id = ? AND date = DATE('now')");
+            deckStats.prepare("UPDATE DeckStats SET cards_seen = cards_seen + 1 WHERE id = ? AND user_id = ? AND date = DATE('now')");
+            cardType.prepare("UPDATE Cards SET type = 'Review' WHERE id = ?");
+
+            int next = 0;
+            BENCHMARK("answer, " + profile.name.toStdString() + " profile") {
+                const qint64 id = cardID(next++ % COLLECTION_SIZE);
+
+                cardStats.bindValue(0, 5);
+                cardStats.bindValue(1, 2.6);
+                cardStats.bindValue(2, QDateTime::currentSecsSinceEpoch());
+                cardStats.bindValue(3, id);
+                cardStats.bindValue(4, USER_ID);
+                userStats.bindValue(0, USER_ID);
+                deckStats.bindValue(0, DECK_ID);
+                deckStats.bindValue(1, USER_ID);
+                cardType.bindValue(0, id);
+
+                return cardStats.exec() && userStats.exec() && deckStats.exec() && cardType.exec();
+            };
+        }
+
+        db.close();
+        db = QSqlDatabase();
+        QSqlDatabase::removeDatabase("bench_" + profile.name);
+    }
+}
+
+TEST_CASE("Per-answer write latency by performance profile", "[.][benchmark][database]") {
+    QTemporaryDir dir;
+    REQUIRE(dir.isValid());
+
+    for (const PerformanceProfile& profile : { PerformanceProfile::legacy(), PerformanceProfile::durable(), PerformanceProfile::balanced() }) {
+        benchmarkProfile(profile, dir.filePath(profile.name + ".db"));
+    }
+}
@@ -0,0 +1,88 @@
+#include <catch2/catch_all.hpp>
+
+#include "Backend/Database/rollups.hpp"
+#include "Backend/Database/statements.hpp"
+#include "TestDatabase.hpp"
+
+using namespace TestDatabase;
+
+TEST_CASE("Stats rollups match the sums of the daily rows", "[database]") {
+    const QSqlDatabase db = app();
+    createUser(db, 1);
+
+    QSqlQuery query(db);
+    // A year and a bit of days with gaps, today included
+    for (int back = 0; back < 400; ++back) {
+        if (back % 3 == 1) continue;
+        const QString date = QString("DATE('now', '-%1 days')").arg(back);
+        REQUIRE(query.exec(QString("INSERT INTO UserStats (id, date, cards_seen, pressed_again, pressed_hard, "
+                                   "pressed_good, pressed_easy, time_spent_seconds, times_used) "
+                                   "VALUES (1, %1, %2, 1, 2, 3, 4, %3, 1)").arg(date).arg(back % 7).arg(back)));
+        REQUIRE(query.exec(QString("INSERT INTO DeckStats (id, user_id, date, cards_added, cards_seen, time_spent_seconds) "
+                                   "VALUES (1, 1, %1, %2, %3, %4)").arg(date).arg(back % 5).arg(back % 7).arg(back)));
+    }
+
+    // Rolled up through yesterday
+    REQUIRE(StatsRollups::rollOver(USER));
+    {
+        QSqlQuery state = run(db, SELECT_STATS_ROLLUP_STATE, { USER });
+        REQUIRE(state.next());
+        REQUIRE(state.value(0).toString() == state.value(1).toString());
+    }
+
+    // Nothing finished since, the sums below would be off if it added the days again
+    REQUIRE(StatsRollups::rollOver(USER));
+
+    const char* since[] = {
+        "date >= DATE('now', 'weekday 0', '-6 days')",
+        "date >= DATE('now', 'start of month')",
+        "1"
+    };
+    for (int period = 0; period < 3; ++period) {
+        QSqlQuery user = run(db, SELECT_USER_STATS_ROLLUP, { USER, period });
+        REQUIRE(user.next());
+        REQUIRE(query.exec(QString("SELECT COALESCE(SUM(cards_seen), 0), COALESCE(SUM(pressed_easy), 0), "
+                                   "COALESCE(SUM(time_spent_seconds), 0), COALESCE(SUM(times_used), 0) "
+                                   "FROM UserStats WHERE %1").arg(since[period])));
+        REQUIRE(query.next());
+        REQUIRE(user.value(0).toInt() == query.value(0).toInt());
+        REQUIRE(user.value(4).toInt() == query.value(1).toInt());
+        REQUIRE(user.value(5).toInt() == query.value(2).toInt());
+        REQUIRE(user.value(6).toInt() == query.value(3).toInt());
+
+        QSqlQuery deck = run(db, SELECT_DECK_STATS_ROLLUP, { USER, deckID(1), period });
+        QSqlQuery decks = run(db, SELECT_USER_DECK_STATS_ROLLUP, { USER, period });
+        REQUIRE(deck.next());
+        REQUIRE(decks.next());
+        REQUIRE(query.exec(QString("SELECT COALESCE(SUM(cards_added), 0), COALESCE(SUM(cards_seen), 0), "
+                                   "COALESCE(SUM(time_spent_seconds), 0) FROM DeckStats WHERE %1").arg(since[period])));
+        REQUIRE(query.next());
+        for (int column = 0; column < 3; ++column) {
+            REQUIRE(deck.value(column).toLongLong() == query.value(column).toLongLong());
+            REQUIRE(decks.value(column).toLongLong() == query.value(column).toLongLong());
+        }
+    }
+
+    // Today's row keeps changing without a roll-over
+    REQUIRE(query.exec("UPDATE UserStats SET cards_seen = cards_seen + 10 WHERE date = DATE('now')"));
+    QSqlQuery before = run(db, SELECT_USER_STATS_ROLLUP, { USER, 2 });
+    REQUIRE(before.next());
+    REQUIRE(query.exec("SELECT SUM(cards_seen) FROM UserStats"));
+    REQUIRE(query.next());
+    REQUIRE(before.value(0).toInt() == query.value(0).toInt());
+}
+
+TEST_CASE("A reset starts the rollups over", "[database]") {
+    for (const int cardsSeen : { 5, 7 }) {
+        // Dropped and migrated again by Database::reset() the second time
+        const QSqlDatabase db = app();
+        createUser(db);
+        run(db, "INSERT INTO UserStats (id, date, cards_seen) VALUES (1, DATE('now', '-1 days'), ?)", { cardsSeen });
+
+        // The rollup state of the old tables is gone, the new history is rolled up from its first day
+        REQUIRE(StatsRollups::rollOver(USER));
+        QSqlQuery total = run(db, SELECT_USER_STATS_ROLLUP, { USER, 2 });
+        REQUIRE(total.next());
+        REQUIRE(total.value(0).toInt() == cardsSeen);
+    }
+}
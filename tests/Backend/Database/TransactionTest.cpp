@@ -0,0 +1,60 @@
+#include <catch2/catch_all.hpp>
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+
+#include "Backend/Database/transaction.hpp"
+
+namespace {
+    int countRows(const QSqlDatabase& db) {
+        QSqlQuery query(db);
+        REQUIRE(query.exec("SELECT COUNT(*) FROM Items"));
+        REQUIRE(query.next());
+        return query.value(0).toInt();
+    }
+
+    void insertRow(const QSqlDatabase& db) {
+        QSqlQuery query(db);
+        REQUIRE(query.exec("INSERT INTO Items DEFAULT VALUES"));
+    }
+}
+
+TEST_CASE("Transactions commit, roll back and nest as savepoints", "[database]") {
+    {
+        QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", "transaction_test");
+        db.setDatabaseName(":memory:");
+        REQUIRE(db.open());
+        QSqlQuery(db).exec("CREATE TABLE Items (id INTEGER PRIMARY KEY)");
+
+        SECTION("Leaving the scope without commit rolls back") {
+            {
+                Transaction transaction(db);
+                REQUIRE(transaction.isActive());
+                insertRow(db);
+            }
+            REQUIRE(countRows(db) == 0);
+        }
+
+        SECTION("Commit keeps the writes") {
+            Transaction transaction(db);
+            insertRow(db);
+            REQUIRE(transaction.commit());
+            REQUIRE_FALSE(transaction.isActive());
+            REQUIRE(countRows(db) == 1);
+        }
+
+        SECTION("A failed inner scope only undoes its own writes") {
+            Transaction outer(db);
+            insertRow(db);
+            {
+                Transaction inner(db);
+                REQUIRE(inner.isActive());
+                insertRow(db);
+            }
+            REQUIRE(countRows(db) == 1);
+            REQUIRE(outer.commit());
+            REQUIRE(countRows(db) == 1);
+        }
+    }
+    QSqlDatabase::removeDatabase("transaction_test");
+}
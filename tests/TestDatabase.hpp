@@ -0,0 +1,115 @@
+#ifndef TESTDATABASE_HPP
+#define TESTDATABASE_HPP
+
+#include <catch2/catch_all.hpp>
+
+#include <optional>
+
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QVariant>
+
+#include "Backend/Database/migrations.hpp"
+#include "Backend/Database/setup.hpp"
+
+// Databases and rows shared by the tests, a statement that fails fails the test
+namespace TestDatabase {
+    inline const QString USER = QStringLiteral("u0000001");
+
+    // Public IDs of the numbered rows, d0000001, c0000001...
+    inline QString deckID(const qint64 deck) { return QString("d%1").arg(deck, 7, 10, QChar('0')); }
+    inline QString cardID(const qint64 card) { return QString("c%1").arg(card, 7, 10, QChar('0')); }
+
+    // The app's database on ":memory:", dropped and migrated again for every test
+    // so the classes under test run on it through Database::getInstance()
+    inline QSqlDatabase app() {
+        Database* database = Database::getInstance(":memory:");
+        if (database->getDB().isOpen()) database->reset();
+        else database->initialize();
+        return database->getDB();
+    }
+
+    // Migrated ":memory:" database on its own connection, removed when it goes out of scope
+    // Queries on it have to be declared after it
+    class Connection {
+    public:
+        explicit Connection(const QString& name) : name(name) {
+            db = QSqlDatabase::addDatabase("QSQLITE", name);
+            db.setDatabaseName(":memory:");
+            REQUIRE(db.open());
+            REQUIRE(Migrator(db).migrate());
+        }
+
+        ~Connection() {
+            db = QSqlDatabase();
+            QSqlDatabase::removeDatabase(name);
+        }
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        const QSqlDatabase& get() const { return db; }
+
+    private:
+        QString name;
+        QSqlDatabase db;
+    };
+
+    // Values bound in order
+    inline QSqlQuery run(const QSqlDatabase& db, const char* sql, const QVariantList& values = {}) {
+        QSqlQuery query(db);
+        REQUIRE(query.prepare(QString::fromUtf8(sql)));
+        for (int i = 0; i < values.size(); ++i) query.bindValue(i, values[i]);
+        REQUIRE(query.exec());
+        return query;
+    }
+
+    // User 1 (USER), selected, with decks 1 to decks
+    inline void createUser(const QSqlDatabase& db, const int decks = 0) {
+        run(db, "INSERT INTO Users (id, uid, username) VALUES (1, ?, 'Test')", { USER });
+        run(db, "INSERT INTO SavedUser (id) VALUES (1)");
+        for (int deck = 1; deck <= decks; ++deck) {
+            run(db, "INSERT INTO Decks (id, uid, name) VALUES (?, ?, 'Deck')", { deck, deckID(deck) });
+            run(db, "INSERT INTO UsersDecks (user_id, deck_id) VALUES (1, ?)", { deck });
+        }
+    }
+
+    // Cards of user 1, the statements are prepared once so the benchmarks can add many
+    class Cards {
+    public:
+        explicit Cards(const QSqlDatabase& db) : insertCard(db), insertLink(db), insertState(db) {
+            REQUIRE(insertCard.prepare("INSERT INTO Cards (id, uid, question, answer, type) VALUES (?, ?, 'Q', 'A', ?)"));
+            REQUIRE(insertLink.prepare("INSERT OR IGNORE INTO DecksCards (deck_id, card_id) VALUES (?, ?)"));
+            REQUIRE(insertState.prepare("INSERT INTO CardState (user_id, card_id, interval, due) VALUES (1, ?, 1, ?)"));
+        }
+
+        // Card id in the deck, due in seconds since epoch, no CardState row without one
+        void add(const qint64 id, const qint64 deck, const std::optional<qint64> due, const QString& type = "Review") {
+            insertCard.bindValue(0, id);
+            insertCard.bindValue(1, cardID(id));
+            insertCard.bindValue(2, type);
+            REQUIRE(insertCard.exec());
+
+            link(id, deck);
+
+            if (!due) return;
+            insertState.bindValue(0, id);
+            insertState.bindValue(1, *due);
+            REQUIRE(insertState.exec());
+        }
+
+        // Into one more deck
+        void link(const qint64 id, const qint64 deck) {
+            insertLink.bindValue(0, deck);
+            insertLink.bindValue(1, id);
+            REQUIRE(insertLink.exec());
+        }
+
+    private:
+        QSqlQuery insertCard;
+        QSqlQuery insertLink;
+        QSqlQuery insertState;
+    };
+}
+
+#endif